@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/char_class.dir/char_class.cpp.o"
+  "CMakeFiles/char_class.dir/char_class.cpp.o.d"
+  "char_class"
+  "char_class.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/char_class.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
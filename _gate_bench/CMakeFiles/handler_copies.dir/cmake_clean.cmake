@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/handler_copies.dir/handler_copies.cpp.o"
+  "CMakeFiles/handler_copies.dir/handler_copies.cpp.o.d"
+  "handler_copies"
+  "handler_copies.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/handler_copies.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
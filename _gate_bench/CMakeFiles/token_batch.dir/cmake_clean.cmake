@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/token_batch.dir/token_batch.cpp.o"
+  "CMakeFiles/token_batch.dir/token_batch.cpp.o.d"
+  "token_batch"
+  "token_batch.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/token_batch.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/algorithm.dir/algorithm.cpp.o"
+  "CMakeFiles/algorithm.dir/algorithm.cpp.o.d"
+  "algorithm"
+  "algorithm.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/algorithm.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/arena_headers.dir/arena_headers.cpp.o"
+  "CMakeFiles/arena_headers.dir/arena_headers.cpp.o.d"
+  "arena_headers"
+  "arena_headers.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/arena_headers.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
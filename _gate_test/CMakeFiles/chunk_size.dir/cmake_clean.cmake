@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/chunk_size.dir/chunk_size.cpp.o"
+  "CMakeFiles/chunk_size.dir/chunk_size.cpp.o.d"
+  "chunk_size"
+  "chunk_size.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/chunk_size.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
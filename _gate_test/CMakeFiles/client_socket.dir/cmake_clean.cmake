@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/client_socket.dir/client_socket.cpp.o"
+  "CMakeFiles/client_socket.dir/client_socket.cpp.o.d"
+  "client_socket"
+  "client_socket.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/client_socket.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/compressing_server_socket.dir/compressing_server_socket.cpp.o"
+  "CMakeFiles/compressing_server_socket.dir/compressing_server_socket.cpp.o.d"
+  "compressing_server_socket"
+  "compressing_server_socket.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/compressing_server_socket.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
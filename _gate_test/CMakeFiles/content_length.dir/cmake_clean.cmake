@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/content_length.dir/content_length.cpp.o"
+  "CMakeFiles/content_length.dir/content_length.cpp.o.d"
+  "content_length"
+  "content_length.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/content_length.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/datetime.dir/datetime.cpp.o"
+  "CMakeFiles/datetime.dir/datetime.cpp.o.d"
+  "datetime"
+  "datetime.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/datetime.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
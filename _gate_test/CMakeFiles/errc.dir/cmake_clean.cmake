@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/errc.dir/errc.cpp.o"
+  "CMakeFiles/errc.dir/errc.cpp.o.d"
+  "errc"
+  "errc.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/errc.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/file_metadata_cache.dir/file_metadata_cache.cpp.o"
+  "CMakeFiles/file_metadata_cache.dir/file_metadata_cache.cpp.o.d"
+  "file_metadata_cache"
+  "file_metadata_cache.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/file_metadata_cache.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
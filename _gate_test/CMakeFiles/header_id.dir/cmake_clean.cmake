@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/header_id.dir/header_id.cpp.o"
+  "CMakeFiles/header_id.dir/header_id.cpp.o.d"
+  "header_id"
+  "header_id.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/header_id.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mapped_file_cache.dir/mapped_file_cache.cpp.o"
+  "CMakeFiles/mapped_file_cache.dir/mapped_file_cache.cpp.o.d"
+  "mapped_file_cache"
+  "mapped_file_cache.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mapped_file_cache.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mocksocket.dir/mocksocket.cpp.o"
+  "CMakeFiles/mocksocket.dir/mocksocket.cpp.o.d"
+  "mocksocket"
+  "mocksocket.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mocksocket.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
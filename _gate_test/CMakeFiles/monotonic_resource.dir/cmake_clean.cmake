@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/monotonic_resource.dir/monotonic_resource.cpp.o"
+  "CMakeFiles/monotonic_resource.dir/monotonic_resource.cpp.o.d"
+  "monotonic_resource"
+  "monotonic_resource.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/monotonic_resource.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
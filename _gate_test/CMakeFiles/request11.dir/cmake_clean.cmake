@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/request11.dir/request11.cpp.o"
+  "CMakeFiles/request11.dir/request11.cpp.o.d"
+  "request11"
+  "request11.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/request11.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
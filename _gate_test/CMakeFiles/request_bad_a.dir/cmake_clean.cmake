@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/request_bad_a.dir/request_bad_a.cpp.o"
+  "CMakeFiles/request_bad_a.dir/request_bad_a.cpp.o.d"
+  "request_bad_a"
+  "request_bad_a.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/request_bad_a.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/request_bad_b.dir/request_bad_b.cpp.o"
+  "CMakeFiles/request_bad_b.dir/request_bad_b.cpp.o.d"
+  "request_bad_b"
+  "request_bad_b.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/request_bad_b.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/request_good.dir/request_good.cpp.o"
+  "CMakeFiles/request_good.dir/request_good.cpp.o.d"
+  "request_good"
+  "request_good.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/request_good.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/request_response_common.dir/request_response_common.cpp.o"
+  "CMakeFiles/request_response_common.dir/request_response_common.cpp.o.d"
+  "request_response_common"
+  "request_response_common.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/request_response_common.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
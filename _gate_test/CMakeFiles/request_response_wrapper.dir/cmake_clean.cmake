@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/request_response_wrapper.dir/request_response_wrapper.cpp.o"
+  "CMakeFiles/request_response_wrapper.dir/request_response_wrapper.cpp.o.d"
+  "request_response_wrapper"
+  "request_response_wrapper.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/request_response_wrapper.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/response.dir/response.cpp.o"
+  "CMakeFiles/response.dir/response.cpp.o.d"
+  "response"
+  "response.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/response.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
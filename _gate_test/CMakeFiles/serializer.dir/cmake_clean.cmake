@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/serializer.dir/serializer.cpp.o"
+  "CMakeFiles/serializer.dir/serializer.cpp.o.d"
+  "serializer"
+  "serializer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/serializer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/socket.dir/socket.cpp.o"
+  "CMakeFiles/socket.dir/socket.cpp.o.d"
+  "socket"
+  "socket.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/socket.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
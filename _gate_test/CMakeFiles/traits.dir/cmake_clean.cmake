@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/traits.dir/traits.cpp.o"
+  "CMakeFiles/traits.dir/traits.cpp.o.d"
+  "traits"
+  "traits.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/traits.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
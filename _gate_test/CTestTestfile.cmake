@@ -0,0 +1,64 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/test
+# Build directory: /root/repo/_gate_test
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(request_good "/root/repo/_gate_test/request_good")
+set_tests_properties(request_good PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(request_bad_a "/root/repo/_gate_test/request_bad_a")
+set_tests_properties(request_bad_a PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(request_bad_b "/root/repo/_gate_test/request_bad_b")
+set_tests_properties(request_bad_b PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(response "/root/repo/_gate_test/response")
+set_tests_properties(response PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(chunk_size "/root/repo/_gate_test/chunk_size")
+set_tests_properties(chunk_size PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(content_length "/root/repo/_gate_test/content_length")
+set_tests_properties(content_length PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(common "/root/repo/_gate_test/common")
+set_tests_properties(common PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(utils "/root/repo/_gate_test/utils")
+set_tests_properties(utils PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(request_response_common "/root/repo/_gate_test/request_response_common")
+set_tests_properties(request_response_common PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(scan "/root/repo/_gate_test/scan")
+set_tests_properties(scan PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(char_class "/root/repo/_gate_test/char_class")
+set_tests_properties(char_class PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(header_id "/root/repo/_gate_test/header_id")
+set_tests_properties(header_id PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;91;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(errc "/root/repo/_gate_test/errc")
+set_tests_properties(errc PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(algorithm "/root/repo/_gate_test/algorithm")
+set_tests_properties(algorithm PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(datetime "/root/repo/_gate_test/datetime")
+set_tests_properties(datetime PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(mocksocket "/root/repo/_gate_test/mocksocket")
+set_tests_properties(mocksocket PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(socket "/root/repo/_gate_test/socket")
+set_tests_properties(socket PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(traits "/root/repo/_gate_test/traits")
+set_tests_properties(traits PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(file_server "/root/repo/_gate_test/file_server")
+set_tests_properties(file_server PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(request11 "/root/repo/_gate_test/request11")
+set_tests_properties(request11 PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(routing "/root/repo/_gate_test/routing")
+set_tests_properties(routing PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(request_response_wrapper "/root/repo/_gate_test/request_response_wrapper")
+set_tests_properties(request_response_wrapper PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(client_socket "/root/repo/_gate_test/client_socket")
+set_tests_properties(client_socket PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(serializer "/root/repo/_gate_test/serializer")
+set_tests_properties(serializer PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(arena_headers "/root/repo/_gate_test/arena_headers")
+set_tests_properties(arena_headers PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(monotonic_resource "/root/repo/_gate_test/monotonic_resource")
+set_tests_properties(monotonic_resource PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(mapped_file_cache "/root/repo/_gate_test/mapped_file_cache")
+set_tests_properties(mapped_file_cache PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(file_metadata_cache "/root/repo/_gate_test/file_metadata_cache")
+set_tests_properties(file_metadata_cache PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;95;add_test_target;/root/repo/test/CMakeLists.txt;0;")
+add_test(compressing_server_socket "/root/repo/_gate_test/compressing_server_socket")
+set_tests_properties(compressing_server_socket PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/test/CMakeLists.txt;87;add_test;/root/repo/test/CMakeLists.txt;101;add_test_target;/root/repo/test/CMakeLists.txt;0;")
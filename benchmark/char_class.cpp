@@ -0,0 +1,109 @@
+/* Throughput of each character predicate: the branchy definitions the parser
+   used to have against the shared lookup table. */
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <boost/http/reader/detail/abnf.hpp>
+
+#include "common.hpp"
+
+namespace http = boost::http;
+namespace abnf = http::reader::detail;
+
+namespace branchy {
+
+bool isalnum(unsigned char c)
+{
+    return (c >= 0x41 && c <= 0x5A) || (c >= 0x61 && c <= 0x7A)
+        || (c >= 0x30 && c <= 0x39);
+}
+
+bool is_tchar(unsigned char c)
+{
+    switch (c) {
+    case '!': case '#': case '$': case '%': case '&': case '\'': case '*':
+    case '+': case '-': case '.': case '^': case '_': case '`': case '|':
+    case '~':
+        return true;
+    default:
+        return isalnum(c);
+    }
+}
+
+bool is_request_target_char(unsigned char c)
+{
+    switch (c) {
+    case '?': case '/': case '-': case '.': case '_': case '~': case '%':
+    case '!': case '$': case '&': case '\'': case '(': case ')': case '*':
+    case '+': case ',': case ';': case '=': case ':': case '@':
+        return true;
+    default:
+        return isalnum(c);
+    }
+}
+
+bool is_field_value_char(unsigned char c)
+{
+    return (c >= '\x21' && c <= '\x7E') || c >= 0x80 || c == ' ' || c == '\t';
+}
+
+bool is_chunk_ext_char(unsigned char c)
+{
+    switch (c) {
+    case ';': case '=': case '"': case '\t': case ' ': case '!': case '\\':
+        return true;
+    default:
+        return is_tchar(c) || (c >= 0x23 && c <= 0x5B)
+            || (c >= 0x5D && c <= 0x7E) || c >= 0x80
+            || (c >= '\x21' && c <= '\x7E');
+    }
+}
+
+} // namespace branchy
+
+/* Counts members over random bytes (worst case for the branch predictor) and
+   over header-like text. */
+template<class Predicate>
+void bench(const char *name, const std::vector<unsigned char> &input,
+           Predicate p)
+{
+    benchmark::run(name, input.size(), 2000, [&]() {
+        std::size_t n = 0;
+        for (std::size_t i = 0 ; i != input.size() ; ++i)
+            n += p(input[i]);
+        benchmark::do_not_optimize(n);
+    });
+}
+
+#define BENCH(input, label, predicate)                                        \
+    bench("branchy/" label, input, branchy::predicate);                       \
+    bench("table/" label, input, abnf::predicate)
+
+int main()
+{
+    std::vector<unsigned char> random(16 * 1024);
+    std::srand(42);
+    for (std::size_t i = 0 ; i != random.size() ; ++i)
+        random[i] = static_cast<unsigned char>(std::rand());
+
+    const std::string text_src = "Accept: text/html,application/xhtml+xml,"
+        "application/xml;q=0.9,*/*;q=0.8\r\nUser-Agent: Mozilla/5.0 (X11; "
+        "Linux x86_64) Gecko/20100101 Firefox/119.0\r\n";
+    std::vector<unsigned char> text;
+    while (text.size() < random.size())
+        text.insert(text.end(), text_src.begin(), text_src.end());
+
+    const char *labels[] = { "random", "text" };
+    const std::vector<unsigned char> *inputs[] = { &random, &text };
+    for (int i = 0 ; i != 2 ; ++i) {
+        const std::vector<unsigned char> &input = *inputs[i];
+        std::printf("-- %s input\n", labels[i]);
+        BENCH(input, "isalnum", isalnum);
+        BENCH(input, "is_tchar", is_tchar);
+        BENCH(input, "is_request_target_char", is_request_target_char);
+        BENCH(input, "is_field_value_char", is_field_value_char);
+        BENCH(input, "is_chunk_ext_char", is_chunk_ext_char);
+    }
+}
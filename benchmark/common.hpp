@@ -0,0 +1,74 @@
+#ifndef BENCHMARK_COMMON_HPP
+#define BENCHMARK_COMMON_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCHMARK_HAS_RDTSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define BENCHMARK_HAS_RDTSC 1
+#endif
+
+namespace benchmark {
+
+/* Elapsed time stamp counter ticks if available (close enough to core cycles
+   on any CPU with an invariant TSC), nanoseconds otherwise. */
+inline std::uint64_t now()
+{
+#ifdef BENCHMARK_HAS_RDTSC
+    return __rdtsc();
+#else
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+inline const char *unit()
+{
+#ifdef BENCHMARK_HAS_RDTSC
+    return "cycle";
+#else
+    return "ns";
+#endif
+}
+
+/* Keeps the optimizer from discarding results. */
+template<class T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile T sink;
+    sink = value;
+#endif
+}
+
+/* Runs `f` (which processes `bytes` bytes per call) `iterations` times a few
+   rounds and reports the best round. */
+template<class F>
+void run(const char *name, std::size_t bytes, std::size_t iterations, F f)
+{
+    std::uint64_t best = UINT64_MAX;
+    for (int round = 0 ; round != 5 ; ++round) {
+        std::uint64_t start = now();
+        for (std::size_t i = 0 ; i != iterations ; ++i)
+            f();
+        std::uint64_t elapsed = now() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+
+    double total = double(bytes) * iterations;
+    std::printf("%-40s %8.3f bytes/%s %10.1f %s/iter\n", name,
+                total / best, unit(), double(best) / iterations, unit());
+}
+
+} // namespace benchmark
+
+#endif // BENCHMARK_COMMON_HPP
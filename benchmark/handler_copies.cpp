@@ -0,0 +1,200 @@
+/* Serves keep-alive requests from an in-memory stream. Handlers holding a
+   `shared_ptr` (e.g. the ones `asio::spawn` creates for `yield_context`) pay
+   two atomic operations (increment + decrement) per copy, so the copies done
+   per request are counted. The cost of a request served from an
+   `asio::spawn` coroutine is reported as well. */
+
+#include <cstdlib>
+#include <memory>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/detail/bind_handler.hpp>
+
+#include <boost/http/socket.hpp>
+#include <boost/http/request.hpp>
+#include <boost/http/response.hpp>
+
+#include "common.hpp"
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+
+const char request_data[] =
+    "GET /api/v1/items/42 HTTP/1.1\r\n"
+    "Host: api.example.com\r\n"
+    "\r\n";
+
+// Endless stream of the same request (written data is discarded)
+class request_stream
+{
+public:
+    typedef request_stream lowest_layer_type;
+
+    explicit request_stream(asio::io_service &io_service)
+        : io_service(io_service)
+    {}
+
+    bool is_open() const
+    {
+        return true;
+    }
+
+    void close() {}
+
+    lowest_layer_type &lowest_layer()
+    {
+        return *this;
+    }
+
+    asio::io_service &get_io_service()
+    {
+        return io_service;
+    }
+
+    template<class MutableBufferSequence, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<
+            CompletionToken, void(boost::system::error_code, std::size_t)
+        >::type>::type
+    async_read_some(const MutableBufferSequence &buffers,
+                    CompletionToken &&token)
+    {
+        typedef typename asio::handler_type<
+            CompletionToken, void(boost::system::error_code, std::size_t)
+        >::type Handler;
+
+        Handler handler(std::forward<CompletionToken>(token));
+        asio::async_result<Handler> result(handler);
+
+        const std::size_t size = sizeof(request_data) - 1;
+        std::size_t n = asio::buffer_copy(buffers,
+                                          asio::buffer(request_data + offset,
+                                                       size - offset));
+        offset = (offset + n) % size;
+
+        io_service.post(asio::detail::bind_handler(std::move(handler),
+                                                   boost::system::error_code{},
+                                                   n));
+        return result.get();
+    }
+
+    template<class ConstBufferSequence, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<
+            CompletionToken, void(boost::system::error_code, std::size_t)
+        >::type>::type
+    async_write_some(const ConstBufferSequence &buffers,
+                     CompletionToken &&token)
+    {
+        typedef typename asio::handler_type<
+            CompletionToken, void(boost::system::error_code, std::size_t)
+        >::type Handler;
+
+        Handler handler(std::forward<CompletionToken>(token));
+        asio::async_result<Handler> result(handler);
+
+        io_service.post(asio::detail::bind_handler(std::move(handler),
+                                                   boost::system::error_code{},
+                                                   asio::buffer_size(buffers)));
+        return result.get();
+    }
+
+private:
+    asio::io_service &io_service;
+    std::size_t offset = 0;
+};
+
+// Holds a `shared_ptr` (as `yield_context` handlers do) and counts its copies
+struct counted_handler
+{
+    explicit counted_handler(std::shared_ptr<int> state)
+        : state(std::move(state))
+    {}
+
+    counted_handler(const counted_handler &o)
+        : state(o.state)
+    {
+        ++copies;
+    }
+
+    counted_handler(counted_handler&&) = default;
+
+    void operator()(boost::system::error_code ec)
+    {
+        if (ec)
+            std::abort();
+    }
+
+    std::shared_ptr<int> state;
+    static std::size_t copies;
+};
+
+std::size_t counted_handler::copies = 0;
+
+http::response make_reply()
+{
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    reply.body().push_back('!');
+    return reply;
+}
+
+void count_copies(std::size_t nrequests)
+{
+    asio::io_service ios;
+    char buffer[1024];
+    http::basic_socket<request_stream> socket(ios, asio::buffer(buffer));
+    http::request request;
+    http::response reply = make_reply();
+    auto state = std::make_shared<int>(0);
+
+    counted_handler::copies = 0;
+    for (std::size_t i = 0 ; i != nrequests ; ++i) {
+        socket.async_read_request(request, counted_handler(state));
+        ios.run();
+        ios.reset();
+        socket.async_write_response(reply, counted_handler(state));
+        ios.run();
+        ios.reset();
+    }
+
+    double copies = double(counted_handler::copies) / nrequests;
+    std::printf("%-40s %8.1f copies/request %6.1f atomic ops/request\n",
+                "handler copies", copies, copies * 2);
+}
+
+void spawned(std::size_t nrequests)
+{
+    std::uint64_t best = UINT64_MAX;
+    for (int round = 0 ; round != 5 ; ++round) {
+        asio::io_service ios;
+        char buffer[1024];
+        http::basic_socket<request_stream> socket(ios, asio::buffer(buffer));
+        http::response reply = make_reply();
+
+        asio::spawn(ios, [&](asio::yield_context yield) {
+            http::request request;
+            for (std::size_t i = 0 ; i != nrequests ; ++i) {
+                socket.async_read_request(request, yield);
+                socket.async_write_response(reply, yield);
+            }
+        });
+
+        std::uint64_t start = benchmark::now();
+        ios.run();
+        std::uint64_t elapsed = benchmark::now() - start;
+        if (elapsed < best)
+            best = elapsed;
+    }
+
+    std::printf("%-40s %8.1f %s/request\n", "asio::spawn keep-alive cycle",
+                double(best) / nrequests, benchmark::unit());
+}
+
+int main()
+{
+    count_copies(1000);
+    spawned(100000);
+}
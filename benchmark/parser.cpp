@@ -0,0 +1,123 @@
+/* Parses realistic request and response heads with each available scanning
+   tier of `reader::request`/`reader::response` and reports bytes per cycle. */
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <boost/http/reader/request.hpp>
+#include <boost/http/reader/response.hpp>
+
+#include "common.hpp"
+
+namespace http = boost::http;
+namespace detail = http::reader::detail;
+
+// Captured from desktop browsers {{{
+
+const char chrome_request[] =
+    "GET /wiki/Hypertext_Transfer_Protocol?action=render&oldid=1045 HTTP/1.1\r\n"
+    "Host: en.wikipedia.org\r\n"
+    "Connection: keep-alive\r\n"
+    "Cache-Control: max-age=0\r\n"
+    "sec-ch-ua: \"Chromium\";v=\"118\", \"Google Chrome\";v=\"118\", \"Not=A?Brand\";v=\"99\"\r\n"
+    "sec-ch-ua-mobile: ?0\r\n"
+    "sec-ch-ua-platform: \"Linux\"\r\n"
+    "Upgrade-Insecure-Requests: 1\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/118.0.0.0 Safari/537.36\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,image/apng,*/*;q=0.8,application/signed-exchange;v=b3;q=0.7\r\n"
+    "Sec-Fetch-Site: same-origin\r\n"
+    "Sec-Fetch-Mode: navigate\r\n"
+    "Sec-Fetch-User: ?1\r\n"
+    "Sec-Fetch-Dest: document\r\n"
+    "Referer: https://en.wikipedia.org/wiki/Main_Page\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: en-US,en;q=0.9,pt-BR;q=0.8,pt;q=0.7\r\n"
+    "Cookie: WMF-Last-Access=17-Oct-2016; GeoIP=BR:SP:Sao_Paulo:-23.55:-46.63:v4; enwikimwuser-sessionId=8f3e1c7d2a9b4e6f; centralnotice_hide_fundraising=%7B%22v%22%3A1%2C%22created%22%3A1476700000%7D\r\n"
+    "\r\n";
+
+const char firefox_request[] =
+    "GET /static/css/site.min.css?v=3f9a2c HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Ubuntu; Linux x86_64; rv:109.0) Gecko/20100101 Firefox/119.0\r\n"
+    "Accept: text/css,*/*;q=0.1\r\n"
+    "Accept-Language: en-US,en;q=0.5\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Connection: keep-alive\r\n"
+    "Referer: https://www.example.com/blog/2016/10/announcing-boost-http\r\n"
+    "Cookie: _ga=GA1.2.1234567890.1476700000; _gid=GA1.2.987654321.1476700000; session=eyJ1c2VyIjoiYWxpY2UiLCJyb2xlIjoiYWRtaW4ifQ\r\n"
+    "Sec-Fetch-Dest: style\r\n"
+    "Sec-Fetch-Mode: no-cors\r\n"
+    "Sec-Fetch-Site: same-origin\r\n"
+    "If-Modified-Since: Mon, 17 Oct 2016 10:00:00 GMT\r\n"
+    "If-None-Match: \"5804a2e0-1c3f\"\r\n"
+    "\r\n";
+
+const char server_response[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Date: Mon, 17 Oct 2016 10:00:00 GMT\r\n"
+    "Server: nginx/1.10.1\r\n"
+    "Content-Type: text/html; charset=UTF-8\r\n"
+    "Content-Length: 0\r\n"
+    "Connection: keep-alive\r\n"
+    "Vary: Accept-Encoding, Cookie\r\n"
+    "Cache-Control: private, s-maxage=0, max-age=0, must-revalidate\r\n"
+    "Last-Modified: Sun, 16 Oct 2016 22:41:07 GMT\r\n"
+    "Strict-Transport-Security: max-age=106384710; includeSubDomains; preload\r\n"
+    "Set-Cookie: WMF-Last-Access=17-Oct-2016;Path=/;HttpOnly;secure;Expires=Fri, 18 Nov 2016 00:00:00 GMT\r\n"
+    "X-Content-Type-Options: nosniff\r\n"
+    "\r\n";
+
+// }}}
+
+void on_token(http::reader::request &)
+{}
+
+void on_token(http::reader::response &parser)
+{
+    if (parser.code() == http::token::code::status_code)
+        parser.set_method("GET");
+}
+
+template<class Parser>
+void parse(const char *data, std::size_t size)
+{
+    Parser parser;
+    parser.set_buffer(boost::asio::buffer(data, size));
+    while (parser.code() != http::token::code::end_of_message) {
+        if (parser.code() != http::token::code::error_insufficient_data
+            && parser.code() < http::token::code::skip) {
+            std::abort();
+        }
+        on_token(parser);
+        parser.next();
+    }
+    benchmark::do_not_optimize(parser.parsed_count());
+}
+
+template<class Parser>
+void bench(const char *label, const char *data, std::size_t iterations)
+{
+    static const char *levels[] = { "scalar", "sse4.2", "avx2" };
+    const std::size_t size = std::strlen(data);
+    const int detected = detail::simd_level();
+
+    for (int level = detail::SIMD_NONE ; level <= detected ; ++level) {
+        detail::simd_level() = level;
+        std::string name = std::string(label) + " (" + levels[level] + ")";
+        benchmark::run(name.c_str(), size, iterations,
+                       [&]() { parse<Parser>(data, size); });
+    }
+    detail::simd_level() = detected;
+}
+
+int main()
+{
+    const std::size_t iterations = 100000;
+
+    bench<http::reader::request>("request/chrome", chrome_request, iterations);
+    bench<http::reader::request>("request/firefox", firefox_request,
+                                 iterations);
+    bench<http::reader::response>("response/server", server_response,
+                                  iterations);
+}
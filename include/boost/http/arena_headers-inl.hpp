@@ -0,0 +1,294 @@
+namespace boost {
+namespace http {
+
+inline arena_headers::arena_headers(monotonic_resource *resource)
+    : external(resource)
+{}
+
+inline arena_headers::arena_headers(const arena_headers &o)
+{
+    fields.reserve(o.fields.size());
+    for (const auto &field: o.fields)
+        emplace(field.first, field.second);
+    seal();
+}
+
+inline arena_headers::arena_headers(arena_headers &&o)
+    : arena(std::move(o.arena))
+    , external(o.external)
+    , nstored(o.nstored)
+    , fields(std::move(o.fields))
+    , index(std::move(o.index))
+    , indexed(o.indexed)
+{
+    o.fields.clear();
+    o.index.clear();
+    o.indexed = true;
+    o.nstored = 0;
+}
+
+inline arena_headers &arena_headers::operator=(arena_headers &&o)
+{
+    if (this == &o)
+        return *this;
+
+    clear();
+    arena_headers(std::move(o)).swap(*this);
+    return *this;
+}
+
+inline arena_headers::~arena_headers()
+{
+    clear();
+}
+
+inline arena_headers &arena_headers::operator=(const arena_headers &o)
+{
+    if (this == &o)
+        return *this;
+
+    clear();
+    fields.reserve(o.fields.size());
+    for (const auto &field: o.fields)
+        emplace(field.first, field.second);
+    seal();
+
+    return *this;
+}
+
+inline arena_headers::iterator arena_headers::begin()
+{
+    return iterator(sorted().begin());
+}
+
+inline arena_headers::const_iterator arena_headers::begin() const
+{
+    return const_iterator(sorted().begin());
+}
+
+inline arena_headers::const_iterator arena_headers::cbegin() const
+{
+    return begin();
+}
+
+inline arena_headers::iterator arena_headers::end()
+{
+    return iterator(sorted().end());
+}
+
+inline arena_headers::const_iterator arena_headers::end() const
+{
+    return const_iterator(sorted().end());
+}
+
+inline arena_headers::const_iterator arena_headers::cend() const
+{
+    return end();
+}
+
+inline bool arena_headers::empty() const
+{
+    return fields.empty();
+}
+
+inline arena_headers::size_type arena_headers::size() const
+{
+    return fields.size();
+}
+
+inline void arena_headers::emplace(key_type name, mapped_type value)
+{
+    // Room for a typical header section in a single allocation
+    if (fields.capacity() == 0)
+        fields.reserve(32);
+
+    fields.emplace_back(store(name), store(value));
+    indexed = false;
+}
+
+inline void arena_headers::insert(const value_type &field)
+{
+    emplace(field.first, field.second);
+}
+
+inline arena_headers::iterator arena_headers::erase(const_iterator position)
+{
+    const_iterator last = position;
+    return erase(position, ++last);
+}
+
+inline arena_headers::iterator arena_headers::erase(const_iterator first,
+                                                    const_iterator last)
+{
+    const auto position = first.base() - sorted().begin();
+
+    if (first != last) {
+        /* Erased names and values stay in the arena until `clear`. The
+           survivors are shifted in place (a field is only moved after its own
+           address was checked). */
+        auto erased = [first,last](const value_type &field) {
+            return std::find(first.base(), last.base(), &field) != last.base();
+        };
+        fields.erase(std::remove_if(fields.begin(), fields.end(), erased),
+                     fields.end());
+        indexed = false;
+    }
+
+    return iterator(sorted().begin() + position);
+}
+
+inline arena_headers::size_type arena_headers::erase(key_type name)
+{
+    auto range = equal_range(name);
+    size_type n = std::distance(range.first, range.second);
+    erase(range.first, range.second);
+    return n;
+}
+
+inline void arena_headers::clear()
+{
+    fields.clear();
+    index.clear();
+    indexed = true;
+
+    auto &memory = this->memory();
+    for (; nstored != 0 ; --nstored)
+        memory.deallocate(nullptr, 0, 1);
+    if (!external)
+        arena.release();
+}
+
+inline void arena_headers::seal()
+{
+    sorted();
+}
+
+inline void arena_headers::swap(arena_headers &o)
+{
+    std::swap(arena, o.arena);
+    std::swap(external, o.external);
+    fields.swap(o.fields);
+    index.swap(o.index);
+    std::swap(indexed, o.indexed);
+    std::swap(nstored, o.nstored);
+}
+
+inline arena_headers::size_type arena_headers::count(key_type name) const
+{
+    return upper(name) - lower(name);
+}
+
+inline arena_headers::iterator arena_headers::find(key_type name)
+{
+    auto it = lower(name);
+    if (it == index.end() || (*it)->first != name)
+        return end();
+    return iterator(it);
+}
+
+inline arena_headers::const_iterator arena_headers::find(key_type name) const
+{
+    auto it = lower(name);
+    if (it == index.end() || (*it)->first != name)
+        return end();
+    return const_iterator(it);
+}
+
+inline arena_headers::iterator arena_headers::lower_bound(key_type name)
+{
+    return iterator(lower(name));
+}
+
+inline arena_headers::const_iterator
+arena_headers::lower_bound(key_type name) const
+{
+    return const_iterator(lower(name));
+}
+
+inline arena_headers::iterator arena_headers::upper_bound(key_type name)
+{
+    return iterator(upper(name));
+}
+
+inline arena_headers::const_iterator
+arena_headers::upper_bound(key_type name) const
+{
+    return const_iterator(upper(name));
+}
+
+inline std::pair<arena_headers::iterator, arena_headers::iterator>
+arena_headers::equal_range(key_type name)
+{
+    return std::make_pair(lower_bound(name), upper_bound(name));
+}
+
+inline std::pair<arena_headers::const_iterator, arena_headers::const_iterator>
+arena_headers::equal_range(key_type name) const
+{
+    return std::make_pair(lower_bound(name), upper_bound(name));
+}
+
+inline arena_headers::key_compare arena_headers::key_comp() const
+{
+    return key_compare();
+}
+
+inline monotonic_resource &arena_headers::memory()
+{
+    return external ? *external : arena;
+}
+
+inline string_ref arena_headers::store(string_ref s)
+{
+    if (s.empty())
+        return string_ref();
+
+    char *data = static_cast<char*>(memory().allocate(s.size(), 1));
+    ++nstored;
+    std::memcpy(data, s.data(), s.size());
+    return string_ref(data, s.size());
+}
+
+inline const arena_headers::index_type &arena_headers::sorted() const
+{
+    if (indexed)
+        return index;
+
+    index.clear();
+    index.reserve(fields.capacity());
+    for (const auto &field: fields)
+        index.push_back(&field);
+
+    /* `fields` is in insertion order, so comparing addresses keeps equivalent
+       names in insertion order without `std::stable_sort`'s buffer. */
+    std::sort(index.begin(), index.end(),
+              [](const value_type *a, const value_type *b) {
+                  int c = a->first.compare(b->first);
+                  return c < 0 || (c == 0 && a < b);
+              });
+    indexed = true;
+    return index;
+}
+
+inline arena_headers::index_type::const_iterator
+arena_headers::lower(key_type name) const
+{
+    const auto &idx = sorted();
+    return std::lower_bound(idx.begin(), idx.end(), name,
+                            [](const value_type *field, key_type name) {
+                                return field->first < name;
+                            });
+}
+
+inline arena_headers::index_type::const_iterator
+arena_headers::upper(key_type name) const
+{
+    const auto &idx = sorted();
+    return std::upper_bound(idx.begin(), idx.end(), name,
+                            [](key_type name, const value_type *field) {
+                                return name < field->first;
+                            });
+}
+
+} // namespace http
+} // namespace boost
@@ -0,0 +1,184 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_ARENA_HEADERS_HPP
+#define BOOST_HTTP_ARENA_HEADERS_HPP
+
+#include <cstddef>
+#include <cstring>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <boost/utility/string_ref.hpp>
+#include <boost/iterator/indirect_iterator.hpp>
+
+#include <boost/http/monotonic_resource.hpp>
+
+namespace boost {
+namespace http {
+
+/* Multimap of header fields whose names and values live in an arena owned by
+   the container. Fields are appended to a vector of views (so insertion
+   doesn't shift anything) and the sorted index of pointers to them used for
+   lookup and iteration is only built once it's needed. `clear` recycles the
+   arena and the vectors, so a container reused across messages stops
+   allocating.
+
+   Const members build a stale index too, so concurrent reads are only safe
+   once the container is sealed (`seal`, `erase`, a copy or any non-const
+   lookup). The sockets seal the fields they parse.
+
+   The views only ever point into the arena, so the fields are only reachable
+   as const (assigning a view to a field would leave it pointing to the
+   caller's memory). Replace a field by erasing it and emplacing a new one.
+
+   The arena may also be a `monotonic_resource` shared with the rest of the
+   message, in which case `clear` gives the fields back to it (it's released
+   by whoever owns it). */
+class arena_headers
+{
+public:
+    typedef string_ref key_type;
+    typedef string_ref mapped_type;
+    // Not `const key_type`, so `erase` can shift the fields in place
+    typedef std::pair<key_type, mapped_type> value_type;
+    typedef std::less<key_type> key_compare;
+    typedef value_type &reference;
+    typedef const value_type &const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+private:
+    typedef std::vector<const value_type*> index_type;
+
+public:
+    typedef indirect_iterator<index_type::const_iterator, const value_type>
+        iterator;
+    typedef iterator const_iterator;
+
+    arena_headers() = default;
+    explicit arena_headers(monotonic_resource *resource);
+    arena_headers(const arena_headers &o);
+    arena_headers(arena_headers &&o);
+
+    arena_headers &operator=(const arena_headers &o);
+    arena_headers &operator=(arena_headers &&o);
+
+    ~arena_headers();
+
+    // ### ITERATORS ###
+
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const;
+
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const;
+
+    // ### CAPACITY ###
+
+    bool empty() const;
+    size_type size() const;
+
+    // ### MODIFIERS ###
+
+    // Copies `name` and `value` into the arena
+    void emplace(key_type name, mapped_type value);
+    void insert(const value_type &field);
+
+    iterator erase(const_iterator position);
+    iterator erase(const_iterator first, const_iterator last);
+    size_type erase(key_type name);
+
+    /* Drops every field (the memory is kept for the next fields or given back
+       to the shared resource) */
+    void clear();
+
+    // Builds the index now, so const members don't touch the container
+    void seal();
+
+    void swap(arena_headers &o);
+
+    // ### LOOKUP ###
+
+    size_type count(key_type name) const;
+
+    iterator find(key_type name);
+    const_iterator find(key_type name) const;
+
+    iterator lower_bound(key_type name);
+    const_iterator lower_bound(key_type name) const;
+
+    iterator upper_bound(key_type name);
+    const_iterator upper_bound(key_type name) const;
+
+    std::pair<iterator, iterator> equal_range(key_type name);
+    std::pair<const_iterator, const_iterator> equal_range(key_type name) const;
+
+    // ### OBSERVERS ###
+
+    key_compare key_comp() const;
+
+private:
+    monotonic_resource &memory();
+    string_ref store(string_ref s);
+    const index_type &sorted() const;
+    index_type::const_iterator lower(key_type name) const;
+    index_type::const_iterator upper(key_type name) const;
+
+    monotonic_resource arena;
+    // Used instead of `arena` if not null
+    monotonic_resource *external = nullptr;
+    // Allocations taken from the arena (erased fields included)
+    std::size_t nstored = 0;
+    // Insertion order
+    std::vector<value_type> fields;
+    /* `fields` sorted by name (equivalent names keep their insertion order).
+       Rebuilt by the first lookup or iteration after `fields` changes. */
+    mutable index_type index;
+    mutable bool indexed = true;
+};
+
+inline void swap(arena_headers &a, arena_headers &b)
+{
+    a.swap(b);
+}
+
+inline bool operator==(const arena_headers &a, const arena_headers &b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+inline bool operator!=(const arena_headers &a, const arena_headers &b)
+{
+    return !(a == b);
+}
+
+namespace detail {
+
+// Seals the fields parsed into `headers` (if its type can be sealed)
+template<class Headers>
+auto seal_headers(Headers &headers, int) -> decltype(headers.seal(), void())
+{
+    headers.seal();
+}
+
+template<class Headers>
+void seal_headers(Headers&, long)
+{}
+
+} // namespace detail
+
+} // namespace http
+} // namespace boost
+
+#include "arena_headers-inl.hpp"
+
+#endif // BOOST_HTTP_ARENA_HEADERS_HPP
@@ -0,0 +1,222 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_BODY_SINK_HPP
+#define BOOST_HTTP_BODY_SINK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/system/error_code.hpp>
+
+namespace boost {
+namespace http {
+
+/* A body type the socket hands the body chunks to instead of appending them to
+   a container. It has the members:
+
+     void write(asio::const_buffer chunk, system::error_code &ec);
+     void clear();
+
+   A failed `write` fails the read operation with `ec`. */
+template<class T, class = void>
+struct is_body_sink: public std::false_type {};
+
+template<class T>
+struct is_body_sink<T, decltype(std::declval<T&>()
+                                .write(std::declval<asio::const_buffer>(),
+                                       std::declval<system::error_code&>()),
+                                void())>
+    : public std::true_type
+{};
+
+// Hands every chunk to a function (an empty function discards the chunks)
+class callback_body_sink
+{
+public:
+    typedef std::function<void(asio::const_buffer, system::error_code&)>
+    function_type;
+
+    callback_body_sink() = default;
+
+    explicit callback_body_sink(function_type function)
+        : function(std::move(function))
+    {}
+
+    void write(asio::const_buffer chunk, system::error_code &ec)
+    {
+        if (function)
+            function(chunk, ec);
+    }
+
+    void clear() {}
+
+private:
+    function_type function;
+};
+
+/* Fixed-capacity ring the application drains between reads. A chunk that
+   doesn't fit fails the read with `asio::error::no_buffer_space`. A ring at
+   least as big as the socket's buffer never fills up if it's drained after
+   every read. */
+class ring_body_sink
+{
+public:
+    explicit ring_body_sink(std::size_t capacity = 0)
+        : storage(capacity)
+    {}
+
+    void write(asio::const_buffer chunk, system::error_code &ec)
+    {
+        auto data = asio::buffer_cast<const std::uint8_t*>(chunk);
+        auto n = asio::buffer_size(chunk);
+
+        if (n > capacity() - size_) {
+            ec = asio::error::no_buffer_space;
+            return;
+        }
+
+        std::size_t end = (begin + size_) % std::max<std::size_t>(capacity(),
+                                                                  1);
+        std::size_t first = std::min(n, capacity() - end);
+        std::copy_n(data, first, storage.data() + end);
+        std::copy_n(data + first, n - first, storage.data());
+        size_ += n;
+    }
+
+    // Moves up to `asio::buffer_size(buffer)` bytes out of the ring
+    std::size_t read(asio::mutable_buffer buffer)
+    {
+        auto out = asio::buffer_cast<std::uint8_t*>(buffer);
+        std::size_t n = std::min(asio::buffer_size(buffer), size_);
+        std::size_t first = std::min(n, capacity() - begin);
+        std::copy_n(storage.data() + begin, first, out);
+        std::copy_n(storage.data(), n - first, out + first);
+
+        size_ -= n;
+        begin = size_ ? (begin + n) % capacity() : 0;
+        return n;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    std::size_t capacity() const
+    {
+        return storage.size();
+    }
+
+    void clear()
+    {
+        begin = 0;
+        size_ = 0;
+    }
+
+private:
+    std::vector<std::uint8_t> storage;
+    std::size_t begin = 0;
+    std::size_t size_ = 0;
+};
+
+/* Writes the chunks to a file opened by the application (not owned). Write
+   errors are reported as `system::errc::io_error`. */
+class file_body_sink
+{
+public:
+    file_body_sink() = default;
+
+    explicit file_body_sink(std::FILE *file)
+        : file(file)
+    {}
+
+    void write(asio::const_buffer chunk, system::error_code &ec)
+    {
+        auto n = asio::buffer_size(chunk);
+
+        if (!file) {
+            ec = system::errc::make_error_code(system::errc
+                                               ::bad_file_descriptor);
+            return;
+        }
+
+        if (std::fwrite(asio::buffer_cast<const void*>(chunk), 1, n, file)
+            != n) {
+            ec = system::errc::make_error_code(system::errc::io_error);
+            return;
+        }
+
+        written += n;
+    }
+
+    // Bytes written since the last `clear`
+    std::uintmax_t size() const
+    {
+        return written;
+    }
+
+    // Only resets `size` (the file is left alone)
+    void clear()
+    {
+        written = 0;
+    }
+
+private:
+    std::FILE *file = nullptr;
+    std::uintmax_t written = 0;
+};
+
+namespace detail {
+
+template<class Body>
+typename std::enable_if<is_body_sink<Body>::value>::type
+append_body(Body &body, asio::const_buffer chunk, system::error_code &ec)
+{
+    body.write(chunk, ec);
+}
+
+// Containers (e.g. `std::vector<std::uint8_t>`) just grow
+template<class Body>
+typename std::enable_if<!is_body_sink<Body>::value>::type
+append_body(Body &body, asio::const_buffer chunk, system::error_code&)
+{
+    auto begin = asio::buffer_cast<const std::uint8_t*>(chunk);
+    auto size = asio::buffer_size(chunk);
+    body.insert(body.end(), begin, begin + size);
+}
+
+template<class Body>
+auto reserve_body(Body &body, std::size_t size, int)
+    -> decltype(body.reserve(size), void())
+{
+    body.reserve(size);
+}
+
+// Sinks and containers without `reserve`
+template<class Body>
+void reserve_body(Body&, std::size_t, long)
+{}
+
+} // namespace detail
+
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_BODY_SINK_HPP
@@ -0,0 +1,156 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_BUFFER_POOL_HPP
+#define BOOST_HTTP_BUFFER_POOL_HPP
+
+#include <cstddef>
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+#include <boost/asio/buffer.hpp>
+
+namespace boost {
+namespace http {
+
+/* Size-classed cache of memory blocks shared by every socket that grows its
+   input buffer. Block sizes are powers of two, starting at `min_block_size`,
+   so a buffer growing geometrically only ever touches a handful of classes.
+   Released blocks are kept (up to `max_cached_blocks` per class) to be handed
+   to the next socket needing one. */
+class buffer_pool
+{
+public:
+    static const std::size_t min_block_size = 256;
+
+    explicit buffer_pool(std::size_t max_cached_blocks = 64);
+
+    buffer_pool(const buffer_pool&) = delete;
+    buffer_pool &operator=(const buffer_pool&) = delete;
+
+    ~buffer_pool();
+
+    /* Returns a buffer of exactly `size` bytes carved from a block of the
+       smallest class fitting it. `size` MUST NOT be greater than the largest
+       power of two representable by `std::size_t`. */
+    asio::mutable_buffer acquire(std::size_t size);
+
+    // `buffer` MUST have been returned by `acquire` on this pool
+    void release(asio::mutable_buffer buffer);
+
+    // Size of the blocks used to serve `acquire(size)`
+    static std::size_t block_size(std::size_t size);
+
+    // Number of idle blocks kept by the pool
+    std::size_t cached_blocks() const;
+
+    // Frees every idle block
+    void shrink();
+
+    // Pool shared by every socket that doesn't set its own
+    static buffer_pool &global();
+
+private:
+    static const std::size_t nclasses = sizeof(std::size_t) * 8;
+
+    static std::size_t size_class(std::size_t size);
+
+    const std::size_t max_cached_blocks;
+
+    mutable std::mutex mutex;
+    std::array<std::vector<char*>, nclasses> free_blocks;
+};
+
+inline buffer_pool::buffer_pool(std::size_t max_cached_blocks)
+    : max_cached_blocks(max_cached_blocks)
+{}
+
+inline buffer_pool::~buffer_pool()
+{
+    shrink();
+}
+
+inline asio::mutable_buffer buffer_pool::acquire(std::size_t size)
+{
+    const auto c = size_class(size);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &blocks = free_blocks[c];
+        if (blocks.size()) {
+            auto block = blocks.back();
+            blocks.pop_back();
+            return asio::buffer(block, size);
+        }
+    }
+
+    return asio::buffer(new char[block_size(size)], size);
+}
+
+inline void buffer_pool::release(asio::mutable_buffer buffer)
+{
+    auto block = asio::buffer_cast<char*>(buffer);
+    if (!block)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto &blocks = free_blocks[size_class(asio::buffer_size(buffer))];
+        if (blocks.size() < max_cached_blocks) {
+            blocks.push_back(block);
+            return;
+        }
+    }
+
+    delete[] block;
+}
+
+inline std::size_t buffer_pool::cached_blocks() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t n = 0;
+    for (const auto &blocks: free_blocks)
+        n += blocks.size();
+    return n;
+}
+
+inline void buffer_pool::shrink()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &blocks: free_blocks) {
+        for (auto block: blocks)
+            delete[] block;
+        blocks.clear();
+    }
+}
+
+inline std::size_t buffer_pool::block_size(std::size_t size)
+{
+    return std::size_t(1) << size_class(size);
+}
+
+inline buffer_pool &buffer_pool::global()
+{
+    // Function-local so sockets with static storage duration can use it
+    static buffer_pool pool;
+    return pool;
+}
+
+inline std::size_t buffer_pool::size_class(std::size_t size)
+{
+    std::size_t c = 0;
+    while ((std::size_t(1) << c) < min_block_size)
+        ++c;
+    while ((std::size_t(1) << c) < size)
+        ++c;
+    return c;
+}
+
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_BUFFER_POOL_HPP
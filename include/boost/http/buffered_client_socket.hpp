@@ -0,0 +1,64 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_BUFFERED_CLIENT_SOCKET_HPP
+#define BOOST_HTTP_BUFFERED_CLIENT_SOCKET_HPP
+
+#include <boost/http/client_socket.hpp>
+#include <boost/http/buffered_socket.hpp>
+
+namespace boost {
+namespace http {
+
+template<class Socket, std::size_t N = BOOST_HTTP_SOCKET_DEFAULT_BUFFER_SIZE>
+class basic_buffered_client_socket
+    : private detail::buffered_socket_wrapping_buffer<N>
+    , private ::boost::http::basic_client_socket<Socket>
+{
+    typedef ::boost::http::basic_client_socket<Socket> Parent;
+
+public:
+    static_assert(N > 0, "N must be greater than 0");
+
+    typedef Socket next_layer_type;
+
+    using Parent::is_open;
+    using Parent::read_state;
+    using Parent::write_state;
+    using Parent::pending_requests;
+    using Parent::get_io_service;
+    using Parent::async_read_response;
+    using Parent::async_read_some;
+    using Parent::async_read_trailers;
+    using Parent::async_write_request;
+    using Parent::async_write_request_metadata;
+    using Parent::async_write;
+    using Parent::async_write_trailers;
+    using Parent::async_write_end_of_message;
+
+    basic_buffered_client_socket(boost::asio::io_service &io_service)
+        : Parent(io_service, boost::asio::buffer(BufferParent::buffer))
+    {}
+
+    template<class... Args>
+    basic_buffered_client_socket(Args&&... args)
+        : Parent(boost::asio::buffer(BufferParent::buffer),
+                 std::forward<Args>(args)...)
+    {}
+
+    using Parent::next_layer;
+    using Parent::open;
+
+private:
+    typedef detail::buffered_socket_wrapping_buffer<N> BufferParent;
+};
+
+typedef basic_buffered_client_socket<boost::asio::ip::tcp::socket>
+buffered_client_socket;
+
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_BUFFERED_CLIENT_SOCKET_HPP
@@ -42,12 +42,34 @@ public:
     using Parent::async_read_request;
     using Parent::async_read_some;
     using Parent::async_read_trailers;
+    using Parent::async_read_body_into;
+#ifdef BOOST_HTTP_DETAIL_HAS_SPLICE
+    using Parent::async_splice_body;
+#endif // BOOST_HTTP_DETAIL_HAS_SPLICE
     using Parent::async_write_response;
     using Parent::async_write_response_continue;
     using Parent::async_write_response_metadata;
     using Parent::async_write;
     using Parent::async_write_trailers;
     using Parent::async_write_end_of_message;
+    using Parent::async_flush;
+    using Parent::async_write_response_buffers;
+#ifdef BOOST_HTTP_DETAIL_HAS_SENDFILE
+    using Parent::async_write_response_file;
+#endif // BOOST_HTTP_DETAIL_HAS_SENDFILE
+    using Parent::set_pipeline_depth;
+    using Parent::pipeline_depth;
+    using Parent::pending_responses;
+    using Parent::last_request_id;
+    using Parent::set_max_buffer_size;
+    using Parent::max_buffer_size;
+    using Parent::buffer_size;
+    using Parent::set_buffer_pool;
+    using Parent::body_length_known;
+    using Parent::body_length;
+    using Parent::set_body_reserve_limit;
+    using Parent::body_reserve_limit;
+    using Parent::set_header_filter;
 
     basic_buffered_socket(boost::asio::io_service &io_service)
         : Parent(io_service, boost::asio::buffer(BufferParent::buffer))
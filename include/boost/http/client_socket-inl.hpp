@@ -0,0 +1,802 @@
+namespace boost {
+namespace http {
+
+template<class Socket>
+bool basic_client_socket<Socket>::is_open() const
+{
+    return channel.is_open() && is_open_;
+}
+
+template<class Socket>
+read_state basic_client_socket<Socket>::read_state() const
+{
+    return istate;
+}
+
+template<class Socket>
+write_state basic_client_socket<Socket>::write_state() const
+{
+    return writer_helper.state;
+}
+
+template<class Socket>
+std::size_t basic_client_socket<Socket>::pending_requests() const
+{
+    return pending.size();
+}
+
+template<class Socket>
+asio::io_service &basic_client_socket<Socket>::get_io_service()
+{
+    return channel.get_io_service();
+}
+
+template<class Socket>
+template<class Response, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_client_socket<Socket>::async_read_response(Response &response,
+                                                 CompletionToken &&token)
+{
+    static_assert(is_response_message<Response>::value,
+                  "Response must fulfill the Response concept");
+
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    // A response can only be read after its request was (at least partly)
+    // written
+    if (istate != http::read_state::empty || pending.empty()) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
+    }
+
+    response.status_code() = 0;
+    response.reason_phrase().clear();
+    clear_message(response);
+    schedule_on_async_read_message<READY>(handler, response,
+                                          &response.status_code(),
+                                          &response.reason_phrase());
+
+    return result.get();
+}
+
+template<class Socket>
+template<class Message, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_client_socket<Socket>::async_read_some(Message &message,
+                                             CompletionToken &&token)
+{
+    static_assert(is_message<Message>::value,
+                  "Message must fulfill the Message concept");
+
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    if (istate != http::read_state::message_ready) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
+    }
+
+    schedule_on_async_read_message<DATA>(handler, message);
+
+    return result.get();
+}
+
+template<class Socket>
+template<class Message, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_client_socket<Socket>::async_read_trailers(Message &message,
+                                                 CompletionToken &&token)
+{
+    static_assert(is_message<Message>::value,
+                  "Message must fulfill the Message concept");
+
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    if (istate != http::read_state::body_ready) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
+    }
+
+    schedule_on_async_read_message<END>(handler, message);
+
+    return result.get();
+}
+
+template<class Socket>
+template<class Request, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_client_socket<Socket>::async_write_request(const Request &request,
+                                                 CompletionToken &&token)
+{
+    static_assert(is_request_message<Request>::value,
+                  "Request must fulfill the Request concept");
+
+    using detail::string_literal_buffer;
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    if (!writer_helper.write_message()) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
+    }
+
+    const auto &method = request.method();
+    const auto &target = request.target();
+    const auto &headers = request.headers();
+
+    const auto &body = request.body();
+
+    /* A user agent SHOULD NOT send a Content-Length header field when the
+       request message does not contain a payload body and the method
+       semantics do not anticipate such a body.
+
+       from section 3.3.2 of RFC7230. */
+    bool implicit_content_length
+        = (headers.find("content-length") != headers.end())
+        || (body.size() == 0 && method != "POST" && method != "PUT");
+
+    // because we don't create multiple requests at once, it's safe to use this
+    // "shared state"
+    staging_buffer.clear();
+    detail::append_request_line(staging_buffer, method, target);
+    detail::append_headers(staging_buffer, headers);
+
+    if (!implicit_content_length) {
+        detail::append_literal(staging_buffer, "content-length: ");
+        detail::append_decimal(staging_buffer, body.size());
+        detail::append_literal(staging_buffer, "\r\n");
+    }
+
+    detail::append_literal(staging_buffer, "\r\n");
+
+    // Small bodies are cheaper to copy than to pass as another iovec
+    std::array<asio::const_buffer, 2> buffers;
+    if (body.size() <= BOOST_HTTP_SOCKET_INLINE_BODY_SIZE) {
+        detail::append_body(staging_buffer, body);
+        buffers = {{ asio::buffer(staging_buffer), asio::const_buffer() }};
+    } else {
+        buffers = {{ asio::buffer(staging_buffer), asio::buffer(body) }};
+    }
+
+    push_pending_request(request);
+
+    asio::async_write(channel, buffers,
+                      continuation(std::move(handler),
+                                   [this](Handler &handler,
+                                          const system::error_code &ec,
+                                          std::size_t) {
+        on_request_written();
+        handler(ec);
+    }));
+
+    return result.get();
+}
+
+template<class Socket>
+template<class Request, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_client_socket<Socket>
+::async_write_request_metadata(const Request &request, CompletionToken &&token)
+{
+    static_assert(is_request_message<Request>::value,
+                  "Request must fulfill the Request concept");
+
+    using detail::string_literal_buffer;
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    if (!writer_helper.write_metadata()) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
+    }
+
+    const auto &method = request.method();
+    const auto &target = request.target();
+    const auto &headers = request.headers();
+
+    staging_buffer.clear();
+    detail::append_request_line(staging_buffer, method, target);
+    detail::append_headers(staging_buffer, headers);
+    detail::append_literal(staging_buffer, "transfer-encoding: chunked\r\n"
+                           "\r\n");
+
+    auto buffers = asio::buffer(staging_buffer);
+
+    push_pending_request(request);
+
+    asio::async_write(channel, buffers,
+                      continuation(std::move(handler),
+                                   [this](Handler &handler,
+                                          const system::error_code &ec,
+                                          std::size_t) {
+        // The rest of the request can't follow a failed write
+        if (ec)
+            on_request_written();
+        handler(ec);
+    }));
+
+    return result.get();
+}
+
+template<class Socket>
+template<class Message, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_client_socket<Socket>::async_write(const Message &message,
+                                         CompletionToken &&token)
+{
+    static_assert(is_message<Message>::value,
+                  "Message must fulfill the Message concept");
+
+    using detail::string_literal_buffer;
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    if (!writer_helper.write()) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
+    }
+
+    if (message.body().size() == 0) {
+        invoke_handler(std::forward<decltype(handler)>(handler));
+        return result.get();
+    }
+
+    auto crlf = string_literal_buffer("\r\n");
+
+    staging_buffer.clear();
+    detail::append_hex(staging_buffer, message.body().size());
+
+    std::array<boost::asio::const_buffer, 4> buffers = {
+        asio::buffer(staging_buffer),
+        crlf,
+        asio::buffer(message.body()),
+        crlf
+    };
+
+    asio::async_write(channel, buffers,
+                      continuation(std::move(handler),
+                                   [this](Handler &handler,
+                                          const system::error_code &ec,
+                                          std::size_t) {
+        // The rest of the request can't follow a failed write
+        if (ec)
+            on_request_written();
+        handler(ec);
+    }));
+
+    return result.get();
+}
+
+template<class Socket>
+template<class Message, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_client_socket<Socket>::async_write_trailers(const Message &message,
+                                                  CompletionToken &&token)
+{
+    static_assert(is_message<Message>::value,
+                  "Message must fulfill the Message concept");
+
+    using detail::string_literal_buffer;
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    if (!writer_helper.write_trailers()) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
+    }
+
+    staging_buffer.clear();
+    detail::append_literal(staging_buffer, "0\r\n");
+    detail::append_headers(staging_buffer, message.trailers());
+    detail::append_literal(staging_buffer, "\r\n");
+
+    auto buffers = asio::buffer(staging_buffer);
+
+    asio::async_write(channel, buffers,
+                      continuation(std::move(handler),
+                                   [this](Handler &handler,
+                                          const system::error_code &ec,
+                                          std::size_t) {
+        on_request_written();
+        handler(ec);
+    }));
+
+    return result.get();
+}
+
+template<class Socket>
+template<class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_client_socket<Socket>
+::async_write_end_of_message(CompletionToken &&token)
+{
+    using detail::string_literal_buffer;
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    if (!writer_helper.end()) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
+    }
+
+    auto last_chunk = string_literal_buffer("0\r\n\r\n");
+
+    asio::async_write(channel, last_chunk,
+                      continuation(std::move(handler),
+                                   [this](Handler &handler,
+                                          const system::error_code &ec,
+                                          std::size_t) {
+        on_request_written();
+        handler(ec);
+    }));
+
+    return result.get();
+}
+
+template<class Socket>
+basic_client_socket<Socket>
+::basic_client_socket(boost::asio::io_service &io_service,
+                      boost::asio::mutable_buffer inbuffer) :
+    channel(io_service),
+    istate(http::read_state::empty),
+    buffer(inbuffer),
+    writer_helper(http::write_state::empty)
+{
+    if (asio::buffer_size(buffer) == 0)
+        throw std::invalid_argument("buffers must not be 0-sized");
+}
+
+template<class Socket>
+template<class... Args>
+basic_client_socket<Socket>
+::basic_client_socket(boost::asio::mutable_buffer inbuffer, Args&&... args)
+    : channel(std::forward<Args>(args)...)
+    , istate(http::read_state::empty)
+    , buffer(inbuffer)
+    , writer_helper(http::write_state::empty)
+{
+    if (asio::buffer_size(buffer) == 0)
+        throw std::invalid_argument("buffers must not be 0-sized");
+}
+
+template<class Socket>
+Socket &basic_client_socket<Socket>::next_layer()
+{
+    return channel;
+}
+
+template<class Socket>
+const Socket &basic_client_socket<Socket>::next_layer() const
+{
+    return channel;
+}
+
+template<class Socket>
+void basic_client_socket<Socket>::open()
+{
+    clear_buffer();
+    writer_helper = http::write_state::empty;
+    pending.clear();
+    is_open_ = true;
+}
+
+template<class Socket>
+template<int target, class Message, class Handler, class String>
+void basic_client_socket<Socket>
+::schedule_on_async_read_message(Handler &handler, Message &message,
+                                 std::uint_least16_t *status_code,
+                                 String *reason_phrase)
+{
+    if (used_size) {
+        // Have cached some bytes from a previous read
+        on_async_read_message<target>(std::move(handler), status_code,
+                                      reason_phrase, message,
+                                      system::error_code{}, 0);
+    } else {
+        channel.async_read_some(asio::buffer(buffer + used_size), continuation(
+                                std::move(handler),
+                                [this,status_code,reason_phrase,&message]
+                                (Handler &handler, const system::error_code &ec,
+                                 std::size_t bytes_transferred) {
+            on_async_read_message<target>(std::move(handler), status_code,
+                                          reason_phrase, message, ec,
+                                          bytes_transferred);
+        }));
+    }
+}
+
+template<class Socket>
+template<int target, class Message, class Handler, class String>
+void basic_client_socket<Socket>
+::on_async_read_message(Handler handler, std::uint_least16_t *status_code,
+                        String *reason_phrase, Message &message,
+                        const system::error_code &ec,
+                        std::size_t bytes_transferred)
+{
+    if (ec == asio::error::eof && !eof && (used_size || expecting_field
+                                          || istate
+                                          != http::read_state::empty)) {
+        /* The end of a connection-delimited body (or a truncated message,
+           which the parser will report). */
+        eof = true;
+        parser.puteof();
+    } else if (ec) {
+        clear_buffer();
+        is_open_ = false;
+        handler(ec);
+        return;
+    }
+
+    used_size += bytes_transferred;
+    if (expecting_field) {
+        /* We complicate field management to avoid allocations. The field name
+           MUST occupy the initial bytes on the buffer. The bytes that
+           immediately follow should be the field value (i.e. remove any `skip`
+           that appears between name and value). */
+        parser.set_buffer(asio::buffer(buffer + field_name_size,
+                                       used_size - field_name_size));
+    } else {
+        parser.set_buffer(asio::buffer(buffer, used_size));
+    }
+
+    std::size_t nparsed = expecting_field ? field_name_size : 0;
+    std::size_t field_name_begin = 0;
+    bool use_trailers;
+    int flags = 0;
+
+    /* Buffer management is simplified by making `error_insufficient_data` the
+       only way to break out of this loop (on non-error paths). */
+    do {
+        parser.next();
+        switch (parser.code()) {
+        case token::code::error_insufficient_data:
+            // break of for loop completely
+            continue;
+        case token::code::error_set_method:
+            BOOST_HTTP_DETAIL_UNREACHABLE("set_method is always called at"
+                                          " status_code");
+            break;
+        case token::code::error_use_another_connection:
+            is_open_ = false;
+
+            // Connection-delimited bodies and tunnels end the connection
+            if (flags & END) {
+                used_size = 0;
+                expecting_field = false;
+                handler(system::error_code{});
+                return;
+            }
+
+            clear_buffer();
+            handler(system::error_code{asio::error::eof});
+            return;
+        case token::code::error_invalid_data:
+        case token::code::error_no_host:
+        case token::code::error_invalid_content_length:
+        case token::code::error_content_length_overflow:
+        case token::code::error_invalid_transfer_encoding:
+        case token::code::error_chunk_size_overflow:
+            clear_buffer();
+            is_open_ = false;
+            channel.lowest_layer().close();
+            handler(system::error_code{http_errc::parsing_error});
+            return;
+        case token::code::skip:
+            break;
+        case token::code::method:
+            BOOST_HTTP_DETAIL_UNREACHABLE("not exposed by reader::response");
+            break;
+        case token::code::request_target:
+            BOOST_HTTP_DETAIL_UNREACHABLE("not exposed by reader::response");
+            break;
+        case token::code::version:
+            {
+                auto value = parser.value<token::version>();
+                modern_http = value > 0;
+                keep_alive = KEEP_ALIVE_UNKNOWN;
+            }
+            break;
+        case token::code::status_code:
+            {
+                last_status_code = parser.value<token::status_code>();
+                if (status_code)
+                    *status_code = last_status_code;
+                parser.set_method(pending.front().method);
+            }
+            break;
+        case token::code::reason_phrase:
+            {
+                auto value = parser.value<token::reason_phrase>();
+                if (reason_phrase)
+                    reason_phrase->assign(value.data(), value.size());
+            }
+            break;
+        case token::code::field_name:
+        case token::code::trailer_name:
+            {
+                auto buf_view = asio::buffer_cast<char*>(buffer);
+                field_name_begin = nparsed;
+                field_name_size = parser.token_size();
+                field_id = parser.value<token::field_name_id>();
+
+                for (std::size_t i = 0 ; i != field_name_size ; ++i) {
+                    auto &ch = buf_view[field_name_begin + i];
+                    ch = std::tolower(ch);
+                }
+
+                expecting_field = true;
+            }
+            break;
+        case token::code::field_value:
+            use_trailers = false;
+            if (false)
+        case token::code::trailer_value:
+                use_trailers = true;
+            {
+                typedef typename Message::headers_type::key_type NameT;
+                typedef typename Message::headers_type::mapped_type ValueT;
+
+                auto buf_view = asio::buffer_cast<char*>(buffer);
+                auto name = string_ref(buf_view + field_name_begin,
+                                       field_name_size);
+                auto value = parser.value<token::field_value>();
+
+                if (field_id == header_id::connection && !use_trailers
+                    && keep_alive != KEEP_ALIVE_CLOSE_READ) {
+                    header_value_any_of(value, [&](string_ref v) {
+                            if (iequals(v, "close")) {
+                                keep_alive = KEEP_ALIVE_CLOSE_READ;
+                                return true;
+                            }
+
+                            if (iequals(v, "keep-alive"))
+                                keep_alive = KEEP_ALIVE_KEEP_ALIVE_READ;
+
+                            return false;
+                        });
+                }
+
+                (use_trailers ? message.trailers() : message.headers())
+                    .emplace(NameT(name.data(), name.size()),
+                             ValueT(value.data(), value.size()));
+
+                expecting_field = false;
+            }
+            break;
+        case token::code::end_of_headers:
+            istate = http::read_state::message_ready;
+            flags |= READY;
+            detail::seal_headers(message.headers(), 0);
+
+            if (keep_alive == KEEP_ALIVE_UNKNOWN) {
+                keep_alive = modern_http
+                    ? KEEP_ALIVE_KEEP_ALIVE_READ : KEEP_ALIVE_CLOSE_READ;
+            }
+            break;
+        case token::code::body_chunk:
+            {
+                system::error_code sink_ec;
+                detail::append_body(message.body(),
+                                    parser.value<token::body_chunk>(),
+                                    sink_ec);
+                if (sink_ec) {
+                    // The rest of the body can't be told apart from the next
+                    // response
+                    clear_buffer();
+                    keep_alive = KEEP_ALIVE_CLOSE_READ;
+                    is_open_ = false;
+                    channel.lowest_layer().close();
+                    handler(sink_ec);
+                    return;
+                }
+                flags |= DATA;
+            }
+            break;
+        case token::code::end_of_body:
+            istate = http::read_state::body_ready;
+            break;
+        case token::code::end_of_message:
+            istate = http::read_state::empty;
+            flags |= END;
+            detail::seal_headers(message.trailers(), 0);
+            on_response_read();
+            parser.set_buffer(asio::buffer(buffer + nparsed,
+                                           parser.token_size()));
+            break;
+        }
+
+        nparsed += parser.token_size();
+    } while (parser.code() != token::code::error_insufficient_data);
+
+    if (!expecting_field) {
+        auto buf_view = asio::buffer_cast<char*>(buffer);
+        std::copy_n(buf_view + nparsed, used_size - nparsed, buf_view);
+        used_size -= nparsed;
+    } else if(nparsed != 0) {
+        auto buf_view = asio::buffer_cast<char*>(buffer);
+        std::copy_n(buf_view + field_name_begin, field_name_size, buf_view);
+        std::copy_n(buf_view + nparsed, used_size - nparsed,
+                    buf_view + field_name_size);
+        used_size -= nparsed;
+        used_size += field_name_size;
+    }
+    nparsed = 0;
+
+    if (target == READY && flags & READY) {
+        handler(system::error_code{});
+    } else if (target == DATA && flags & (DATA|END)) {
+        handler(system::error_code{});
+    } else if (target == END && flags & END) {
+        handler(system::error_code{});
+    } else {
+        if (used_size == asio::buffer_size(buffer)) {
+            handler(system::error_code{http_errc::buffer_exhausted});
+            return;
+        }
+
+        channel.async_read_some(asio::buffer(buffer + used_size), continuation(
+                                std::move(handler),
+                                [this,status_code,reason_phrase,&message]
+                                (Handler &handler, const system::error_code &ec,
+                                 std::size_t bytes_transferred) {
+            on_async_read_message<target>(std::move(handler), status_code,
+                                          reason_phrase, message, ec,
+                                          bytes_transferred);
+        }));
+    }
+}
+
+template<class Socket>
+template<class Request>
+void basic_client_socket<Socket>::push_pending_request(const Request &request)
+{
+    pending.emplace_back();
+    pending.back().method.assign(request.method().data(),
+                                 request.method().size());
+    pending.back().close = detail::has_connection_close(request.headers());
+}
+
+template<class Socket>
+void basic_client_socket<Socket>::on_request_written()
+{
+    // The next request can be written right away (i.e. pipelining)
+    writer_helper = http::write_state::empty;
+}
+
+template<class Socket>
+void basic_client_socket<Socket>::on_response_read()
+{
+    // Interim responses precede the final response for the same request
+    if (last_status_code / 100 == 1 && last_status_code != 101)
+        return;
+
+    const bool tunnel = last_status_code == 101
+        || (last_status_code / 100 == 2 && pending.front().method == "CONNECT");
+    const bool close = pending.front().close;
+    pending.pop_front();
+
+    if (tunnel) {
+        // The channel now belongs to the user
+        is_open_ = false;
+        return;
+    }
+
+    if (close || keep_alive != KEEP_ALIVE_KEEP_ALIVE_READ) {
+        is_open_ = false;
+        channel.lowest_layer().close();
+    }
+}
+
+template<class Socket>
+void basic_client_socket<Socket>::clear_buffer()
+{
+    /* The output side is left alone, as a request might still be written
+       (it's reset by `on_request_written` and the write errors) */
+    istate = http::read_state::empty;
+    used_size = 0;
+    eof = false;
+    parser.reset();
+    expecting_field = false;
+}
+
+template<class Socket>
+template<class Message>
+void basic_client_socket<Socket>::clear_message(Message &message)
+{
+    message.headers().clear();
+    message.body().clear();
+    message.trailers().clear();
+}
+
+template<class Socket>
+template <typename Handler,
+          typename ErrorCode>
+void basic_client_socket<Socket>::invoke_handler(Handler&& handler,
+                                                 ErrorCode error)
+{
+    channel.get_io_service().post
+        (detail::make_posted_completion(operation_memory,
+                                        std::forward<Handler>(handler),
+                                        make_error_code(error)));
+}
+
+template<class Socket>
+template <class Handler>
+void basic_client_socket<Socket>::invoke_handler(Handler&& handler)
+{
+    channel.get_io_service().post
+        (detail::make_posted_completion(operation_memory,
+                                        std::forward<Handler>(handler),
+                                        system::error_code{}));
+}
+
+template<class Socket>
+template<class Handler, class Function>
+detail::continuation<typename std::decay<Handler>::type, Function>
+basic_client_socket<Socket>::continuation(Handler &&handler, Function function)
+{
+    return detail::make_continuation(operation_memory,
+                                     std::forward<Handler>(handler),
+                                     std::move(function));
+}
+
+} // namespace boost
+} // namespace http
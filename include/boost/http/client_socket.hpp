@@ -0,0 +1,212 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_CLIENT_SOCKET_HPP
+#define BOOST_HTTP_CLIENT_SOCKET_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <deque>
+#include <string>
+
+#include <boost/http/reader/response.hpp>
+#include <boost/http/socket.hpp>
+
+namespace boost {
+namespace http {
+
+/* The client side of `basic_socket`. Requests are written and responses are
+   read in the same style the server socket reads requests and writes
+   responses. Several requests can be written before their responses are read
+   (i.e. HTTP/1.1 pipelining), but responses are always read in order. */
+template<class Socket>
+class basic_client_socket
+{
+public:
+    typedef Socket next_layer_type;
+
+    // ### QUERY FUNCTIONS ###
+
+    bool is_open() const;
+    http::read_state read_state() const;
+    http::write_state write_state() const;
+
+    // Number of requests written whose responses weren't fully read yet
+    std::size_t pending_requests() const;
+
+    asio::io_service &get_io_service();
+
+    // ### END OF QUERY FUNCTIONS ###
+
+    // ### READ FUNCTIONS ###
+
+    template<class Response, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_read_response(Response &response, CompletionToken &&token);
+
+    template<class Message, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_read_some(Message &message, CompletionToken &&token);
+
+    template<class Message, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_read_trailers(Message &message, CompletionToken &&token);
+
+    // ### END OF READ FUNCTIONS ###
+
+    // ### WRITE FUNCTIONS ###
+
+    template<class Request, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_request(const Request &request, CompletionToken &&token);
+
+    template<class Request, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_request_metadata(const Request &request,
+                                 CompletionToken &&token);
+
+    template<class Message, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write(const Message &message, CompletionToken &&token);
+
+    template<class Message, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_trailers(const Message &message, CompletionToken &&token);
+
+    template<class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_end_of_message(CompletionToken &&token);
+
+    // ### END OF WRITE FUNCTIONS ###
+
+    // ### START OF basic_client_socket SPECIFIC FUNCTIONS ###
+
+    basic_client_socket(boost::asio::io_service &io_service,
+                        boost::asio::mutable_buffer inbuffer);
+
+    template<class... Args>
+    basic_client_socket(boost::asio::mutable_buffer inbuffer, Args&&... args);
+
+    next_layer_type &next_layer();
+    const next_layer_type &next_layer() const;
+
+    // Puts the socket back in its initial state (e.g. after reconnecting)
+    void open();
+
+private:
+    enum Target {
+        READY = 1,
+        DATA  = 1 << 1,
+        END   = 1 << 2,
+    };
+
+    enum keep_alive_state {
+        KEEP_ALIVE_UNKNOWN,
+        KEEP_ALIVE_CLOSE_READ,
+        KEEP_ALIVE_KEEP_ALIVE_READ
+    };
+
+    template<int target, class Message, class Handler,
+             class String = std::string>
+    void schedule_on_async_read_message(Handler &handler, Message &message,
+                                        std::uint_least16_t *status_code
+                                        = NULL,
+                                        String *reason_phrase = NULL);
+
+    template<int target, class Message, class Handler,
+             class String = std::string>
+    void on_async_read_message(Handler handler,
+                               std::uint_least16_t *status_code,
+                               String *reason_phrase, Message &message,
+                               const system::error_code &ec,
+                               std::size_t bytes_transferred);
+
+    template<class Request>
+    void push_pending_request(const Request &request);
+
+    void on_request_written();
+    void on_response_read();
+
+    void clear_buffer();
+
+    template<class Message>
+    static void clear_message(Message &message);
+
+    template <typename Handler,
+              typename ErrorCode>
+    void invoke_handler(Handler&& handler,
+                        ErrorCode error);
+
+    template<class Handler>
+    void invoke_handler(Handler &&handler);
+
+    template<class Handler, class Function>
+    detail::continuation<typename std::decay<Handler>::type, Function>
+    continuation(Handler &&handler, Function function);
+
+    // Backs the internal operations (declared first to outlive `channel`)
+    detail::handler_memory operation_memory;
+
+    Socket channel;
+    bool is_open_ = true;
+    http::read_state istate;
+
+    asio::mutable_buffer buffer;
+    std::size_t used_size = 0;
+    // Set once the peer closes its side of the connection
+    bool eof = false;
+
+    reader::response parser;
+
+    /* `field_name` value is stored in `[buffer[0], field_name_size)`.
+       `expecting_field` means don't touch the buffer or madness will come. */
+    std::size_t field_name_size;
+    header_id::value field_id;
+    bool expecting_field = false;
+    bool modern_http; // at least HTTP/1.1
+    keep_alive_state keep_alive;
+    std::uint_least16_t last_status_code;
+
+    // Output state
+    detail::writer_helper writer_helper;
+    // Request metadata is rendered here (and reused across requests)
+    std::string staging_buffer;
+
+    // What reading the response to each written request needs to know
+    struct pending_request
+    {
+        std::string method;
+        // The request carried "connection: close"
+        bool close;
+    };
+
+    std::deque<pending_request> pending;
+};
+
+typedef basic_client_socket<boost::asio::ip::tcp::socket> client_socket;
+
+} // namespace http
+} // namespace boost
+
+#include "client_socket-inl.hpp"
+
+#endif // BOOST_HTTP_CLIENT_SOCKET_HPP
@@ -0,0 +1,866 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+namespace boost {
+namespace http {
+
+namespace detail {
+
+// Media types whose payloads are compressed already
+inline bool is_compressed_media_type(string_ref type)
+{
+    static const char *prefixes[] = {
+        "image/",
+        "audio/",
+        "video/",
+        "font/woff",
+        "application/zip",
+        "application/gzip",
+        "application/x-gzip",
+        "application/x-bzip2",
+        "application/x-xz",
+        "application/zstd",
+        "application/x-7z-compressed",
+        "application/x-rar-compressed"
+    };
+
+    auto lowercase_starts_with = [&type](string_ref prefix) {
+        if (type.size() < prefix.size())
+            return false;
+        for (std::size_t i = 0 ; i != prefix.size() ; ++i) {
+            char c = type[i];
+            if (c >= 'A' && c <= 'Z')
+                c = c - 'A' + 'a';
+            if (c != prefix[i])
+                return false;
+        }
+        return true;
+    };
+
+    // Text, unlike the other images
+    if (lowercase_starts_with("image/svg+xml"))
+        return false;
+
+    for (auto prefix: prefixes) {
+        if (lowercase_starts_with(prefix))
+            return true;
+    }
+    return false;
+}
+
+// Whether the "vary" fields of `headers` already cover "accept-encoding"
+template<class Headers>
+bool varies_on_accept_encoding(const Headers &headers)
+{
+    typedef basic_string_ref<typename Headers::mapped_type::value_type>
+        string_ref_type;
+
+    auto range = headers.equal_range("vary");
+    for (; range.first != range.second ; ++range.first) {
+        if (header_value_any_of(range.first->second,
+                                [](const string_ref_type &v) {
+                                    return v == "*"
+                                        || iequals(v, "accept-encoding");
+                                })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A copy of `response` without the body (which is the costly part)
+template<class Response>
+std::shared_ptr<Response> metadata_copy(const Response &response)
+{
+    auto ret = std::make_shared<Response>();
+    ret->status_code() = response.status_code();
+    ret->reason_phrase() = response.reason_phrase();
+    ret->headers() = response.headers();
+    ret->trailers() = response.trailers();
+    return ret;
+}
+
+/* Writes `copy` (whose body is empty) with the body of `response` (which
+   outlives the operation) if `socket` can send external buffers. Returns
+   false otherwise (and `handler` is left alone). `handler` keeps `copy`
+   alive. */
+template<class Socket, class Response, class Handler>
+auto async_write_with_body_of(Socket &socket, const Response &copy,
+                              const Response &response, Handler &handler, int)
+    -> decltype(socket.pipeline_depth(),
+                socket.async_write_response_buffers(copy,
+                                                    asio::const_buffers_1
+                                                    (nullptr, 0),
+                                                    std::move(handler)),
+                bool())
+{
+    if (socket.pipeline_depth() != 1)
+        return false;
+
+    socket.async_write_response_buffers(copy, asio::buffer(response.body()),
+                                        std::move(handler));
+    return true;
+}
+
+template<class Socket, class Response, class Handler>
+bool async_write_with_body_of(Socket&, const Response&, const Response&,
+                              Handler&, long)
+{
+    return false;
+}
+
+// Calls the handler, which keeps `copy` alive until then
+template<class Response>
+struct keep_copy
+{
+    template<class Handler>
+    void operator()(Handler &handler, const system::error_code &ec) const
+    {
+        handler(ec);
+    }
+
+    std::shared_ptr<Response> copy;
+};
+
+} // namespace detail
+
+template<class Socket, class Message>
+template<class... Args>
+compressing_server_socket<Socket, Message>
+::compressing_server_socket(Args&&... args)
+    : next_layer_(std::forward<Args>(args)...)
+{}
+
+template<class Socket, class Message>
+Socket &compressing_server_socket<Socket, Message>::next_layer()
+{
+    return next_layer_;
+}
+
+template<class Socket, class Message>
+const Socket &compressing_server_socket<Socket, Message>::next_layer() const
+{
+    return next_layer_;
+}
+
+template<class Socket, class Message>
+void compressing_server_socket<Socket, Message>
+::set_compression_level(int level)
+{
+    this->level = level;
+}
+
+template<class Socket, class Message>
+int compressing_server_socket<Socket, Message>::compression_level() const
+{
+    return level;
+}
+
+template<class Socket, class Message>
+void compressing_server_socket<Socket, Message>::set_min_size(std::size_t size)
+{
+    min_size_ = size;
+}
+
+template<class Socket, class Message>
+std::size_t compressing_server_socket<Socket, Message>::min_size() const
+{
+    return min_size_;
+}
+
+template<class Socket, class Message>
+void compressing_server_socket<Socket, Message>
+::set_flush(compression_flush policy)
+{
+    flush_ = policy;
+}
+
+template<class Socket, class Message>
+compression_flush compressing_server_socket<Socket, Message>::flush() const
+{
+    return flush_;
+}
+
+template<class Socket, class Message>
+void compressing_server_socket<Socket, Message>
+::set_flush_threshold(std::size_t size)
+{
+    flush_threshold_ = size;
+}
+
+template<class Socket, class Message>
+std::size_t compressing_server_socket<Socket, Message>::flush_threshold() const
+{
+    return flush_threshold_;
+}
+
+template<class Socket, class Message>
+bool compressing_server_socket<Socket, Message>::is_open() const
+{
+    return next_layer_.is_open();
+}
+
+template<class Socket, class Message>
+read_state compressing_server_socket<Socket, Message>::read_state() const
+{
+    return next_layer_.read_state();
+}
+
+template<class Socket, class Message>
+write_state compressing_server_socket<Socket, Message>::write_state() const
+{
+    return next_layer_.write_state();
+}
+
+template<class Socket, class Message>
+bool compressing_server_socket<Socket, Message>
+::write_response_native_stream() const
+{
+    return next_layer_.write_response_native_stream();
+}
+
+template<class Socket, class Message>
+asio::io_service &compressing_server_socket<Socket, Message>::get_io_service()
+{
+    return next_layer_.get_io_service();
+}
+
+template<class Socket, class Message>
+template<class Request, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+compressing_server_socket<Socket, Message>
+::async_read_request(Request &request, CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+    asio::async_result<Handler> result(handler);
+
+    /* `streaming` isn't touched, as the previous response might still be
+       written while this request is read (pipelining) */
+    next_layer_.async_read_request(request, continuation(
+                                   std::move(handler),
+                                   [this,&request]
+                                   (Handler &handler,
+                                    const system::error_code &ec) {
+        if (!ec) {
+            request_codings codings;
+            codings.response = negotiate(request);
+            codings.validators = decode_validators(request, codings.response);
+            accepted.push_back(codings);
+        }
+        handler(ec);
+    }));
+    return result.get();
+}
+
+template<class Socket, class Message>
+template<class ReadMessage, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+compressing_server_socket<Socket, Message>
+::async_read_some(ReadMessage &message, CompletionToken &&token)
+{
+    return next_layer_.async_read_some(message,
+                                       std::forward<CompletionToken>(token));
+}
+
+template<class Socket, class Message>
+template<class ReadMessage, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+compressing_server_socket<Socket, Message>
+::async_read_trailers(ReadMessage &message, CompletionToken &&token)
+{
+    return next_layer_.async_read_trailers(message,
+                                           std::forward<CompletionToken>
+                                           (token));
+}
+
+template<class Socket, class Message>
+template<class Response, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+compressing_server_socket<Socket, Message>
+::async_write_response(const Response &response, CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+    asio::async_result<Handler> result(handler);
+
+    /* Rejected by the next layer while a streamed body is written, which
+       keeps its coding and the deflate stream */
+    if (write_state() == http::write_state::metadata_issued) {
+        next_layer_.async_write_response(response, std::move(handler));
+        return result.get();
+    }
+
+    auto codings = pop_codings();
+    auto coding = codings.response;
+
+    if (response.status_code() == 304) {
+        if (auto copy = revalidated_copy(response, codings.validators)) {
+            next_layer_.async_write_response(*copy, continuation(
+                                             std::move(handler),
+                                             detail::keep_copy<Response>
+                                             {copy}));
+            return result.get();
+        }
+    }
+
+    std::size_t size = response.body().size();
+    if (!compressible(response, &size)) {
+        next_layer_.async_write_response(response, std::move(handler));
+        return result.get();
+    }
+
+    if (coding != detail::deflater::none && deflater.reset(coding, level)) {
+        auto copy = encoded_copy(response, coding);
+        asio::const_buffer body(size ? &response.body()[0] : nullptr, size);
+
+        // Not worth it otherwise
+        if (deflater.write(body, Z_FINISH, copy->body())
+            && copy->body().size() < size) {
+            next_layer_.async_write_response(*copy, continuation(
+                                             std::move(handler),
+                                             detail::keep_copy<Response>
+                                             {copy}));
+            return result.get();
+        }
+    }
+
+    if (detail::varies_on_accept_encoding(response.headers())) {
+        next_layer_.async_write_response(response, std::move(handler));
+        return result.get();
+    }
+
+    // Caches MUST NOT serve it to clients accepting a coding
+    auto copy = detail::metadata_copy(response);
+    copy->headers().emplace("vary", "accept-encoding");
+    auto wrapped = continuation(std::move(handler),
+                                detail::keep_copy<Response>{copy});
+    if (detail::async_write_with_body_of(next_layer_, *copy, response, wrapped,
+                                         0)) {
+        return result.get();
+    }
+
+    // The next layer only writes whole messages
+    copy->body() = response.body();
+    next_layer_.async_write_response(*copy, std::move(wrapped));
+    return result.get();
+}
+
+template<class Socket, class Message>
+template<class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+compressing_server_socket<Socket, Message>
+::async_write_response_continue(CompletionToken &&token)
+{
+    return next_layer_.async_write_response_continue(std::forward<
+                                                     CompletionToken>(token));
+}
+
+template<class Socket, class Message>
+template<class Response, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+compressing_server_socket<Socket, Message>
+::async_write_response_metadata(const Response &response,
+                                CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+    asio::async_result<Handler> result(handler);
+
+    // See `async_write_response`
+    if (write_state() == http::write_state::metadata_issued) {
+        next_layer_.async_write_response_metadata(response, std::move(handler));
+        return result.get();
+    }
+
+    auto codings = pop_codings();
+    auto coding = codings.response;
+
+    chunk.body().clear();
+
+    auto state = write_state();
+    bool negotiated = (state == http::write_state::empty
+                       || state == http::write_state::continue_issued)
+        && write_response_native_stream() && compressible(response, nullptr);
+    streaming = negotiated && coding != detail::deflater::none
+        && deflater.reset(coding, level);
+    pending = 0;
+
+    std::shared_ptr<Response> copy;
+    if (response.status_code() == 304)
+        copy = revalidated_copy(response, codings.validators);
+
+    if (!streaming && !copy
+        && (!negotiated
+            || detail::varies_on_accept_encoding(response.headers()))) {
+        next_layer_.async_write_response_metadata(response, std::move(handler));
+        return result.get();
+    }
+
+    if (streaming) {
+        copy = encoded_copy(response, coding);
+    } else if (!copy) {
+        copy = detail::metadata_copy(response);
+        copy->headers().emplace("vary", "accept-encoding");
+    }
+    next_layer_.async_write_response_metadata(*copy, continuation(
+                                              std::move(handler),
+                                              detail::keep_copy<Response>
+                                              {copy}));
+    return result.get();
+}
+
+template<class Socket, class Message>
+template<class WriteMessage, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+compressing_server_socket<Socket, Message>
+::async_write(const WriteMessage &message, CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+    asio::async_result<Handler> result(handler);
+
+    if (!streaming || write_state() != http::write_state::metadata_issued) {
+        next_layer_.async_write(message, std::move(handler));
+        return result.get();
+    }
+
+    if (idle_ec) {
+        invoke_handler(std::move(handler), idle_ec);
+        idle_ec.clear();
+        return result.get();
+    }
+
+    auto size = message.body().size();
+    pending += size;
+    ++nwrites;
+    bool flush = flush_ == compression_flush::every_write
+        || pending >= flush_threshold_ || size == 0;
+
+    if (!deflater.write(asio::const_buffer(size ? &message.body()[0] : nullptr,
+                                           size),
+                        flush ? Z_SYNC_FLUSH : Z_NO_FLUSH, chunk.body())) {
+        invoke_handler(std::move(handler),
+                       system::errc::make_error_code(system::errc::io_error));
+        return result.get();
+    }
+    if (flush)
+        pending = 0;
+
+    // Held back (by zlib or until the writer goes idle)
+    if (chunk.body().empty() || !flush) {
+        invoke_handler(std::move(handler), system::error_code{});
+        // After the handler, which might write the next chunk
+        if (pending)
+            schedule_idle_flush();
+        return result.get();
+    }
+
+    send_chunk(handler, [](Handler &handler) {
+            handler(system::error_code{});
+        });
+    return result.get();
+}
+
+template<class Socket, class Message>
+template<class WriteMessage, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+compressing_server_socket<Socket, Message>
+::async_write_trailers(const WriteMessage &message, CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+    asio::async_result<Handler> result(handler);
+
+    if (!streaming || write_state() != http::write_state::metadata_issued) {
+        next_layer_.async_write_trailers(message, std::move(handler));
+        return result.get();
+    }
+
+    write_tail([this, &message](Handler &handler) {
+            next_layer_.async_write_trailers(message, std::move(handler));
+        }, handler);
+    return result.get();
+}
+
+template<class Socket, class Message>
+template<class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+compressing_server_socket<Socket, Message>
+::async_write_end_of_message(CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+    asio::async_result<Handler> result(handler);
+
+    if (!streaming || write_state() != http::write_state::metadata_issued) {
+        next_layer_.async_write_end_of_message(std::move(handler));
+        return result.get();
+    }
+
+    write_tail([this](Handler &handler) {
+            next_layer_.async_write_end_of_message(std::move(handler));
+        }, handler);
+    return result.get();
+}
+
+template<class Socket, class Message>
+template<class Request>
+detail::deflater::coding_type
+compressing_server_socket<Socket, Message>::negotiate(const Request &request)
+{
+    typedef typename Request::headers_type::mapped_type::value_type CharT;
+
+    auto accept_encoding = detail::joined_accept_encoding(request);
+    basic_string_ref<CharT> accepted(accept_encoding);
+
+    int identity = detail::identity_threshold(accepted);
+    int gzip = detail::encoding_quality(accepted, "gzip");
+    int deflate = detail::encoding_quality(accepted, "deflate");
+
+    if (gzip >= identity && gzip >= deflate)
+        return detail::deflater::gzip;
+    if (deflate >= identity)
+        return detail::deflater::deflate;
+    return detail::deflater::none;
+}
+
+template<class Socket, class Message>
+template<class Request>
+detail::deflater::coding_type compressing_server_socket<Socket, Message>
+::decode_validators(Request &request, detail::deflater::coding_type preferred)
+{
+    const detail::deflater::coding_type codings[] = {
+        detail::deflater::gzip,
+        detail::deflater::deflate
+    };
+
+    auto ret = detail::deflater::none;
+    for (auto name: {"if-none-match", "if-match"}) {
+        auto list = detail::joined_field(request, name);
+        std::string decoded(list.begin(), list.end());
+        bool found = false;
+        for (auto coding: codings) {
+            auto value = detail::decoded_etags(decoded,
+                                               detail::deflater::name(coding));
+            if (value.empty())
+                continue;
+
+            decoded = std::move(value);
+            found = true;
+            if (ret == detail::deflater::none || coding == preferred)
+                ret = coding;
+        }
+        if (!found)
+            continue;
+
+        // The tags as sent are kept, as they might be the application's own
+        std::string value(list.begin(), list.end());
+        value += ", ";
+        value += decoded;
+        request.headers().erase(name);
+        request.headers().emplace(name, value);
+    }
+    return ret;
+}
+
+template<class Socket, class Message>
+typename compressing_server_socket<Socket, Message>::request_codings
+compressing_server_socket<Socket, Message>::pop_codings()
+{
+    // e.g. an error reply to a request that failed to be read
+    if (accepted.empty()) {
+        request_codings ret;
+        ret.response = detail::deflater::none;
+        ret.validators = detail::deflater::none;
+        return ret;
+    }
+
+    auto ret = accepted.front();
+    accepted.pop_front();
+    return ret;
+}
+
+template<class Socket, class Message>
+template<class Response>
+bool compressing_server_socket<Socket, Message>
+::compressible(const Response &response, const std::size_t *size)
+{
+    auto status = response.status_code();
+    if (status < 200 || status == 204 || status == 206 || status == 304)
+        return false;
+
+    const auto &headers = response.headers();
+    if (headers.find("content-encoding") != headers.end()
+        || headers.find("content-range") != headers.end()) {
+        return false;
+    }
+
+    auto content_type = headers.find("content-type");
+    if (content_type != headers.end()) {
+        const auto &value = content_type->second;
+        if (detail::is_compressed_media_type(string_ref(value.data(),
+                                                        value.size()))) {
+            return false;
+        }
+    }
+
+    bool no_transform = false;
+    auto cache_control = headers.equal_range("cache-control");
+    for (auto it = cache_control.first ; it != cache_control.second ; ++it) {
+        header_value_for_each(string_ref(it->second.data(), it->second.size()),
+                              [&no_transform](string_ref v) {
+                                  if (v == "no-transform")
+                                      no_transform = true;
+                              });
+    }
+    if (no_transform)
+        return false;
+
+    if (size)
+        return *size >= min_size_;
+
+    // Streamed bodies are only small if their length is known
+    auto content_length = headers.equal_range("content-length");
+    if (std::distance(content_length.first, content_length.second) == 1) {
+        const auto &value = content_length.first->second;
+        std::uintmax_t length = 0;
+        for (auto c: value) {
+            if (c < '0' || c > '9')
+                return true;
+            length = length * 10 + (c - '0');
+            if (length >= min_size_)
+                return true;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+template<class Socket, class Message>
+template<class Response>
+std::shared_ptr<Response>
+compressing_server_socket<Socket, Message>
+::encoded_copy(const Response &response,
+               detail::deflater::coding_type coding)
+{
+    const char *name = detail::deflater::name(coding);
+
+    // The body is left empty for the deflated one
+    auto ret = detail::metadata_copy(response);
+    auto &headers = ret->headers();
+    headers.erase("content-length");
+    // Partial responses are never encoded, so ranges refer to the identity
+    headers.erase("accept-ranges");
+    headers.emplace("content-encoding", name);
+
+    // Entity tags set by the application identify the unencoded one
+    auto etag = headers.equal_range("etag");
+    if (std::distance(etag.first, etag.second) == 1) {
+        auto value = detail::encoded_etag(etag.first->second, name);
+        if (value.size())
+            detail::replace_field(headers, etag.first, "etag", value);
+    }
+
+    if (!detail::varies_on_accept_encoding(headers))
+        headers.emplace("vary", "accept-encoding");
+    return ret;
+}
+
+template<class Socket, class Message>
+template<class Response>
+std::shared_ptr<Response>
+compressing_server_socket<Socket, Message>
+::revalidated_copy(const Response &response,
+                   detail::deflater::coding_type coding)
+{
+    if (coding == detail::deflater::none)
+        return nullptr;
+
+    const char *name = detail::deflater::name(coding);
+    auto etag = response.headers().equal_range("etag");
+    // Tags naming the coding already (e.g. precompressed files) are kept
+    if (std::distance(etag.first, etag.second) != 1
+        || detail::decoded_etag(etag.first->second, name).size()) {
+        return nullptr;
+    }
+
+    auto value = detail::encoded_etag(etag.first->second, name);
+    if (value.empty())
+        return nullptr;
+
+    auto ret = detail::metadata_copy(response);
+    auto &headers = ret->headers();
+    detail::replace_field(headers, headers.find("etag"), "etag", value);
+    return ret;
+}
+
+template<class Socket, class Message>
+template<class Function, class Handler>
+void compressing_server_socket<Socket, Message>
+::write_tail(Function function, Handler &handler)
+{
+    streaming = false;
+    pending = 0;
+
+    if (idle_ec) {
+        invoke_handler(std::move(handler), idle_ec);
+        idle_ec.clear();
+        return;
+    }
+
+    if (!deflater.write(asio::const_buffer(), Z_FINISH, chunk.body())) {
+        invoke_handler(std::move(handler),
+                       system::errc::make_error_code(system::errc::io_error));
+        return;
+    }
+
+    send_chunk(handler, std::move(function));
+}
+
+template<class Socket, class Message>
+template<class Handler, class Function>
+void compressing_server_socket<Socket, Message>
+::send_chunk(Handler &handler, Function function)
+{
+    // The application's writes never overlap, but an idle flush might
+    if (writing) {
+        parked.reset(detail::make_completion
+                     (operation_memory, std::move(handler),
+                      [this,function](Handler &handler,
+                                      const system::error_code &ec) {
+                          if (ec)
+                              return handler(ec);
+                          send_chunk(handler, function);
+                      }));
+        return;
+    }
+
+    // Both bodies keep their capacity, so steady state writes don't allocate
+    std::swap(inflight.body(), chunk.body());
+    chunk.body().clear();
+    writing = true;
+    next_layer_.async_write(inflight, continuation(
+                            std::move(handler),
+                            [this,function](Handler &handler,
+                                            const system::error_code &ec) {
+        writing = false;
+        if (ec)
+            return handler(ec);
+        function(handler);
+    }));
+}
+
+template<class Socket, class Message>
+void compressing_server_socket<Socket, Message>::schedule_idle_flush()
+{
+    if (idle_check_posted)
+        return;
+
+    idle_check_posted = true;
+    idle_nwrites = nwrites;
+    get_io_service().post(detail::make_recycling_handler(operation_memory,
+                                                         [this]() {
+        on_idle();
+    }));
+}
+
+template<class Socket, class Message>
+void compressing_server_socket<Socket, Message>::on_idle()
+{
+    idle_check_posted = false;
+
+    // Flushed (or finished) meanwhile, or retried once the write is done
+    if (!streaming || pending == 0 || writing)
+        return;
+
+    // The application is still producing chunks
+    if (nwrites != idle_nwrites) {
+        schedule_idle_flush();
+        return;
+    }
+
+    pending = 0;
+    if (!deflater.write(asio::const_buffer(), Z_SYNC_FLUSH, chunk.body())) {
+        idle_ec = system::errc::make_error_code(system::errc::io_error);
+        return;
+    }
+    if (chunk.body().empty())
+        return;
+
+    std::swap(inflight.body(), chunk.body());
+    chunk.body().clear();
+    writing = true;
+    next_layer_.async_write(inflight, detail::make_recycling_handler(
+                            operation_memory,
+                            [this](const system::error_code &ec) {
+        writing = false;
+
+        if (parked) {
+            parked.release()->complete(ec);
+            return;
+        }
+
+        if (ec)
+            idle_ec = ec;
+        else if (pending)
+            schedule_idle_flush();
+    }));
+}
+
+template<class Socket, class Message>
+template<class Handler>
+void compressing_server_socket<Socket, Message>
+::invoke_handler(Handler &&handler, const system::error_code &ec)
+{
+    get_io_service().post(detail::make_posted_completion
+                          (operation_memory, std::forward<Handler>(handler),
+                           ec));
+}
+
+template<class Socket, class Message>
+template<class Handler, class Function>
+detail::continuation<typename std::decay<Handler>::type, Function>
+compressing_server_socket<Socket, Message>
+::continuation(Handler &&handler, Function function)
+{
+    return detail::make_continuation(operation_memory,
+                                     std::forward<Handler>(handler),
+                                     std::move(function));
+}
+
+} // namespace http
+} // namespace boost
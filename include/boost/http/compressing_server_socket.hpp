@@ -0,0 +1,377 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_COMPRESSING_SERVER_SOCKET_HPP
+#define BOOST_HTTP_COMPRESSING_SERVER_SOCKET_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <zlib.h>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include <boost/http/read_state.hpp>
+#include <boost/http/write_state.hpp>
+#include <boost/http/response.hpp>
+#include <boost/http/traits.hpp>
+#include <boost/http/detail/accept_encoding.hpp>
+#include <boost/http/detail/handler_memory.hpp>
+
+#ifndef BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_LEVEL
+#define BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_LEVEL 6
+#endif // BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_LEVEL
+
+#ifndef BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_MIN_SIZE
+#define BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_MIN_SIZE 256
+#endif // BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_MIN_SIZE
+
+#ifndef BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_FLUSH_THRESHOLD
+#define BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_FLUSH_THRESHOLD 16384
+#endif // BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_FLUSH_THRESHOLD
+
+namespace boost {
+namespace http {
+
+// When the compressed bytes of a chunked body are handed to the next layer
+enum class compression_flush
+{
+    // Every `async_write` is flushed (lowest latency, worst ratio)
+    every_write,
+    /* Compressed bytes are held back until `flush_threshold` uncompressed
+       bytes are pending or the writer goes idle (an `async_write` with an
+       empty body flushes them earlier) */
+    buffered
+};
+
+namespace detail {
+
+// A zlib deflate stream reused across messages
+class deflater
+{
+public:
+    enum coding_type { none, gzip, deflate };
+
+    // The content-coding token of `coding` (which can't be `none`)
+    static const char *name(coding_type coding)
+    {
+        return coding == gzip ? "gzip" : "deflate";
+    }
+
+    deflater() = default;
+
+    deflater(const deflater&) = delete;
+    deflater &operator=(const deflater&) = delete;
+
+    ~deflater()
+    {
+        end();
+    }
+
+    // Starts a new stream, false on errors
+    bool reset(coding_type coding, int level)
+    {
+        if (coding == coding_ && level == level_)
+            return ::deflateReset(&stream) == Z_OK;
+
+        end();
+        stream = z_stream();
+        int window_bits = coding == gzip ? 15 + 16 : 15;
+        if (::deflateInit2(&stream, level, Z_DEFLATED, window_bits, 8,
+                           Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+
+        coding_ = coding;
+        level_ = level;
+        return true;
+    }
+
+    /* Appends the deflated `input` to `out` (flushing as `flush` says), false
+       on errors */
+    template<class Body>
+    bool write(asio::const_buffer input, int flush, Body &out)
+    {
+        const std::size_t block = 16384;
+
+        stream.next_in = const_cast<Bytef*>(asio::buffer_cast<const Bytef*>
+                                            (input));
+        stream.avail_in = static_cast<uInt>(asio::buffer_size(input));
+
+        int ret;
+        do {
+            auto size = out.size();
+            out.resize(size + block);
+            stream.next_out = reinterpret_cast<Bytef*>(&out[0] + size);
+            stream.avail_out = block;
+            ret = ::deflate(&stream, flush);
+            out.resize(size + block - stream.avail_out);
+            if (ret == Z_STREAM_ERROR)
+                return false;
+        } while (ret != Z_STREAM_END
+                 && (stream.avail_out == 0 || stream.avail_in != 0));
+        return true;
+    }
+
+private:
+    void end()
+    {
+        if (coding_ != none)
+            ::deflateEnd(&stream);
+        coding_ = none;
+    }
+
+    z_stream stream;
+    coding_type coding_ = none;
+    int level_ = 0;
+};
+
+} // namespace detail
+
+/* Wraps a ServerSocket and compresses the response bodies (gzip or deflate,
+   as the client's "accept-encoding" prefers) on their way to it. Responses
+   already encoded, partial, of compressed media types (e.g. images) or with
+   bodies smaller than `min_size` are passed through unchanged.
+
+   The coding is negotiated for every request read and used by the response
+   written for it, so the next layer may pipeline requests (responses are
+   written in the order the requests were read).
+
+   `Message` is the type of the messages handed to the next layer to write the
+   compressed chunks. */
+template<class Socket, class Message = response>
+class compressing_server_socket
+{
+public:
+    static_assert(is_server_socket<Socket>::value,
+                  "Socket must fulfill the ServerSocket concept");
+
+    typedef Socket next_layer_type;
+
+    template<class... Args>
+    explicit compressing_server_socket(Args&&... args);
+
+    next_layer_type &next_layer();
+    const next_layer_type &next_layer() const;
+
+    // zlib compression level (0-9, changes apply to the next response)
+    void set_compression_level(int level);
+    int compression_level() const;
+
+    /* Bodies smaller than `size` aren't compressed (streamed bodies are only
+       checked if they have a "content-length" field) */
+    void set_min_size(std::size_t size);
+    std::size_t min_size() const;
+
+    void set_flush(compression_flush policy);
+    compression_flush flush() const;
+
+    // Uncompressed bytes `compression_flush::buffered` may hold back
+    void set_flush_threshold(std::size_t size);
+    std::size_t flush_threshold() const;
+
+    // ### QUERY FUNCTIONS ###
+
+    bool is_open() const;
+    http::read_state read_state() const;
+    http::write_state write_state() const;
+    bool write_response_native_stream() const;
+
+    asio::io_service &get_io_service();
+
+    // ### READ FUNCTIONS ###
+
+    template<class Request, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_read_request(Request &request, CompletionToken &&token);
+
+    template<class ReadMessage, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_read_some(ReadMessage &message, CompletionToken &&token);
+
+    template<class ReadMessage, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_read_trailers(ReadMessage &message, CompletionToken &&token);
+
+    // ### WRITE FUNCTIONS ###
+
+    template<class Response, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_response(const Response &response, CompletionToken &&token);
+
+    template<class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_response_continue(CompletionToken &&token);
+
+    template<class Response, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_response_metadata(const Response &response,
+                                  CompletionToken &&token);
+
+    template<class WriteMessage, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write(const WriteMessage &message, CompletionToken &&token);
+
+    template<class WriteMessage, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_trailers(const WriteMessage &message,
+                         CompletionToken &&token);
+
+    template<class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_end_of_message(CompletionToken &&token);
+
+private:
+    // What a request asked for
+    struct request_codings
+    {
+        // The coding the client prefers for the response
+        detail::deflater::coding_type response;
+        /* The coding named by the entity tags of its conditional fields (the
+           representation the client holds) */
+        detail::deflater::coding_type validators;
+    };
+
+    // The coding the client prefers (gzip on ties)
+    template<class Request>
+    static detail::deflater::coding_type negotiate(const Request &request);
+
+    /* Makes the "if-none-match" and "if-match" fields of `request` also list
+       the unencoded representation of the tags `encoded_copy` gave out (e.g.
+       `"v1"` next to `"v1-gzip"`), as the application only knows that one.
+       Returns the coding found (`preferred` if several). */
+    template<class Request>
+    static detail::deflater::coding_type
+    decode_validators(Request &request,
+                      detail::deflater::coding_type preferred);
+
+    /* Whether `response` (with a body of `size` bytes, if known) is
+       compressed for clients accepting a coding */
+    template<class Response>
+    bool compressible(const Response &response, const std::size_t *size);
+
+    // Takes the codings negotiated for the request being answered
+    request_codings pop_codings();
+
+    /* A copy of the metadata of `response` announcing `coding` (and
+       identifying the encoded representation). The body is left empty. */
+    template<class Response>
+    std::shared_ptr<Response> encoded_copy(const Response &response,
+                                           detail::deflater::coding_type
+                                           coding);
+
+    /* A copy of the metadata of the 304 `response` whose entity tag names
+       `coding`, as the one the client validated did. Null if there's nothing
+       to change. */
+    template<class Response>
+    static std::shared_ptr<Response>
+    revalidated_copy(const Response &response,
+                     detail::deflater::coding_type coding);
+
+    /* Writes the end of the compressed body and then calls `function` with
+       `handler` */
+    template<class Function, class Handler>
+    void write_tail(Function function, Handler &handler);
+
+    /* Hands the compressed bytes to the next layer (once the idle flush in
+       progress is done) and then calls `function` with `handler` */
+    template<class Handler, class Function>
+    void send_chunk(Handler &handler, Function function);
+
+    /* Flushes the bytes held back by `compression_flush::buffered` once a
+       whole io_service turn goes by without writes */
+    void schedule_idle_flush();
+    void on_idle();
+
+    template<class Handler>
+    void invoke_handler(Handler &&handler, const system::error_code &ec);
+
+    template<class Handler, class Function>
+    detail::continuation<typename std::decay<Handler>::type, Function>
+    continuation(Handler &&handler, Function function);
+
+    /* Backs the wrappers of the user's handlers. Declared first so it
+       outlives `next_layer_`. */
+    detail::handler_memory operation_memory;
+
+    Socket next_layer_;
+
+    int level = BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_LEVEL;
+    std::size_t min_size_
+    = BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_MIN_SIZE;
+    compression_flush flush_ = compression_flush::buffered;
+    std::size_t flush_threshold_
+    = BOOST_HTTP_COMPRESSING_SERVER_SOCKET_DEFAULT_FLUSH_THRESHOLD;
+
+    /* Negotiated on every request, one per request read and not answered yet
+       (in the order they were read) */
+    std::deque<request_codings> accepted;
+    // Whether the chunked body being written is compressed
+    bool streaming = false;
+    // Uncompressed bytes not flushed yet
+    std::size_t pending = 0;
+    detail::deflater deflater;
+    // Compressed bytes not handed to the next layer yet
+    Message chunk;
+    // Compressed bytes being written by the next layer (if `writing`)
+    Message inflight;
+    bool writing = false;
+
+    // Idle flush state {{{
+
+    bool idle_check_posted = false;
+    // Chunks written so far and when the idle check was posted
+    std::size_t nwrites = 0;
+    std::size_t idle_nwrites;
+    // An operation waiting for the idle flush being written
+    detail::completion_ptr parked;
+    // The idle flush failed (reported to the next operation)
+    system::error_code idle_ec;
+
+    // }}}
+};
+
+template<class Socket, class Message>
+struct is_server_socket<compressing_server_socket<Socket, Message>>
+    : public std::true_type
+{};
+
+} // namespace http
+} // namespace boost
+
+#include "compressing_server_socket-inl.hpp"
+
+#endif // BOOST_HTTP_COMPRESSING_SERVER_SOCKET_HPP
@@ -0,0 +1,311 @@
+namespace boost {
+namespace http {
+
+template<class Socket, std::size_t N>
+basic_connection_pool<Socket, N>
+::basic_connection_pool(asio::io_service &io_service)
+    : io_service(io_service)
+    , self(std::make_shared<basic_connection_pool*>(this))
+    , operation_memory(std::make_shared<detail::handler_memory>())
+{}
+
+template<class Socket, std::size_t N>
+void basic_connection_pool<Socket, N>::set_max_idle(std::size_t max)
+{
+    max_idle_ = max;
+    while (idle.size() > max_idle_)
+        evict(std::prev(idle.end()));
+}
+
+template<class Socket, std::size_t N>
+std::size_t basic_connection_pool<Socket, N>::max_idle() const
+{
+    return max_idle_;
+}
+
+template<class Socket, std::size_t N>
+void basic_connection_pool<Socket, N>::set_max_idle_per_host(std::size_t max)
+{
+    max_idle_per_host_ = max;
+
+    // Walk from the least recently used connection
+    for (auto it = idle.end() ; it != idle.begin() ;) {
+        --it;
+        if (idle_per_host[it->key] > max_idle_per_host_)
+            it = evict(it);
+    }
+}
+
+template<class Socket, std::size_t N>
+std::size_t basic_connection_pool<Socket, N>::max_idle_per_host() const
+{
+    return max_idle_per_host_;
+}
+
+template<class Socket, std::size_t N>
+void basic_connection_pool<Socket, N>
+::set_idle_timeout(clock_type::duration timeout)
+{
+    idle_timeout_ = timeout;
+}
+
+template<class Socket, std::size_t N>
+typename basic_connection_pool<Socket, N>::clock_type::duration
+basic_connection_pool<Socket, N>::idle_timeout() const
+{
+    return idle_timeout_;
+}
+
+template<class Socket, std::size_t N>
+std::size_t basic_connection_pool<Socket, N>::idle_count() const
+{
+    return idle.size();
+}
+
+template<class Socket, std::size_t N>
+std::size_t
+basic_connection_pool<Socket, N>::idle_count(const std::string &host,
+                                             const std::string &service) const
+{
+    auto it = idle_per_host.find(make_key(host, service));
+    return it == idle_per_host.end() ? 0 : it->second;
+}
+
+template<class Socket, std::size_t N>
+template<class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<
+        CompletionToken,
+        void(system::error_code,
+             typename basic_connection_pool<Socket, N>::connection_ptr)
+        >::type>::type
+basic_connection_pool<Socket, N>::async_acquire(const std::string &host,
+                                                const std::string &service,
+                                                CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code, connection_ptr)>::type
+        Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    evict_expired();
+
+    const auto key = make_key(host, service);
+    for (auto it = idle.begin() ; it != idle.end() ;) {
+        if (it->key != key) {
+            ++it;
+            continue;
+        }
+
+        auto connection = std::move(it->connection);
+        it = evict(it);
+        if (!usable(*connection))
+            continue;
+
+        io_service.post(detail::make_posted_completion
+                        (*operation_memory, std::move(handler),
+                         deliver_connection{operation_memory,
+                                            std::move(connection)},
+                         system::error_code{}));
+        return result.get();
+    }
+
+    connect(host, service, std::move(handler));
+
+    return result.get();
+}
+
+template<class Socket, std::size_t N>
+void basic_connection_pool<Socket, N>::release(const std::string &host,
+                                               const std::string &service,
+                                               connection_ptr connection)
+{
+    // Only connections at a message boundary can be reused
+    if (!connection || !connection->is_open()
+        || connection->read_state() != read_state::empty
+        || connection->write_state() != write_state::empty
+        || connection->pending_requests() != 0 || max_idle_ == 0
+        || max_idle_per_host_ == 0) {
+        return;
+    }
+
+    evict_expired();
+
+    auto key = make_key(host, service);
+    if (idle_per_host[key] == max_idle_per_host_) {
+        for (auto it = idle.end() ; it != idle.begin() ;) {
+            --it;
+            if (it->key == key) {
+                evict(it);
+                break;
+            }
+        }
+    }
+
+    if (idle.size() == max_idle_)
+        evict(std::prev(idle.end()));
+
+    ++idle_per_host[key];
+    idle.push_front(idle_connection{std::move(key), std::move(connection),
+                                    clock_type::now()});
+}
+
+template<class Socket, std::size_t N>
+template<class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_connection_pool<Socket, N>::async_prewarm(const std::string &host,
+                                                const std::string &service,
+                                                std::size_t n,
+                                                CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    evict_expired();
+
+    n = std::min(n, std::min(max_idle_per_host_, max_idle_));
+    const auto nidle = idle_count(host, service);
+
+    if (nidle >= n) {
+        io_service.post(detail::make_posted_completion
+                        (*operation_memory, std::move(handler),
+                         call_with_error{operation_memory},
+                         system::error_code{}));
+        return result.get();
+    }
+
+    // Shared by the connections (the handler is called by the last one)
+    struct state
+    {
+        explicit state(Handler &&handler)
+            : handler(std::move(handler))
+        {}
+
+        std::size_t remaining;
+        system::error_code ec;
+        Handler handler;
+    };
+
+    auto shared = std::make_shared<state>(std::move(handler));
+    shared->remaining = n - nidle;
+
+    std::weak_ptr<basic_connection_pool*> weak_self = self;
+
+    for (std::size_t i = 0 ; i != n - nidle ; ++i) {
+        connect(host, service,
+                [weak_self,host,service,shared]
+                (system::error_code ec, connection_ptr connection) mutable {
+            auto self = weak_self.lock();
+            if (!ec && !self)
+                ec = asio::error::operation_aborted;
+
+            if (ec) {
+                if (!shared->ec)
+                    shared->ec = ec;
+            } else {
+                (*self)->release(host, service, std::move(connection));
+            }
+
+            if (--shared->remaining == 0)
+                shared->handler(shared->ec);
+        });
+    }
+
+    return result.get();
+}
+
+template<class Socket, std::size_t N>
+void basic_connection_pool<Socket, N>::clear()
+{
+    idle.clear();
+    idle_per_host.clear();
+}
+
+template<class Socket, std::size_t N>
+std::string
+basic_connection_pool<Socket, N>::make_key(const std::string &host,
+                                           const std::string &service)
+{
+    return host + ':' + service;
+}
+
+template<class Socket, std::size_t N>
+bool basic_connection_pool<Socket, N>::usable(connection_type &connection)
+{
+    if (!connection.is_open())
+        return false;
+
+    /* Nothing is expected from the server between messages, so anything
+       readable is either the end of the stream or garbage that would be taken
+       as the next response (e.g. a 408 sent before closing) */
+    auto &socket = connection.next_layer();
+    system::error_code ec;
+    const bool non_blocking = socket.non_blocking();
+    socket.non_blocking(true, ec);
+    if (ec)
+        return false;
+
+    char c;
+    socket.receive(asio::buffer(&c, 1), Socket::message_peek, ec);
+    const bool ret = ec == asio::error::would_block
+        || ec == asio::error::try_again;
+
+    socket.non_blocking(non_blocking, ec);
+    return ret && !ec;
+}
+
+template<class Socket, std::size_t N>
+template<class Handler>
+void basic_connection_pool<Socket, N>::connect(const std::string &host,
+                                               const std::string &service,
+                                               Handler handler)
+{
+    typedef typename resolver_type::query query_type;
+
+    auto resolver = std::make_shared<resolver_type>(io_service);
+    connection_ptr connection(new connection_type(io_service));
+
+    resolver->async_resolve(query_type(host, service),
+                            detail::make_continuation
+                            (*operation_memory, std::move(handler),
+                             on_resolved{operation_memory, resolver,
+                                         std::move(connection)}));
+}
+
+template<class Socket, std::size_t N>
+typename std::list<
+    typename basic_connection_pool<Socket, N>::idle_connection>::iterator
+basic_connection_pool<Socket, N>
+::evict(typename std::list<idle_connection>::iterator it)
+{
+    auto count = idle_per_host.find(it->key);
+    if (--count->second == 0)
+        idle_per_host.erase(count);
+
+    return idle.erase(it);
+}
+
+template<class Socket, std::size_t N>
+void basic_connection_pool<Socket, N>::evict_expired()
+{
+    if (idle_timeout_ == clock_type::duration::zero())
+        return;
+
+    const auto deadline = clock_type::now() - idle_timeout_;
+
+    // The oldest connections live at the end of the list
+    while (idle.size() && idle.back().since < deadline)
+        evict(std::prev(idle.end()));
+}
+
+} // namespace http
+} // namespace boost
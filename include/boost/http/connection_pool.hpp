@@ -0,0 +1,206 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_CONNECTION_POOL_HPP
+#define BOOST_HTTP_CONNECTION_POOL_HPP
+
+#include <cstddef>
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <boost/asio/connect.hpp>
+
+#include <boost/http/buffered_client_socket.hpp>
+#include <boost/http/detail/handler_memory.hpp>
+
+#ifndef BOOST_HTTP_CONNECTION_POOL_DEFAULT_IDLE_TIMEOUT
+// In seconds (below the 5 seconds servers such as Apache keep idle connections)
+#define BOOST_HTTP_CONNECTION_POOL_DEFAULT_IDLE_TIMEOUT 4
+#endif // BOOST_HTTP_CONNECTION_POOL_DEFAULT_IDLE_TIMEOUT
+
+namespace boost {
+namespace http {
+
+/* Keeps idle keep-alive connections per host (`host` + `service` pair) so
+   outbound requests don't pay for a new handshake each time. Idle connections
+   are kept in LRU order: the most recently released connection is the first to
+   be reused and the least recently released one is the first to be evicted.
+   Idle connections the server closed (or sent anything on) meanwhile are
+   discarded when acquiring. */
+template<class Socket = asio::ip::tcp::socket,
+         std::size_t N = BOOST_HTTP_SOCKET_DEFAULT_BUFFER_SIZE>
+class basic_connection_pool
+{
+public:
+    typedef basic_buffered_client_socket<Socket, N> connection_type;
+    typedef std::unique_ptr<connection_type> connection_ptr;
+    typedef std::chrono::steady_clock clock_type;
+
+    explicit basic_connection_pool(asio::io_service &io_service);
+
+    basic_connection_pool(const basic_connection_pool&) = delete;
+    basic_connection_pool &operator=(const basic_connection_pool&) = delete;
+
+    // ### LIMITS ###
+
+    void set_max_idle(std::size_t max);
+    std::size_t max_idle() const;
+
+    void set_max_idle_per_host(std::size_t max);
+    std::size_t max_idle_per_host() const;
+
+    // `clock_type::duration::zero()` disables the timeout
+    void set_idle_timeout(clock_type::duration timeout);
+    clock_type::duration idle_timeout() const;
+
+    // ### END OF LIMITS ###
+
+    std::size_t idle_count() const;
+    std::size_t idle_count(const std::string &host,
+                           const std::string &service) const;
+
+    template<class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code,
+                                         connection_ptr)>::type>::type
+    async_acquire(const std::string &host, const std::string &service,
+                  CompletionToken &&token);
+
+    void release(const std::string &host, const std::string &service,
+                 connection_ptr connection);
+
+    template<class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_prewarm(const std::string &host, const std::string &service,
+                  std::size_t n, CompletionToken &&token);
+
+    void clear();
+
+private:
+    typedef typename Socket::protocol_type::resolver resolver_type;
+    typedef typename resolver_type::iterator resolver_iterator;
+    typedef std::shared_ptr<detail::handler_memory> memory_ptr;
+
+    /* The functions below hold `memory` so the operations they're attached to
+       may outlive the pool. Handlers are moved from one to the next (i.e.
+       move-only handlers work). */
+
+    // Completes a posted operation with `handler(ec)`
+    struct call_with_error
+    {
+        template<class Handler>
+        void operator()(Handler &handler, const system::error_code &ec)
+        {
+            handler(ec);
+        }
+
+        memory_ptr memory;
+    };
+
+    // Completes a posted operation with `handler(ec, connection)`
+    struct deliver_connection
+    {
+        template<class Handler>
+        void operator()(Handler &handler, const system::error_code &ec)
+        {
+            handler(ec, std::move(connection));
+        }
+
+        memory_ptr memory;
+        connection_ptr connection;
+    };
+
+    struct on_connected
+    {
+        template<class Handler>
+        void operator()(Handler &handler, const system::error_code &ec,
+                        resolver_iterator)
+        {
+            handler(ec, ec ? connection_ptr() : std::move(connection));
+        }
+
+        memory_ptr memory;
+        connection_ptr connection;
+    };
+
+    struct on_resolved
+    {
+        template<class Handler>
+        void operator()(Handler &handler, const system::error_code &ec,
+                        resolver_iterator it)
+        {
+            if (ec) {
+                handler(ec, connection_ptr());
+                return;
+            }
+
+            auto &socket = connection->next_layer();
+            asio::async_connect(socket, it,
+                                detail::make_continuation
+                                (*memory, std::move(handler),
+                                 on_connected{memory, std::move(connection)}));
+        }
+
+        memory_ptr memory;
+        std::shared_ptr<resolver_type> resolver;
+        connection_ptr connection;
+    };
+
+    struct idle_connection
+    {
+        std::string key;
+        connection_ptr connection;
+        clock_type::time_point since;
+    };
+
+    static std::string make_key(const std::string &host,
+                                const std::string &service);
+
+    // Whether the server left the idle `connection` untouched
+    static bool usable(connection_type &connection);
+
+    template<class Handler>
+    void connect(const std::string &host, const std::string &service,
+                 Handler handler);
+
+    typename std::list<idle_connection>::iterator
+    evict(typename std::list<idle_connection>::iterator it);
+
+    void evict_expired();
+
+    asio::io_service &io_service;
+
+    std::size_t max_idle_ = 64;
+    std::size_t max_idle_per_host_ = 8;
+    clock_type::duration idle_timeout_
+        = std::chrono::seconds(BOOST_HTTP_CONNECTION_POOL_DEFAULT_IDLE_TIMEOUT);
+
+    // Most recently released first
+    std::list<idle_connection> idle;
+    std::map<std::string, std::size_t> idle_per_host;
+
+    // Lets pending operations find out whether the pool is still alive
+    std::shared_ptr<basic_connection_pool*> self;
+    // Backs the internal operations (shared with them, see `call_with_error`)
+    memory_ptr operation_memory;
+};
+
+typedef basic_connection_pool<> connection_pool;
+
+} // namespace http
+} // namespace boost
+
+#include "connection_pool-inl.hpp"
+
+#endif // BOOST_HTTP_CONNECTION_POOL_HPP
@@ -0,0 +1,204 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_DETAIL_ACCEPT_ENCODING_HPP
+#define BOOST_HTTP_DETAIL_ACCEPT_ENCODING_HPP
+
+#include <algorithm>
+#include <string>
+
+#include <boost/utility/string_ref.hpp>
+#include <boost/http/algorithm/header.hpp>
+
+namespace boost {
+namespace http {
+namespace detail {
+
+// Every `name` field of `message` as a single list
+template<class Message>
+std::basic_string<typename Message::headers_type::mapped_type::value_type>
+joined_field(const Message &message, const char *name)
+{
+    std::basic_string<typename Message::headers_type::mapped_type::value_type>
+        ret;
+    auto query = message.headers().equal_range(name);
+    for (auto it = query.first ; it != query.second ; ++it) {
+        if (ret.size())
+            ret.push_back(',');
+        ret.append(it->second.begin(), it->second.end());
+    }
+    return ret;
+}
+
+// Every "accept-encoding" field of `message` as a single list
+template<class Message>
+std::basic_string<typename Message::headers_type::mapped_type::value_type>
+joined_accept_encoding(const Message &message)
+{
+    return joined_field(message, "accept-encoding");
+}
+
+/* The quality (in thousandths) `accept_encoding` gives to `coding` (-1 if
+   unlisted). `x-gzip` is listed as `gzip` and `*` is only used when `coding`
+   isn't listed. */
+template<class StringRef>
+int encoding_quality(const StringRef &accept_encoding, string_ref coding)
+{
+    typedef typename StringRef::value_type char_type;
+
+    auto iequals = [](const StringRef &a, string_ref b) {
+        if (a.size() != b.size())
+            return false;
+        for (std::size_t i = 0 ; i != a.size() ; ++i) {
+            char_type c = a[i];
+            if (c >= 'A' && c <= 'Z')
+                c = c - 'A' + 'a';
+            if (c != char_type(b[i]))
+                return false;
+        }
+        return true;
+    };
+
+    auto trim = [](StringRef v) {
+        while (v.size() && (v.front() == ' ' || v.front() == '\t'))
+            v.remove_prefix(1);
+        while (v.size() && (v.back() == ' ' || v.back() == '\t'))
+            v.remove_suffix(1);
+        return v;
+    };
+
+    // "1", "0.5", "1.000" ("q=" already skipped), -1 if invalid
+    auto parse_qvalue = [](StringRef v) {
+        if (v.empty() || (v[0] != '0' && v[0] != '1'))
+            return -1;
+        int ret = (v[0] - '0') * 1000;
+        if (v.size() == 1)
+            return ret;
+        if (v[1] != '.' || v.size() > 5)
+            return -1;
+        int scale = 100;
+        for (std::size_t i = 2 ; i != v.size() ; ++i, scale /= 10) {
+            if (v[i] < '0' || v[i] > '9')
+                return -1;
+            ret += (v[i] - '0') * scale;
+        }
+        return ret > 1000 ? -1 : ret;
+    };
+
+    int ret = -1;
+    int wildcard = -1;
+    header_value_for_each(accept_encoding, [&](const StringRef &element) {
+            auto rest = element;
+            auto semicolon = rest.find(';');
+            auto name = trim(rest.substr(0, semicolon));
+            int quality = 1000;
+
+            while (semicolon != StringRef::npos) {
+                rest = rest.substr(semicolon + 1);
+                semicolon = rest.find(';');
+                auto param = trim(rest.substr(0, semicolon));
+                if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q')
+                    && param[1] == '=') {
+                    quality = parse_qvalue(param.substr(2));
+                }
+            }
+
+            if (quality < 0)
+                return;
+
+            if (iequals(name, coding)
+                || (coding == "gzip" && iequals(name, "x-gzip"))) {
+                ret = std::max(ret, quality);
+            } else if (iequals(name, "*")) {
+                wildcard = std::max(wildcard, quality);
+            }
+        });
+
+    return ret != -1 ? ret : wildcard;
+}
+
+/* The quality an encoding needs to be preferred to the identity. Only an
+   explicit preference for the identity can beat an encoding. */
+template<class StringRef>
+int identity_threshold(const StringRef &accept_encoding)
+{
+    return std::max(encoding_quality(accept_encoding, "identity"), 1);
+}
+
+/* The entity tag of the representation encoded with `coding`, given the one
+   of the unencoded representation (`"v1"` becomes `"v1-gzip"`). Empty if
+   `etag` isn't a tag. */
+template<class String>
+std::string encoded_etag(const String &etag, string_ref coding)
+{
+    std::string ret;
+    if (etag.size() < 2 || etag.back() != '"')
+        return ret;
+
+    ret.assign(etag.begin(), etag.end() - 1);
+    ret.push_back('-');
+    ret.append(coding.begin(), coding.end());
+    ret.push_back('"');
+    return ret;
+}
+
+// Undoes `encoded_etag` (empty if `etag` doesn't name `coding`)
+template<class String>
+std::string decoded_etag(const String &etag, string_ref coding)
+{
+    if (etag.size() < coding.size() + 3 || etag.back() != '"')
+        return std::string();
+
+    std::string ret(etag.begin(), etag.end());
+    auto pos = ret.size() - coding.size() - 2;
+    if (ret[pos] != '-' || ret.compare(pos + 1, coding.size(), coding.data(),
+                                       coding.size())) {
+        return std::string();
+    }
+
+    ret.erase(pos, coding.size() + 1);
+    return ret;
+}
+
+/* Undoes `encoded_etag` on every tag of the list `etags` (e.g. the value of
+   an "if-none-match" field). Empty if no tag names `coding`. */
+template<class String>
+std::string decoded_etags(const String &etags, string_ref coding)
+{
+    std::string suffix = '-' + std::string(coding.begin(), coding.end()) + '"';
+
+    std::string ret;
+    bool decoded = false;
+    auto it = etags.begin();
+    while (it != etags.end()) {
+        if (std::size_t(etags.end() - it) >= suffix.size()
+            && std::equal(suffix.begin(), suffix.end(), it)) {
+            decoded = true;
+            it += suffix.size() - 1;
+            continue;
+        }
+        ret.push_back(*it++);
+    }
+
+    if (!decoded)
+        ret.clear();
+    return ret;
+}
+
+/* Replaces the field `position` points to with `name: value`. It's erased and
+   inserted again, as the values might be read-only (e.g. `arena_headers`). */
+template<class Headers, class Iterator>
+void replace_field(Headers &headers, Iterator position, const char *name,
+                   const std::string &value)
+{
+    headers.erase(position);
+    headers.emplace(name, value);
+}
+
+} // namespace detail
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_DETAIL_ACCEPT_ENCODING_HPP
@@ -0,0 +1,150 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_DETAIL_CHAR_CLASS_HPP
+#define BOOST_HTTP_DETAIL_CHAR_CLASS_HPP
+
+#include <boost/preprocessor/repetition/enum.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+
+namespace boost {
+namespace http {
+namespace detail {
+
+/* Every character class used by the HTTP grammar is a bit in a single 256-entry
+   table, so testing a byte against any union of classes is one load and one
+   mask. */
+struct char_class
+{
+    enum value
+    {
+        /* ALPHA          =  %x41-5A / %x61-7A   ; A-Z / a-z
+
+           from Appendix B of RFC5234. */
+        alpha = 1 << 0,
+        /* DIGIT          =  %x30-39   ; 0-9
+
+           from Appendix B of RFC5234. */
+        digit = 1 << 1,
+        /* HEXDIG         =  DIGIT / "A" / "B" / "C" / "D" / "E" / "F"
+
+           from Appendix B of RFC5234 (but case-insensitive). */
+        hexdig = 1 << 2,
+        /* tchar          = "!" / "#" / "$" / "%" / "&" / "'" / "*"
+                          / "+" / "-" / "." / "^" / "_" / "`" / "|" / "~"
+                          / DIGIT / ALPHA
+                          ; any VCHAR, except delimiters
+
+           from section 3.2.6 of RFC7230. */
+        tchar = 1 << 3,
+        /* pchar / "/" / "?" as used by origin-form, absolute-form and
+           authority-form (sections 5.3.1 to 5.3.3 of RFC7230 and section 3.3
+           of RFC3986). */
+        request_target = 1 << 4,
+        /* VCHAR          =  %x21-7E
+
+           from Appendix B of RFC5234. */
+        vchar = 1 << 5,
+        /* obs-text       = %x80-FF
+
+           from section 3.2.6 of RFC7230. */
+        obs_text = 1 << 6,
+        /* OWS            = *( SP / HTAB )
+
+           from section 3.2.3 of RFC7230. */
+        ows = 1 << 7,
+
+        alnum = alpha | digit,
+        // field-vchar / OWS. Also describes reason-phrase and chunk-ext.
+        field_value = vchar | obs_text | ows
+    };
+};
+
+#define BOOST_HTTP_DETAIL_CC_IN(c, a, b) ((c) >= (a) && (c) <= (b))
+
+#define BOOST_HTTP_DETAIL_CC_ALPHA(c)                                         \
+    (BOOST_HTTP_DETAIL_CC_IN(c, 0x41, 0x5A)                                   \
+     || BOOST_HTTP_DETAIL_CC_IN(c, 0x61, 0x7A))
+
+#define BOOST_HTTP_DETAIL_CC_DIGIT(c) BOOST_HTTP_DETAIL_CC_IN(c, 0x30, 0x39)
+
+#define BOOST_HTTP_DETAIL_CC_HEXDIG(c)                                        \
+    (BOOST_HTTP_DETAIL_CC_DIGIT(c) || BOOST_HTTP_DETAIL_CC_IN(c, 'A', 'F')    \
+     || BOOST_HTTP_DETAIL_CC_IN(c, 'a', 'f'))
+
+#define BOOST_HTTP_DETAIL_CC_ALNUM(c)                                         \
+    (BOOST_HTTP_DETAIL_CC_ALPHA(c) || BOOST_HTTP_DETAIL_CC_DIGIT(c))
+
+#define BOOST_HTTP_DETAIL_CC_TCHAR(c)                                         \
+    (BOOST_HTTP_DETAIL_CC_ALNUM(c) || (c) == '!' || (c) == '#' || (c) == '$'  \
+     || (c) == '%' || (c) == '&' || (c) == '\'' || (c) == '*' || (c) == '+'   \
+     || (c) == '-' || (c) == '.' || (c) == '^' || (c) == '_' || (c) == '`'    \
+     || (c) == '|' || (c) == '~')
+
+#define BOOST_HTTP_DETAIL_CC_REQUEST_TARGET(c)                                \
+    (BOOST_HTTP_DETAIL_CC_ALNUM(c) || (c) == '?' || (c) == '/' || (c) == '-'  \
+     || (c) == '.' || (c) == '_' || (c) == '~' || (c) == '%' || (c) == '!'    \
+     || (c) == '$' || (c) == '&' || (c) == '\'' || (c) == '(' || (c) == ')'   \
+     || (c) == '*' || (c) == '+' || (c) == ',' || (c) == ';' || (c) == '='    \
+     || (c) == ':' || (c) == '@')
+
+#define BOOST_HTTP_DETAIL_CC_ENTRY(z, c, data)                                \
+    static_cast<unsigned char>(                                               \
+        (BOOST_HTTP_DETAIL_CC_ALPHA(c) ? char_class::alpha : 0)               \
+        | (BOOST_HTTP_DETAIL_CC_DIGIT(c) ? char_class::digit : 0)             \
+        | (BOOST_HTTP_DETAIL_CC_HEXDIG(c) ? char_class::hexdig : 0)           \
+        | (BOOST_HTTP_DETAIL_CC_TCHAR(c) ? char_class::tchar : 0)             \
+        | (BOOST_HTTP_DETAIL_CC_REQUEST_TARGET(c)                             \
+           ? char_class::request_target : 0)                                  \
+        | (BOOST_HTTP_DETAIL_CC_IN(c, 0x21, 0x7E) ? char_class::vchar : 0)    \
+        | ((c) >= 0x80 ? char_class::obs_text : 0)                            \
+        | ((c) == 0x20 || (c) == 0x09 ? char_class::ows : 0))
+
+template<class Tag = void>
+struct basic_char_class_table
+{
+    static const unsigned char value[256];
+};
+
+/* Generated by the preprocessor from the definitions above so the table and
+   the grammar can't drift apart. */
+template<class Tag>
+const unsigned char basic_char_class_table<Tag>::value[256] = {
+    BOOST_PP_ENUM(256, BOOST_HTTP_DETAIL_CC_ENTRY, ~)
+};
+
+#undef BOOST_HTTP_DETAIL_CC_ENTRY
+#undef BOOST_HTTP_DETAIL_CC_REQUEST_TARGET
+#undef BOOST_HTTP_DETAIL_CC_TCHAR
+#undef BOOST_HTTP_DETAIL_CC_ALNUM
+#undef BOOST_HTTP_DETAIL_CC_HEXDIG
+#undef BOOST_HTTP_DETAIL_CC_DIGIT
+#undef BOOST_HTTP_DETAIL_CC_ALPHA
+#undef BOOST_HTTP_DETAIL_CC_IN
+
+typedef basic_char_class_table<> char_class_table;
+
+inline bool has_char_class(unsigned char c, unsigned mask)
+{
+    return (char_class_table::value[c] & mask) != 0;
+}
+
+/* Wider character types (and negative values of signed ones) are first
+   converted to the unsigned type so `char` and `unsigned char` views agree and
+   code points above 0xFF belong to no class. */
+template<class CharT>
+bool has_char_class(CharT c, unsigned mask)
+{
+    typedef typename boost::make_unsigned<CharT>::type unsigned_type;
+    unsigned_type u = static_cast<unsigned_type>(c);
+    return u <= 0xFF && has_char_class(static_cast<unsigned char>(u), mask);
+}
+
+} // namespace detail
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_DETAIL_CHAR_CLASS_HPP
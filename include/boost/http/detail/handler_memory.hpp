@@ -0,0 +1,550 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_DETAIL_HANDLER_MEMORY_HPP
+#define BOOST_HTTP_DETAIL_HANDLER_MEMORY_HPP
+
+#include <cstddef>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <boost/system/error_code.hpp>
+#include <boost/asio/handler_alloc_hook.hpp>
+#include <boost/asio/handler_continuation_hook.hpp>
+#include <boost/asio/handler_invoke_hook.hpp>
+#include <boost/asio/detail/handler_cont_helpers.hpp>
+#include <boost/asio/detail/handler_invoke_helpers.hpp>
+
+namespace boost {
+namespace http {
+namespace detail {
+
+/* Recycles the memory used by the internal operations of one connection.
+   Operations of the same kind always ask for blocks of the same size, so once
+   every kind ran once, the blocks released by completed operations serve the
+   next ones and a keep-alive connection stops hitting the heap.
+
+   A read and a write of the same connection can complete concurrently on a
+   multi-threaded `io_service` (ASIO releases the operation's memory on the
+   completing thread before any strand is entered), so the free list is
+   guarded by a mutex. */
+class handler_memory
+{
+public:
+    handler_memory() = default;
+
+    handler_memory(const handler_memory&) = delete;
+    handler_memory &operator=(const handler_memory&) = delete;
+
+    ~handler_memory()
+    {
+        for (std::size_t i = 0 ; i != nfree ; ++i)
+            ::operator delete(free_blocks[i].pointer);
+    }
+
+    void *allocate(std::size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (std::size_t i = 0 ; i != nfree ; ++i) {
+                if (free_blocks[i].size != size)
+                    continue;
+
+                void *pointer = free_blocks[i].pointer;
+                free_blocks[i] = free_blocks[--nfree];
+                return pointer;
+            }
+        }
+
+        return ::operator new(size);
+    }
+
+    void deallocate(void *pointer, std::size_t size)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (nfree != free_blocks.size()) {
+                free_blocks[nfree].pointer = pointer;
+                free_blocks[nfree].size = size;
+                ++nfree;
+                return;
+            }
+        }
+
+        ::operator delete(pointer);
+    }
+
+private:
+    struct block
+    {
+        void *pointer;
+        std::size_t size;
+    };
+
+    std::mutex mutex;
+    std::array<block, 8> free_blocks;
+    std::size_t nfree = 0;
+};
+
+/* Wraps an internal completion handler so ASIO allocates the operation
+   (and everything stacked over it) from `memory`. */
+template<class Handler>
+struct recycling_handler
+{
+    template<class... Args>
+    void operator()(Args&&... args)
+    {
+        handler(std::forward<Args>(args)...);
+    }
+
+    handler_memory *memory;
+    Handler handler;
+};
+
+template<class Handler>
+recycling_handler<typename std::decay<Handler>::type>
+make_recycling_handler(handler_memory &memory, Handler &&handler)
+{
+    return {&memory, std::forward<Handler>(handler)};
+}
+
+template<class Handler>
+void *asio_handler_allocate(std::size_t size,
+                            recycling_handler<Handler> *this_handler)
+{
+    return this_handler->memory->allocate(size);
+}
+
+template<class Handler>
+void asio_handler_deallocate(void *pointer, std::size_t size,
+                             recycling_handler<Handler> *this_handler)
+{
+    this_handler->memory->deallocate(pointer, size);
+}
+
+template<class Function, class Handler>
+void asio_handler_invoke(Function &function,
+                         recycling_handler<Handler> *this_handler)
+{
+    boost_asio_handler_invoke_helpers::invoke(function,
+                                              this_handler->handler);
+}
+
+template<class Function, class Handler>
+void asio_handler_invoke(const Function &function,
+                         recycling_handler<Handler> *this_handler)
+{
+    boost_asio_handler_invoke_helpers::invoke(function,
+                                              this_handler->handler);
+}
+
+template<class Handler>
+bool asio_handler_is_continuation(recycling_handler<Handler> *this_handler)
+{
+    return boost_asio_handler_cont_helpers
+        ::is_continuation(this_handler->handler);
+}
+
+/* Continuation of an operation started on behalf of the user's `handler`.
+   ASIO allocates it from `memory` (as in `recycling_handler`) but invokes it
+   through `handler`'s hooks. `function` receives `handler` as its first
+   argument, so the handler is moved from one continuation to the next instead
+   of being copied (i.e. move-only handlers work and the reference counts held
+   by handlers such as `yield_context` aren't touched). */
+template<class Handler, class Function>
+struct continuation
+{
+    template<class... Args>
+    void operator()(Args&&... args)
+    {
+        function(handler, std::forward<Args>(args)...);
+    }
+
+    handler_memory *memory;
+    Handler handler;
+    Function function;
+};
+
+template<class Handler, class Function>
+continuation<typename std::decay<Handler>::type, Function>
+make_continuation(handler_memory &memory, Handler &&handler, Function function)
+{
+    return {&memory, std::forward<Handler>(handler), std::move(function)};
+}
+
+template<class Handler, class Function>
+void *asio_handler_allocate(std::size_t size,
+                            continuation<Handler, Function> *this_handler)
+{
+    return this_handler->memory->allocate(size);
+}
+
+template<class Handler, class Function>
+void asio_handler_deallocate(void *pointer, std::size_t size,
+                             continuation<Handler, Function> *this_handler)
+{
+    this_handler->memory->deallocate(pointer, size);
+}
+
+template<class F, class Handler, class Function>
+void asio_handler_invoke(F &function,
+                         continuation<Handler, Function> *this_handler)
+{
+    boost_asio_handler_invoke_helpers::invoke(function,
+                                              this_handler->handler);
+}
+
+template<class F, class Handler, class Function>
+void asio_handler_invoke(const F &function,
+                         continuation<Handler, Function> *this_handler)
+{
+    boost_asio_handler_invoke_helpers::invoke(function,
+                                              this_handler->handler);
+}
+
+template<class Handler, class Function>
+bool
+asio_handler_is_continuation(continuation<Handler, Function> *this_handler)
+{
+    return boost_asio_handler_cont_helpers
+        ::is_continuation(this_handler->handler);
+}
+
+/* A `void(system::error_code)` completion handler stored in `handler_memory`.
+   Nodes form intrusive singly-linked lists, so queueing them doesn't allocate
+   either. */
+class completion
+{
+public:
+    // Releases the node before the upcall (so the handler can reuse it)
+    virtual void complete(const system::error_code &ec) = 0;
+
+    // Releases the node without calling the handler
+    virtual void destroy() = 0;
+
+    completion *next = nullptr;
+
+protected:
+    ~completion() = default;
+};
+
+// Calls `function(handler, ec)` (`handler` is moved, never copied)
+template<class Handler, class Function>
+class completion_impl: public completion
+{
+public:
+    template<class H>
+    completion_impl(handler_memory &memory, H &&handler, Function function)
+        : memory(memory)
+        , handler(std::forward<H>(handler))
+        , function(std::move(function))
+    {}
+
+    void complete(const system::error_code &ec) override
+    {
+        Handler handler(std::move(this->handler));
+        Function function(std::move(this->function));
+        release();
+        function(handler, ec);
+    }
+
+    /* The handler might own `memory` (e.g. through the connection), so it's
+       only destroyed once the node is released */
+    void destroy() override
+    {
+        Handler handler(std::move(this->handler));
+        Function function(std::move(this->function));
+        release();
+    }
+
+private:
+    void release()
+    {
+        handler_memory &memory = this->memory;
+        this->~completion_impl();
+        memory.deallocate(this, sizeof(completion_impl));
+    }
+
+    template<class, class> friend class posted_completion;
+
+    handler_memory &memory;
+    Handler handler;
+    Function function;
+};
+
+struct call_with_error
+{
+    template<class Handler>
+    void operator()(Handler &handler, const system::error_code &ec) const
+    {
+        handler(ec);
+    }
+};
+
+template<class Handler, class Function>
+completion_impl<typename std::decay<Handler>::type, Function>*
+make_completion(handler_memory &memory, Handler &&handler, Function function)
+{
+    typedef completion_impl<typename std::decay<Handler>::type, Function>
+        impl_type;
+
+    void *pointer = memory.allocate(sizeof(impl_type));
+    try {
+        return new (pointer) impl_type(memory, std::forward<Handler>(handler),
+                                       std::move(function));
+    } catch(...) {
+        memory.deallocate(pointer, sizeof(impl_type));
+        throw;
+    }
+}
+
+template<class Handler>
+completion_impl<typename std::decay<Handler>::type, call_with_error>*
+make_completion(handler_memory &memory, Handler &&handler)
+{
+    return make_completion(memory, std::forward<Handler>(handler),
+                           call_with_error{});
+}
+
+/* Handle to post a `completion_impl` (ASIO's `post` wants copyable handlers
+   even if it only moves them around). Copies transfer the ownership of the
+   node (ASIO only keeps the last one alive), so move-only handlers can be
+   posted too. An unused node is destroyed with the handle. */
+template<class Handler, class Function>
+class posted_completion
+{
+public:
+    posted_completion(handler_memory &memory,
+                      completion_impl<Handler, Function> *node,
+                      const system::error_code &ec)
+        : memory(&memory)
+        , node(node)
+        , ec(ec)
+    {}
+
+    posted_completion(const posted_completion &o)
+        : memory(o.memory)
+        , node(o.node)
+        , ec(o.ec)
+    {
+        o.node = nullptr;
+    }
+
+    posted_completion &operator=(const posted_completion&) = delete;
+
+    ~posted_completion()
+    {
+        if (node)
+            node->destroy();
+    }
+
+    void operator()()
+    {
+        auto node = this->node;
+        this->node = nullptr;
+        node->complete(ec);
+    }
+
+    Handler &handler() const
+    {
+        return node->handler;
+    }
+
+    // Not taken from `node` (ASIO deallocates after destroying the handler)
+    handler_memory *memory;
+
+private:
+    mutable completion_impl<Handler, Function> *node;
+    system::error_code ec;
+};
+
+template<class Handler>
+posted_completion<typename std::decay<Handler>::type, call_with_error>
+make_posted_completion(handler_memory &memory, Handler &&handler,
+                       const system::error_code &ec)
+{
+    return {memory, make_completion(memory, std::forward<Handler>(handler)),
+            ec};
+}
+
+// Completes with `function(handler, ec)`
+template<class Handler, class Function>
+posted_completion<typename std::decay<Handler>::type, Function>
+make_posted_completion(handler_memory &memory, Handler &&handler,
+                       Function function, const system::error_code &ec)
+{
+    return {memory,
+            make_completion(memory, std::forward<Handler>(handler),
+                            std::move(function)),
+            ec};
+}
+
+template<class Handler, class Function>
+void *asio_handler_allocate(std::size_t size,
+                            posted_completion<Handler, Function> *this_handler)
+{
+    return this_handler->memory->allocate(size);
+}
+
+template<class Handler, class Function>
+void asio_handler_deallocate(void *pointer, std::size_t size,
+                             posted_completion<Handler, Function>
+                             *this_handler)
+{
+    this_handler->memory->deallocate(pointer, size);
+}
+
+template<class F, class Handler, class Function>
+void asio_handler_invoke(F &function,
+                         posted_completion<Handler, Function> *this_handler)
+{
+    boost_asio_handler_invoke_helpers::invoke(function,
+                                              this_handler->handler());
+}
+
+template<class F, class Handler, class Function>
+void asio_handler_invoke(const F &function,
+                         posted_completion<Handler, Function> *this_handler)
+{
+    boost_asio_handler_invoke_helpers::invoke(function,
+                                              this_handler->handler());
+}
+
+template<class Handler, class Function>
+bool asio_handler_is_continuation(posted_completion<Handler, Function>
+                                  *this_handler)
+{
+    return boost_asio_handler_cont_helpers
+        ::is_continuation(this_handler->handler());
+}
+
+// FIFO of `completion` nodes
+class completion_queue
+{
+public:
+    completion_queue() = default;
+
+    completion_queue(const completion_queue&) = delete;
+    completion_queue &operator=(const completion_queue&) = delete;
+
+    ~completion_queue()
+    {
+        for (auto node = release() ; node ;) {
+            auto next = node->next;
+            node->destroy();
+            node = next;
+        }
+    }
+
+    bool empty() const
+    {
+        return head == nullptr;
+    }
+
+    void push(completion *node)
+    {
+        node->next = nullptr;
+        if (tail)
+            tail->next = node;
+        else
+            head = node;
+        tail = node;
+    }
+
+    completion *back() const
+    {
+        return tail;
+    }
+
+    // Moves the nodes after `node` to `o` (which MUST be empty)
+    void split_after(completion *node, completion_queue &o)
+    {
+        o.head = node->next;
+        o.tail = o.head ? tail : nullptr;
+        node->next = nullptr;
+        tail = node;
+    }
+
+    void swap(completion_queue &o)
+    {
+        std::swap(head, o.head);
+        std::swap(tail, o.tail);
+    }
+
+    // Detaches every node (returning the first one)
+    completion *release()
+    {
+        auto node = head;
+        head = tail = nullptr;
+        return node;
+    }
+
+    /* Completes a list detached with `release`. Only the list is touched
+       between upcalls, so handlers may destroy the queue's owner. */
+    static void complete_all(completion *node, const system::error_code &ec)
+    {
+        while (node) {
+            auto next = node->next;
+            node->complete(ec);
+            node = next;
+        }
+    }
+
+private:
+    completion *head = nullptr;
+    completion *tail = nullptr;
+};
+
+struct completion_deleter
+{
+    void operator()(completion *node) const
+    {
+        node->destroy();
+    }
+};
+
+// Owning pointer to a `completion` not yet queued
+typedef std::unique_ptr<completion, completion_deleter> completion_ptr;
+
+/* A `ConstBufferSequence` referring to buffers stored elsewhere. ASIO copies
+   buffer sequences into its operations, so this keeps gathered writes from
+   copying (and allocating) the whole buffer vector. */
+template<class Buffer>
+class buffers_view
+{
+public:
+    typedef Buffer value_type;
+    typedef const Buffer *const_iterator;
+
+    buffers_view(const_iterator first, const_iterator last)
+        : first(first)
+        , last(last)
+    {}
+
+    const_iterator begin() const
+    {
+        return first;
+    }
+
+    const_iterator end() const
+    {
+        return last;
+    }
+
+private:
+    const_iterator first;
+    const_iterator last;
+};
+
+} // namespace detail
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_DETAIL_HANDLER_MEMORY_HPP
@@ -0,0 +1,56 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_DETAIL_NATIVE_IO_HPP
+#define BOOST_HTTP_DETAIL_NATIVE_IO_HPP
+
+/* Zero-copy paths and file watching built on native system calls. Define
+   `BOOST_HTTP_NO_SPLICE`, `BOOST_HTTP_NO_SENDFILE`, `BOOST_HTTP_NO_MMAP` or
+   `BOOST_HTTP_NO_INOTIFY` to leave them out. */
+#if defined(__linux__)
+# if !defined(BOOST_HTTP_NO_SPLICE)
+#  define BOOST_HTTP_DETAIL_HAS_SPLICE 1
+# endif
+# if !defined(BOOST_HTTP_NO_SENDFILE)
+#  define BOOST_HTTP_DETAIL_HAS_SENDFILE 1
+# endif
+# if !defined(BOOST_HTTP_NO_INOTIFY)
+#  define BOOST_HTTP_DETAIL_HAS_INOTIFY 1
+# endif
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+# define BOOST_HTTP_DETAIL_HAS_STAT 1
+# if !defined(BOOST_HTTP_NO_MMAP)
+#  define BOOST_HTTP_DETAIL_HAS_MMAP 1
+# endif
+#endif
+
+#if defined(BOOST_HTTP_DETAIL_HAS_SPLICE) \
+    || defined(BOOST_HTTP_DETAIL_HAS_SENDFILE) \
+    || defined(BOOST_HTTP_DETAIL_HAS_MMAP) \
+    || defined(BOOST_HTTP_DETAIL_HAS_INOTIFY)
+# include <cerrno>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+#ifdef BOOST_HTTP_DETAIL_HAS_SENDFILE
+# include <sys/sendfile.h>
+#endif
+
+#ifdef BOOST_HTTP_DETAIL_HAS_STAT
+# include <sys/stat.h>
+#endif
+
+#ifdef BOOST_HTTP_DETAIL_HAS_MMAP
+# include <sys/mman.h>
+#endif
+
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+# include <sys/inotify.h>
+#endif
+
+#endif // BOOST_HTTP_DETAIL_NATIVE_IO_HPP
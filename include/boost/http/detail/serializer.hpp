@@ -0,0 +1,125 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_DETAIL_SERIALIZER_HPP
+#define BOOST_HTTP_DETAIL_SERIALIZER_HPP
+
+#include <cstdint>
+#include <string>
+
+#include <boost/utility/string_ref.hpp>
+
+#include <boost/http/detail/status_line.hpp>
+
+namespace boost {
+namespace http {
+namespace detail {
+
+/* Helpers to render message metadata into a contiguous staging buffer. The
+   buffer is owned by the connection and only cleared between messages, so once
+   it has grown to fit the usual responses no more allocations happen. */
+
+template<std::size_t N>
+void append_literal(std::string &out, const char (&input)[N])
+{
+    out.append(input, N - 1);
+}
+
+inline void append_decimal(std::string &out, std::uint_least64_t value)
+{
+    char buf[20];
+    char *const end = buf + sizeof(buf);
+    char *it = end;
+
+    do {
+        *--it = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    out.append(it, end);
+}
+
+/* chunk-size = 1*HEXDIG
+
+   from section 4.1 of RFC7230. */
+inline void append_hex(std::string &out, std::uint_least64_t value)
+{
+    char buf[16];
+    char *const end = buf + sizeof(buf);
+    char *it = end;
+
+    do {
+        *--it = "0123456789abcdef"[value % 16];
+        value /= 16;
+    } while (value);
+
+    out.append(it, end);
+}
+
+/* status-line = HTTP-version SP status-code SP reason-phrase CRLF
+
+   from section 3.1.2 of RFC7230. */
+template<class String>
+void append_status_line(std::string &out, bool modern_http,
+                        std::uint_least16_t status_code,
+                        const String &reason_phrase)
+{
+    if (modern_http)
+        append_literal(out, "HTTP/1.1 ");
+    else
+        append_literal(out, "HTTP/1.0 ");
+
+    string_ref reason(reason_phrase.data(), reason_phrase.size());
+    string_ref line = status_line(status_code);
+
+    if (line.size() && status_line_reason(line) == reason) {
+        out.append(line.data(), line.size());
+        return;
+    }
+
+    append_decimal(out, status_code);
+    out.push_back(' ');
+    out.append(reason.data(), reason.size());
+    append_literal(out, "\r\n");
+}
+
+/* request-line = method SP request-target SP HTTP-version CRLF
+
+   from section 3.1.1 of RFC7230. */
+template<class String>
+void append_request_line(std::string &out, const String &method,
+                         const String &target)
+{
+    out.append(method.data(), method.size());
+    out.push_back(' ');
+    out.append(target.data(), target.size());
+    append_literal(out, " HTTP/1.1\r\n");
+}
+
+template<class Headers>
+void append_headers(std::string &out, const Headers &headers)
+{
+    for (const auto &header: headers) {
+        out.append(header.first.data(), header.first.size());
+        append_literal(out, ": ");
+        out.append(header.second.data(), header.second.size());
+        append_literal(out, "\r\n");
+    }
+}
+
+template<class Body>
+void append_body(std::string &out, const Body &body)
+{
+    if (body.size() == 0)
+        return;
+
+    out.append(reinterpret_cast<const char*>(&body[0]), body.size());
+}
+
+} // namespace detail
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_DETAIL_SERIALIZER_HPP
@@ -0,0 +1,92 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_DETAIL_SLOT_RING_HPP
+#define BOOST_HTTP_DETAIL_SLOT_RING_HPP
+
+#include <cstddef>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace boost {
+namespace http {
+namespace detail {
+
+/* FIFO whose elements survive `pop_front` and are handed out again by
+   `push_back`, so whatever they own (e.g. a string's capacity) serves the
+   next ones. Elements never move (a reference stays valid until the element
+   is popped). Only the ring of pointers grows, and only when it's full. */
+template<class T>
+class slot_ring
+{
+public:
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    T &operator[](std::size_t i)
+    {
+        return *slots[(head + i) % slots.size()];
+    }
+
+    const T &operator[](std::size_t i) const
+    {
+        return *slots[(head + i) % slots.size()];
+    }
+
+    T &front()
+    {
+        return (*this)[0];
+    }
+
+    const T &front() const
+    {
+        return (*this)[0];
+    }
+
+    T &back()
+    {
+        return (*this)[size_ - 1];
+    }
+
+    // Returns the new last element as it was left when popped
+    T &push_back()
+    {
+        if (size_ == slots.size()) {
+            // Unwrapped first, so the new slot follows the last element
+            std::rotate(slots.begin(), slots.begin() + head, slots.end());
+            head = 0;
+            slots.emplace_back(new T);
+        }
+
+        ++size_;
+        return back();
+    }
+
+    void pop_front()
+    {
+        head = (head + 1) % slots.size();
+        --size_;
+    }
+
+private:
+    std::vector<std::unique_ptr<T>> slots;
+    std::size_t head = 0;
+    std::size_t size_ = 0;
+};
+
+} // namespace detail
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_DETAIL_SLOT_RING_HPP
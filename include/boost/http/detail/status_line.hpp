@@ -0,0 +1,105 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_DETAIL_STATUS_LINE_HPP
+#define BOOST_HTTP_DETAIL_STATUS_LINE_HPP
+
+#include <cstdint>
+
+#include <boost/utility/string_ref.hpp>
+
+namespace boost {
+namespace http {
+namespace detail {
+
+/* Returns the pre-rendered `status-code SP reason-phrase CRLF` tail of the
+   status line for every code listed in `status_code` (e.g. "404 Not Found\r\n")
+   or an empty view for unknown codes. The reason phrases are the same ones
+   returned by `to_string(status_code)`. */
+inline string_ref status_line(std::uint_least16_t code)
+{
+#define BOOST_HTTP_DETAIL_STATUS_LINE(code, reason)                           \
+    case code:                                                                \
+        return string_ref(#code " " reason "\r\n",                            \
+                          sizeof(#code " " reason "\r\n") - 1);
+
+    switch (code) {
+    BOOST_HTTP_DETAIL_STATUS_LINE(100, "Continue")
+    BOOST_HTTP_DETAIL_STATUS_LINE(101, "Switching Protocols")
+    BOOST_HTTP_DETAIL_STATUS_LINE(102, "Processing")
+    BOOST_HTTP_DETAIL_STATUS_LINE(200, "OK")
+    BOOST_HTTP_DETAIL_STATUS_LINE(201, "Created")
+    BOOST_HTTP_DETAIL_STATUS_LINE(202, "Accepted")
+    BOOST_HTTP_DETAIL_STATUS_LINE(203, "Non-Authoritative Information")
+    BOOST_HTTP_DETAIL_STATUS_LINE(204, "No Content")
+    BOOST_HTTP_DETAIL_STATUS_LINE(205, "Reset Content")
+    BOOST_HTTP_DETAIL_STATUS_LINE(206, "Partial Content")
+    BOOST_HTTP_DETAIL_STATUS_LINE(207, "Multi-Status")
+    BOOST_HTTP_DETAIL_STATUS_LINE(208, "Already Reported")
+    BOOST_HTTP_DETAIL_STATUS_LINE(226, "IM Used")
+    BOOST_HTTP_DETAIL_STATUS_LINE(300, "Multiple Choices")
+    BOOST_HTTP_DETAIL_STATUS_LINE(301, "Moved Permanently")
+    BOOST_HTTP_DETAIL_STATUS_LINE(302, "Found")
+    BOOST_HTTP_DETAIL_STATUS_LINE(303, "See Other")
+    BOOST_HTTP_DETAIL_STATUS_LINE(304, "Not Modified")
+    BOOST_HTTP_DETAIL_STATUS_LINE(305, "Use Proxy")
+    BOOST_HTTP_DETAIL_STATUS_LINE(306, "Switch Proxy")
+    BOOST_HTTP_DETAIL_STATUS_LINE(307, "Temporary Redirect")
+    BOOST_HTTP_DETAIL_STATUS_LINE(308, "Permanent Redirect")
+    BOOST_HTTP_DETAIL_STATUS_LINE(400, "Bad Request")
+    BOOST_HTTP_DETAIL_STATUS_LINE(401, "Unauthorized")
+    BOOST_HTTP_DETAIL_STATUS_LINE(402, "Payment Required")
+    BOOST_HTTP_DETAIL_STATUS_LINE(403, "Forbidden")
+    BOOST_HTTP_DETAIL_STATUS_LINE(404, "Not Found")
+    BOOST_HTTP_DETAIL_STATUS_LINE(405, "Method Not Allowed")
+    BOOST_HTTP_DETAIL_STATUS_LINE(406, "Not Acceptable")
+    BOOST_HTTP_DETAIL_STATUS_LINE(407, "Proxy Authentication Required")
+    BOOST_HTTP_DETAIL_STATUS_LINE(408, "Request Timeout")
+    BOOST_HTTP_DETAIL_STATUS_LINE(409, "Conflict")
+    BOOST_HTTP_DETAIL_STATUS_LINE(410, "Gone")
+    BOOST_HTTP_DETAIL_STATUS_LINE(411, "Length Required")
+    BOOST_HTTP_DETAIL_STATUS_LINE(412, "Precondition Failed")
+    BOOST_HTTP_DETAIL_STATUS_LINE(413, "Payload Too Large")
+    BOOST_HTTP_DETAIL_STATUS_LINE(414, "URI Too Long")
+    BOOST_HTTP_DETAIL_STATUS_LINE(415, "Unsupported Media Type")
+    BOOST_HTTP_DETAIL_STATUS_LINE(416, "Requested Range Not Satisfiable")
+    BOOST_HTTP_DETAIL_STATUS_LINE(417, "Expectation Failed")
+    BOOST_HTTP_DETAIL_STATUS_LINE(422, "Unprocessable Entity")
+    BOOST_HTTP_DETAIL_STATUS_LINE(423, "Locked")
+    BOOST_HTTP_DETAIL_STATUS_LINE(424, "Failed Dependency")
+    BOOST_HTTP_DETAIL_STATUS_LINE(426, "Upgrade Required")
+    BOOST_HTTP_DETAIL_STATUS_LINE(428, "Precondition Required")
+    BOOST_HTTP_DETAIL_STATUS_LINE(429, "Too Many Requests")
+    BOOST_HTTP_DETAIL_STATUS_LINE(431, "Request Header Fields Too Large")
+    BOOST_HTTP_DETAIL_STATUS_LINE(500, "Internal Server Error")
+    BOOST_HTTP_DETAIL_STATUS_LINE(501, "Not Implemented")
+    BOOST_HTTP_DETAIL_STATUS_LINE(502, "Bad Gateway")
+    BOOST_HTTP_DETAIL_STATUS_LINE(503, "Service Unavailable")
+    BOOST_HTTP_DETAIL_STATUS_LINE(504, "Gateway Timeout")
+    BOOST_HTTP_DETAIL_STATUS_LINE(505, "HTTP Version Not Supported")
+    BOOST_HTTP_DETAIL_STATUS_LINE(506, "Variant Also Negotiates")
+    BOOST_HTTP_DETAIL_STATUS_LINE(507, "Insufficient Storage")
+    BOOST_HTTP_DETAIL_STATUS_LINE(508, "Loop Detected")
+    BOOST_HTTP_DETAIL_STATUS_LINE(510, "Not Extended")
+    BOOST_HTTP_DETAIL_STATUS_LINE(511, "Network Authentication Required")
+    default:
+        return string_ref();
+    }
+
+#undef BOOST_HTTP_DETAIL_STATUS_LINE
+}
+
+/* The reason phrase inside a line returned by `status_line()` (i.e. without
+   the "NNN " prefix and the CRLF suffix). */
+inline string_ref status_line_reason(string_ref line)
+{
+    return line.substr(4, line.size() - 6);
+}
+
+} // namespace detail
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_DETAIL_STATUS_LINE_HPP
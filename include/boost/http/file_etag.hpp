@@ -0,0 +1,199 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_FILE_ETAG_HPP
+#define BOOST_HTTP_FILE_ETAG_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/http/file_metadata_cache.hpp>
+#include <boost/http/detail/singleton.hpp>
+
+#ifndef BOOST_HTTP_FILE_ETAG_CACHE_MAX_SIZE
+#define BOOST_HTTP_FILE_ETAG_CACHE_MAX_SIZE 1024
+#endif // BOOST_HTTP_FILE_ETAG_CACHE_MAX_SIZE
+
+#ifndef BOOST_HTTP_FILE_ETAG_MAX_HASH_SIZE
+// In bytes
+#define BOOST_HTTP_FILE_ETAG_MAX_HASH_SIZE 1048576
+#endif // BOOST_HTTP_FILE_ETAG_MAX_HASH_SIZE
+
+namespace boost {
+namespace http {
+
+// How the file server derives the entity tags of the files it serves
+enum class file_etag_policy
+{
+    // Only entity tags set by the application are used
+    none,
+    // Strong entity tag derived from the inode, size and modification time
+    metadata,
+    /* Strong entity tag derived from the contents (hashed once per version of
+       the file), or from the metadata for files bigger than
+       `BOOST_HTTP_FILE_ETAG_MAX_HASH_SIZE` */
+    content_hash
+};
+
+/* Returns the quoted strong entity tag of `file` derived as `policy` says or
+   an empty string on errors (or `file_etag_policy::none`). `metadata` (if
+   any) MUST describe `file` and spares querying it again. */
+std::string file_etag(const filesystem::path &file, file_etag_policy policy,
+                      const file_metadata *metadata = nullptr);
+
+namespace detail {
+
+/* Hashes of the files contents, keyed by canonical path and dropped when the
+   file changes (least recently used dropped first) */
+class file_content_etag_cache
+{
+public:
+    // Empty if the file isn't cached or changed since
+    std::string find(const file_metadata &metadata)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(metadata.canonical_path.native());
+        if (it == entries.end())
+            return std::string();
+
+        if (it->second->metadata_etag != metadata.etag) {
+            lru.erase(it->second);
+            entries.erase(it);
+            return std::string();
+        }
+
+        lru.splice(lru.begin(), lru, it->second);
+        return it->second->etag;
+    }
+
+    void insert(const file_metadata &metadata, const std::string &etag)
+    {
+        const auto &key = metadata.canonical_path.native();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            lru.erase(it->second);
+            entries.erase(it);
+        }
+
+        lru.push_front(entry{key, metadata.etag, etag});
+        entries.emplace(key, lru.begin());
+
+        while (entries.size() > BOOST_HTTP_FILE_ETAG_CACHE_MAX_SIZE) {
+            entries.erase(lru.back().key);
+            lru.pop_back();
+        }
+    }
+
+private:
+    struct entry
+    {
+        std::string key;
+        // Identifies the hashed version of the file
+        std::string metadata_etag;
+        std::string etag;
+    };
+
+    typedef std::list<entry> lru_type;
+
+    std::mutex mutex;
+    // Most recently used first
+    lru_type lru;
+    std::unordered_map<std::string, lru_type::iterator> entries;
+};
+
+inline void append_etag_hex(std::string &out, std::uint_least64_t value)
+{
+    const char digits[] = "0123456789abcdef";
+    for (int i = 60 ; i >= 0 ; i -= 4)
+        out.push_back(digits[(value >> i) & 0xf]);
+}
+
+// Quoted 64-bit FNV-1a of the contents (and their size), empty on errors
+inline std::string content_etag(const filesystem::path &file,
+                                std::uintmax_t size)
+{
+    filesystem::ifstream stream(file, std::ios_base::in
+                                | std::ios_base::binary);
+    if (!stream)
+        return std::string();
+
+    std::uint_least64_t hash = 14695981039346656037ull;
+    std::uintmax_t hashed = 0;
+    std::array<char, 65536> buffer;
+    while (stream) {
+        stream.read(buffer.data(), buffer.size());
+        std::size_t n = stream.gcount();
+        for (std::size_t i = 0 ; i != n ; ++i) {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= 1099511628211ull;
+        }
+        hashed += n;
+    }
+
+    // Changed while hashed
+    if (stream.bad() || hashed != size)
+        return std::string();
+
+    std::string ret;
+    ret.reserve(2 + 16 * 2 + 1);
+    ret.push_back('"');
+    append_etag_hex(ret, size);
+    ret.push_back('-');
+    append_etag_hex(ret, hash);
+    ret.push_back('"');
+    return ret;
+}
+
+} // namespace detail
+
+inline std::string file_etag(const filesystem::path &file,
+                             file_etag_policy policy,
+                             const file_metadata *metadata)
+{
+    if (policy == file_etag_policy::none)
+        return std::string();
+
+    std::shared_ptr<const file_metadata> queried;
+    if (!metadata) {
+        queried = file_metadata_cache::query(file);
+        metadata = queried.get();
+    }
+    if (!metadata || !metadata->is_regular_file)
+        return std::string();
+
+    /* The file is hashed synchronously, so big files would stall the thread
+       serving it */
+    if (policy == file_etag_policy::metadata
+        || metadata->size > BOOST_HTTP_FILE_ETAG_MAX_HASH_SIZE) {
+        return metadata->etag;
+    }
+
+    auto &cache = detail::singleton<detail::file_content_etag_cache>::instance;
+    auto ret = cache.find(*metadata);
+    if (ret.size())
+        return ret;
+
+    ret = detail::content_etag(metadata->canonical_path, metadata->size);
+    if (ret.size())
+        cache.insert(*metadata, ret);
+    return ret;
+}
+
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_FILE_ETAG_HPP
@@ -0,0 +1,558 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_FILE_METADATA_CACHE_HPP
+#define BOOST_HTTP_FILE_METADATA_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <boost/http/algorithm/header.hpp>
+#include <boost/http/detail/singleton.hpp>
+#include <boost/http/detail/native_io.hpp>
+
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+#include <boost/asio/posix/stream_descriptor.hpp>
+#endif // BOOST_HTTP_DETAIL_HAS_INOTIFY
+
+#ifndef BOOST_HTTP_FILE_METADATA_CACHE_DEFAULT_TTL
+// In seconds
+#define BOOST_HTTP_FILE_METADATA_CACHE_DEFAULT_TTL 2
+#endif // BOOST_HTTP_FILE_METADATA_CACHE_DEFAULT_TTL
+
+#ifndef BOOST_HTTP_FILE_METADATA_CACHE_DEFAULT_MAX_SIZE
+#define BOOST_HTTP_FILE_METADATA_CACHE_DEFAULT_MAX_SIZE 8192
+#endif // BOOST_HTTP_FILE_METADATA_CACHE_DEFAULT_MAX_SIZE
+
+namespace boost {
+namespace http {
+
+// What the file server needs to know about a path
+struct file_metadata
+{
+    // False for missing paths (the other members are left empty)
+    bool exists = false;
+    bool is_regular_file = false;
+    filesystem::path canonical_path;
+
+    std::uintmax_t inode = 0;
+    std::uintmax_t size = 0;
+    std::int_least64_t mtime_sec = 0;
+    long mtime_nsec = 0;
+
+    // The modification time with HTTP-date precision (and as an HTTP-date)
+    posix_time::ptime last_modified;
+    std::string http_last_modified;
+
+    // Strong validator derived from the inode, size and modification time
+    std::string etag;
+};
+
+/* Metadata of the paths the file server looks up, including the missing ones,
+   so hot paths are served without touching the filesystem. Entries expire
+   after the TTL. On Linux, they're also dropped as soon as inotify reports a
+   change to their parent directory (the events are handled by the
+   `io_service` given to the constructor). Changes further up (e.g. a renamed
+   ancestor) and paths inotify can't track (e.g. paths crossing symlinks) are
+   only noticed once the TTL runs out.
+
+   This class is thread-safe. */
+class file_metadata_cache
+{
+public:
+    typedef std::chrono::steady_clock clock_type;
+
+    explicit
+    file_metadata_cache(asio::io_service &ios,
+                        clock_type::duration ttl
+                        = std::chrono::seconds(
+                            BOOST_HTTP_FILE_METADATA_CACHE_DEFAULT_TTL),
+                        std::size_t max_size
+                        = BOOST_HTTP_FILE_METADATA_CACHE_DEFAULT_MAX_SIZE);
+
+    file_metadata_cache(const file_metadata_cache&) = delete;
+    file_metadata_cache &operator=(const file_metadata_cache&) = delete;
+
+    ~file_metadata_cache();
+
+    /* Returns the metadata of `file`, querying the filesystem on misses.
+       Returns null if the query failed for reasons other than the path not
+       existing (e.g. permissions), so the caller can report the error. */
+    std::shared_ptr<const file_metadata> lookup(const filesystem::path &file);
+
+    void invalidate(const filesystem::path &file);
+    void clear();
+
+    // Number of cached paths
+    std::size_t size() const;
+
+    // Whether changes are reported by the system (otherwise only the TTL)
+    bool watching() const;
+
+    /* Queries the filesystem directly (nothing is cached). Same results as
+       `lookup`. */
+    static std::shared_ptr<file_metadata> query(const filesystem::path &file);
+
+private:
+    struct entry
+    {
+        std::string key;
+        std::shared_ptr<const file_metadata> metadata;
+        // The watch reporting changes to this entry (-1 if none)
+        int wd;
+        clock_type::time_point expires;
+    };
+
+    typedef std::list<entry> lru_type;
+
+    struct state
+    {
+        explicit state(asio::io_service &ios)
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+            : inotify(ios)
+#endif // BOOST_HTTP_DETAIL_HAS_INOTIFY
+        {
+            (void)ios;
+        }
+
+        void erase(std::unordered_map<std::string,
+                                      lru_type::iterator>::iterator it)
+        {
+            release_watch(it->second->wd);
+            lru.erase(it->second);
+            entries.erase(it);
+        }
+
+        void erase(const std::string &key)
+        {
+            auto it = entries.find(key);
+            if (it != entries.end())
+                erase(it);
+        }
+
+        // Erases the entries below the directory `dir`
+        void erase_children(const std::string &dir)
+        {
+            auto prefix = dir + '/';
+            for (auto it = entries.begin() ; it != entries.end() ;) {
+                if (it->first.compare(0, prefix.size(), prefix) == 0) {
+                    release_watch(it->second->wd);
+                    lru.erase(it->second);
+                    it = entries.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        void clear()
+        {
+            for (const auto &e: lru)
+                release_watch(e.wd);
+            entries.clear();
+            lru.clear();
+        }
+
+        /* Drops a reference to the watch `wd` and removes the watch once no
+           entry needs it, as watches are a limited resource
+           (`max_user_watches`) */
+        void release_watch(int wd)
+        {
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+            auto it = watches.find(wd);
+            if (it == watches.end() || --it->second.users != 0)
+                return;
+
+            if (inotify.is_open())
+                ::inotify_rm_watch(inotify.native_handle(), wd);
+            watches.erase(it);
+#else
+            (void)wd;
+#endif // BOOST_HTTP_DETAIL_HAS_INOTIFY
+        }
+
+        std::mutex mutex;
+        // Most recently used first
+        lru_type lru;
+        std::unordered_map<std::string, lru_type::iterator> entries;
+        // Bumped whenever events are handled
+        std::uint_least64_t generation = 0;
+
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+        struct watch_info
+        {
+            // Every spelling of the watched directory
+            std::vector<std::string> spellings;
+            // Entries (and lookups in progress) relying on the watch
+            std::size_t users = 0;
+        };
+
+        asio::posix::stream_descriptor inotify;
+        std::unordered_map<int, watch_info> watches;
+        std::array<char, 4096> events;
+#endif // BOOST_HTTP_DETAIL_HAS_INOTIFY
+    };
+
+    /* Returns the watch reporting changes to `file` (-1 if none), with a
+       reference taken on behalf of the caller */
+    int watch(const filesystem::path &file);
+
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+    static void schedule_read_events(std::shared_ptr<state> s);
+    static void on_events(state &s, std::size_t size);
+#endif // BOOST_HTTP_DETAIL_HAS_INOTIFY
+
+    asio::io_service &ios;
+    clock_type::duration ttl;
+    std::size_t max_size;
+    std::shared_ptr<state> state_;
+};
+
+/* The metadata cache the file server functions query (none by default).
+   `cache` is not owned and MUST outlive the transmit operations. */
+void set_file_server_metadata_cache(file_metadata_cache *cache);
+file_metadata_cache *file_server_metadata_cache();
+
+inline file_metadata_cache::file_metadata_cache(asio::io_service &ios,
+                                                clock_type::duration ttl,
+                                                std::size_t max_size)
+    : ios(ios)
+    , ttl(ttl)
+    , max_size(max_size ? max_size : 1)
+    , state_(std::make_shared<state>(ios))
+{
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+    int fd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd == -1)
+        return;
+
+    state_->inotify.assign(fd);
+    schedule_read_events(state_);
+#endif // BOOST_HTTP_DETAIL_HAS_INOTIFY
+}
+
+inline file_metadata_cache::~file_metadata_cache()
+{
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+    /* The pending read keeps the state alive and the descriptor is closed
+       from the `io_service` (descriptors aren't thread-safe) */
+    auto s = state_;
+    ios.post([s]() {
+            system::error_code ignored_ec;
+            s->inotify.close(ignored_ec);
+        });
+#endif // BOOST_HTTP_DETAIL_HAS_INOTIFY
+}
+
+inline std::shared_ptr<const file_metadata>
+file_metadata_cache::lookup(const filesystem::path &file)
+{
+    const auto &key = file.native();
+    auto now = clock_type::now();
+    std::uint_least64_t generation;
+
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        auto it = state_->entries.find(key);
+        if (it != state_->entries.end()) {
+            auto &e = *it->second;
+            if (now < e.expires) {
+                state_->lru.splice(state_->lru.begin(), state_->lru,
+                                   it->second);
+                return e.metadata;
+            }
+
+            state_->erase(it);
+        }
+        generation = state_->generation;
+    }
+
+    // Watching first, so changes after the query are always reported
+    int wd = watch(file);
+
+    std::shared_ptr<const file_metadata> metadata = query(file);
+
+    std::lock_guard<std::mutex> lock(state_->mutex);
+
+    /* Symlinks are resolved by the query, but their targets aren't watched.
+       Also, events handled meanwhile might refer to this file. */
+    if (!metadata || (metadata->exists && metadata->canonical_path != file)
+        || generation != state_->generation) {
+        state_->release_watch(wd);
+        wd = -1;
+    }
+
+    if (!metadata)
+        return metadata;
+
+    state_->erase(key);
+    state_->lru.push_front(entry{key, metadata, wd, now + ttl});
+    state_->entries.emplace(key, state_->lru.begin());
+
+    while (state_->entries.size() > max_size)
+        state_->erase(state_->lru.back().key);
+
+    return metadata;
+}
+
+inline void file_metadata_cache::invalidate(const filesystem::path &file)
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->erase(file.native());
+}
+
+inline void file_metadata_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->clear();
+}
+
+inline std::size_t file_metadata_cache::size() const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->entries.size();
+}
+
+inline bool file_metadata_cache::watching() const
+{
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+    return state_->inotify.is_open();
+#else
+    return false;
+#endif // BOOST_HTTP_DETAIL_HAS_INOTIFY
+}
+
+inline std::shared_ptr<file_metadata>
+file_metadata_cache::query(const filesystem::path &file)
+{
+    auto ret = std::make_shared<file_metadata>();
+    std::time_t mtime;
+
+#ifdef BOOST_HTTP_DETAIL_HAS_STAT
+    struct stat st;
+    if (::stat(file.c_str(), &st) == -1) {
+        if (errno == ENOENT || errno == ENOTDIR)
+            return ret;
+        return nullptr;
+    }
+
+    ret->is_regular_file = S_ISREG(st.st_mode);
+    ret->inode = st.st_ino;
+    ret->size = ret->is_regular_file ? st.st_size : 0;
+    ret->mtime_sec = st.st_mtime;
+#if defined(__APPLE__)
+    ret->mtime_nsec = st.st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+    ret->mtime_nsec = st.st_mtim.tv_nsec;
+#endif
+    mtime = st.st_mtime;
+#else
+    system::error_code ec;
+    auto status = filesystem::status(file, ec);
+    if (status.type() == filesystem::file_not_found)
+        return ret;
+    if (ec)
+        return nullptr;
+
+    ret->is_regular_file = status.type() == filesystem::regular_file;
+    mtime = filesystem::last_write_time(file, ec);
+    if (ret->is_regular_file && !ec)
+        ret->size = filesystem::file_size(file, ec);
+    if (ec)
+        return nullptr;
+    ret->mtime_sec = mtime;
+#endif // BOOST_HTTP_DETAIL_HAS_STAT
+
+    system::error_code ec;
+    ret->canonical_path = filesystem::canonical(file, ec);
+    if (ec)
+        return nullptr;
+
+    ret->exists = true;
+    ret->last_modified = posix_time::from_time_t(mtime);
+    ret->http_last_modified = to_http_date<std::string>(ret->last_modified);
+
+    auto append_hex = [&ret](std::uintmax_t value) {
+        const char digits[] = "0123456789abcdef";
+        char buffer[sizeof(value) * 2];
+        auto end = buffer + sizeof(buffer);
+        auto it = end;
+        do {
+            *--it = digits[value % 16];
+            value /= 16;
+        } while (value);
+        ret->etag.append(it, end);
+    };
+    ret->etag.push_back('"');
+    append_hex(ret->inode);
+    ret->etag.push_back('-');
+    append_hex(ret->size);
+    ret->etag.push_back('-');
+    append_hex(std::uintmax_t(ret->mtime_sec) * 1000000000u
+               + ret->mtime_nsec);
+    ret->etag.push_back('"');
+
+    return ret;
+}
+
+inline int file_metadata_cache::watch(const filesystem::path &file)
+{
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+    if (!state_->inotify.is_open())
+        return -1;
+
+    const std::uint32_t mask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB
+        | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE_SELF
+        | IN_MOVE_SELF | IN_ONLYDIR;
+
+    /* The closest existing ancestor is watched, as the creation of the missing
+       directories is reported there */
+    for (auto dir = file.parent_path() ; !dir.empty()
+             ; dir = dir.parent_path()) {
+        int wd = ::inotify_add_watch(state_->inotify.native_handle(),
+                                     dir.c_str(), mask);
+        if (wd == -1) {
+            if (errno == ENOENT)
+                continue;
+            return -1;
+        }
+
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        auto &info = state_->watches[wd];
+        if (std::find(info.spellings.begin(), info.spellings.end(),
+                      dir.native()) == info.spellings.end()) {
+            info.spellings.push_back(dir.native());
+        }
+        ++info.users;
+        return wd;
+    }
+#else
+    (void)file;
+#endif // BOOST_HTTP_DETAIL_HAS_INOTIFY
+    return -1;
+}
+
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+
+inline void file_metadata_cache::schedule_read_events(std::shared_ptr<state> s)
+{
+    auto &state = *s;
+    state.inotify.async_read_some(asio::buffer(state.events),
+                                  [s](const system::error_code &ec,
+                                      std::size_t size) {
+        if (ec == asio::error::operation_aborted || !s->inotify.is_open())
+            return;
+
+        if (ec) {
+            // Without events, nothing can be trusted anymore
+            std::lock_guard<std::mutex> lock(s->mutex);
+            ++s->generation;
+            s->clear();
+            s->watches.clear();
+            system::error_code ignored_ec;
+            s->inotify.close(ignored_ec);
+            return;
+        }
+
+        on_events(*s, size);
+        schedule_read_events(s);
+    });
+}
+
+inline void file_metadata_cache::on_events(state &s, std::size_t size)
+{
+    std::lock_guard<std::mutex> lock(s.mutex);
+    ++s.generation;
+
+    for (std::size_t i = 0 ; i + sizeof(inotify_event) <= size ;) {
+        inotify_event event;
+        std::memcpy(&event, s.events.data() + i, sizeof(event));
+        const char *name = s.events.data() + i + sizeof(event);
+        i += sizeof(event) + event.len;
+
+        if (event.mask & IN_Q_OVERFLOW) {
+            s.clear();
+            continue;
+        }
+
+        auto it = s.watches.find(event.wd);
+        if (it == s.watches.end())
+            continue;
+
+        if (event.mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+            auto spellings = it->second.spellings;
+            for (const auto &dir: spellings) {
+                s.erase(dir);
+                s.erase_children(dir);
+            }
+
+            // Erasing the last users might have removed the watch already
+            it = s.watches.find(event.wd);
+            if (it == s.watches.end())
+                continue;
+
+            if (event.mask & IN_IGNORED)
+                s.watches.erase(it);
+            else if (event.mask & IN_MOVE_SELF)
+                ::inotify_rm_watch(s.inotify.native_handle(), event.wd);
+            continue;
+        }
+
+        if (event.len == 0)
+            continue;
+
+        // Erasing the last users of the watch also removes it
+        auto spellings = it->second.spellings;
+        for (const auto &dir: spellings) {
+            auto path = (filesystem::path(dir) / name).native();
+            s.erase(path);
+            if (event.mask & IN_ISDIR)
+                s.erase_children(path);
+        }
+    }
+}
+
+#endif // BOOST_HTTP_DETAIL_HAS_INOTIFY
+
+namespace detail {
+
+struct file_server_metadata_cache_tag;
+
+} // namespace detail
+
+inline void set_file_server_metadata_cache(file_metadata_cache *cache)
+{
+    detail::singleton<std::atomic<file_metadata_cache*>,
+                      detail::file_server_metadata_cache_tag>::instance = cache;
+}
+
+inline file_metadata_cache *file_server_metadata_cache()
+{
+    return detail::singleton<std::atomic<file_metadata_cache*>,
+                             detail::file_server_metadata_cache_tag>::instance;
+}
+
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_FILE_METADATA_CACHE_HPP
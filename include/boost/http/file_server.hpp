@@ -21,6 +21,11 @@
 #include <boost/algorithm/cxx14/equal.hpp>
 
 #include <boost/http/detail/singleton.hpp>
+#include <boost/http/detail/native_io.hpp>
+#include <boost/http/detail/accept_encoding.hpp>
+#include <boost/http/file_etag.hpp>
+#include <boost/http/file_metadata_cache.hpp>
+#include <boost/http/mapped_file_cache.hpp>
 #include <boost/http/algorithm/header.hpp>
 #include <boost/http/write_state.hpp>
 #include <boost/http/detail/constchar_helper.hpp>
@@ -133,6 +138,148 @@ posix_time::ptime last_modified_http_date(const filesystem::path &file)
                                                        d.seconds()));
 }
 
+// The cached metadata of `file` (null if there's no cache or it failed)
+inline std::shared_ptr<const file_metadata>
+query_file_metadata(const filesystem::path &file)
+{
+    if (auto cache = file_server_metadata_cache())
+        return cache->lookup(file);
+    return nullptr;
+}
+
+// The metadata of `file`, cached or not (null on errors)
+inline std::shared_ptr<const file_metadata>
+lookup_file_metadata(const filesystem::path &file)
+{
+    if (auto cache = file_server_metadata_cache())
+        return cache->lookup(file);
+    return file_metadata_cache::query(file);
+}
+
+// The representation chosen by `negotiate_precompressed`
+struct precompressed_file
+{
+    // Empty if the requested file itself is sent
+    filesystem::path file;
+    const char *encoding = nullptr;
+    // Whether other encodings are available (the response varies)
+    bool vary = false;
+};
+
+/* Picks the sibling of `file` (`file.br` or `file.gz`) the client prefers
+   among those at least as recent as `file` */
+template<class Request>
+precompressed_file negotiate_precompressed(const Request &imessage,
+                                           const filesystem::path &file)
+{
+    typedef typename Request::headers_type::mapped_type::value_type CharT;
+    typedef basic_string_ref<CharT> string_ref_type;
+
+    precompressed_file ret;
+
+    auto original = lookup_file_metadata(file);
+    if (!original || !original->is_regular_file)
+        return ret;
+
+    // Preferred on ties (in this order)
+    static const std::array<std::pair<const char*, const char*>, 2> codings{{
+        {"br", ".br"},
+        {"gzip", ".gz"}
+    }};
+
+    auto accept_encoding = joined_accept_encoding(imessage);
+    string_ref_type accepted(accept_encoding);
+
+    int best = identity_threshold(accepted);
+
+    for (const auto &coding: codings) {
+        auto sibling = file;
+        sibling += coding.second;
+
+        auto metadata = lookup_file_metadata(sibling);
+        if (!metadata || !metadata->is_regular_file
+            || std::make_pair(metadata->mtime_sec, metadata->mtime_nsec)
+            < std::make_pair(original->mtime_sec, original->mtime_nsec)) {
+            continue;
+        }
+
+        ret.vary = true;
+
+        int quality = encoding_quality(accepted, coding.first);
+        if (quality >= best) {
+            best = quality + 1;
+            ret.file = std::move(sibling);
+            ret.encoding = coding.first;
+        }
+    }
+
+    return ret;
+}
+
+// Describes the representation chosen by `negotiate_precompressed`
+template<class Response>
+void apply_precompressed(Response &omessage, const precompressed_file &file)
+{
+    if (file.encoding) {
+        omessage.headers().emplace("content-encoding", file.encoding);
+
+        // Entity tags set by the application identify the unencoded one
+        auto header = omessage.headers().equal_range("etag");
+        if (std::distance(header.first, header.second) == 1) {
+            auto value = encoded_etag(header.first->second, file.encoding);
+            if (value.size())
+                replace_field(omessage.headers(), header.first, "etag", value);
+        }
+    }
+    if (file.vary)
+        omessage.headers().emplace("vary", "accept-encoding");
+}
+
+/* Undoes `apply_precompressed`, so the response can still be used to report
+   a failed transmission (e.g. with a 404) */
+template<class Response>
+void revert_precompressed(Response &omessage, const precompressed_file &file)
+{
+    auto &headers = omessage.headers();
+
+    auto erase_one = [&headers](const char *name, string_ref value) {
+        auto header = headers.equal_range(name);
+        for (auto it = header.first ; it != header.second ; ++it) {
+            if (string_ref(it->second.data(), it->second.size()) == value) {
+                headers.erase(it);
+                return;
+            }
+        }
+    };
+
+    if (file.encoding) {
+        erase_one("content-encoding", file.encoding);
+
+        auto header = headers.equal_range("etag");
+        if (std::distance(header.first, header.second) == 1) {
+            auto value = decoded_etag(header.first->second, file.encoding);
+            if (value.size())
+                replace_field(headers, header.first, "etag", value);
+        }
+    }
+    if (file.vary)
+        erase_one("vary", "accept-encoding");
+}
+
+} // namespace detail
+
+// Optional behaviour of `async_response_transmit_file` (and `_dir`)
+struct file_server_options
+{
+    // How entity tags are derived for responses without an "etag" field
+    file_etag_policy etag_policy = file_etag_policy::none;
+    /* Whether the `.br` and `.gz` siblings of the files are sent to the
+       clients accepting them */
+    bool precompressed = false;
+};
+
+namespace detail {
+
 inline
 void insert_new_range(std::vector<std::pair<std::uintmax_t, std::uintmax_t>>
                       &range_set,
@@ -365,6 +512,176 @@ struct on_async_response_transmit_file
     std::uintmax_t remaining;
 };
 
+#ifdef BOOST_HTTP_DETAIL_HAS_SENDFILE
+
+/* Sockets over a native socket send the file with sendfile(2) instead, so the
+   bytes are neither copied into the body nor chunked. Returns false if the
+   regular path must be taken. */
+template<class ServerSocket, class Response, class Handler>
+auto async_transmit_native_file(ServerSocket &socket, Response &omessage,
+                                const filesystem::path &file,
+                                std::uintmax_t offset, std::uintmax_t size,
+                                Handler &handler, int)
+    -> typename std::enable_if<
+        std::is_same<decltype(socket.next_layer().native_handle()), int>::value,
+        decltype(socket.pipeline_depth(),
+                 socket.async_write_response_file(omessage, 0, 0, 0, handler),
+                 bool())>::type
+{
+    if (socket.pipeline_depth() != 1)
+        return false;
+
+    int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return false;
+
+    socket.async_write_response_file(omessage, fd, offset, size,
+                                     [fd,handler](const system::error_code &ec)
+                                     mutable {
+                                         ::close(fd);
+                                         handler(ec);
+                                     });
+    return true;
+}
+
+#endif // BOOST_HTTP_DETAIL_HAS_SENDFILE
+
+template<class ServerSocket, class Response, class Handler>
+bool async_transmit_native_file(ServerSocket&, Response&,
+                                const filesystem::path&, std::uintmax_t,
+                                std::uintmax_t, Handler&, long)
+{
+    return false;
+}
+
+/* With a file server cache set, the bytes are gathered straight from the
+   shared mapping of the file instead of being copied into the body. Returns
+   false if another path must be taken. */
+template<class ServerSocket, class Response, class Handler>
+auto async_transmit_mapped_file(ServerSocket &socket, Response &omessage,
+                                const file_metadata *metadata,
+                                std::uintmax_t offset, std::uintmax_t size,
+                                Handler &handler, int)
+    -> decltype(socket.pipeline_depth(),
+                socket.async_write_response_buffers(omessage,
+                                                    asio::const_buffers_1
+                                                    (nullptr, 0),
+                                                    handler),
+                bool())
+{
+    auto cache = file_server_cache();
+    if (!metadata || !cache || socket.pipeline_depth() != 1)
+        return false;
+
+    /* Null if the file changed since `metadata` (which the headers describe)
+       was queried */
+    auto mapping = cache->acquire(*metadata);
+    if (!mapping)
+        return false;
+
+    asio::const_buffers_1 body(mapping->buffer(offset, size));
+    socket.async_write_response_buffers(omessage, body,
+                                        [mapping,handler]
+                                        (const system::error_code &ec)
+                                        mutable {
+                                            handler(ec);
+                                        });
+    return true;
+}
+
+template<class ServerSocket, class Response, class Handler>
+bool async_transmit_mapped_file(ServerSocket&, Response&, const file_metadata*,
+                                std::uintmax_t, std::uintmax_t, Handler&, long)
+{
+    return false;
+}
+
+struct mapped_multipart_body
+{
+    std::shared_ptr<const mapped_file> mapping;
+    // The part delimiters and headers
+    std::vector<std::string> delimiters;
+    std::vector<asio::const_buffer> buffers;
+};
+
+/* multipart/byteranges counterpart of `async_transmit_mapped_file`. Takes
+   `range_set` before `to_cpp_range` is applied. */
+template<class ServerSocket, class Response, class String, class Handler>
+auto async_transmit_mapped_ranges(ServerSocket &socket, Response &omessage,
+                                  const file_metadata *metadata,
+                                  const String &content_type,
+                                  const std::vector<std::pair<std::uintmax_t,
+                                                              std::uintmax_t>>
+                                  &range_set,
+                                  std::uintmax_t file_size, Handler &handler,
+                                  int)
+    -> decltype(socket.pipeline_depth(),
+                socket.async_write_response_buffers(omessage,
+                                                    asio::const_buffers_1
+                                                    (nullptr, 0),
+                                                    handler),
+                bool())
+{
+    auto cache = file_server_cache();
+    if (!metadata || !cache || socket.pipeline_depth() != 1)
+        return false;
+
+    auto body = std::make_shared<mapped_multipart_body>();
+    // Same identity check as `async_transmit_mapped_file`
+    body->mapping = cache->acquire(*metadata);
+    if (!body->mapping)
+        return false;
+
+    const std::string file_size_str = std::to_string(file_size);
+    body->delimiters.reserve(range_set.size() + 1);
+    for (const auto &range: range_set) {
+        std::string delimiter("\r\n--" BOOST_HTTP_FILE_SERVER_BOUNDARY "\r\n");
+        if (content_type.size()) {
+            delimiter += "content-type: ";
+            delimiter.append(content_type.begin(), content_type.end());
+            delimiter += "\r\n";
+        }
+        delimiter += "content-range: bytes ";
+        delimiter += std::to_string(range.first);
+        delimiter += '-';
+        delimiter += std::to_string(range.second);
+        delimiter += '/';
+        delimiter += file_size_str;
+        delimiter += "\r\n\r\n";
+        body->delimiters.push_back(std::move(delimiter));
+    }
+    body->delimiters.emplace_back("\r\n--" BOOST_HTTP_FILE_SERVER_BOUNDARY
+                                  "--\r\n");
+
+    body->buffers.reserve(range_set.size() * 2 + 1);
+    for (std::size_t i = 0 ; i != range_set.size() ; ++i) {
+        auto range = range_set[i];
+        to_cpp_range(range);
+        body->buffers.push_back(asio::buffer(body->delimiters[i]));
+        body->buffers.push_back(body->mapping->buffer(range.first,
+                                                      range.second));
+    }
+    body->buffers.push_back(asio::buffer(body->delimiters.back()));
+
+    socket.async_write_response_buffers(omessage, body->buffers,
+                                        [body,handler]
+                                        (const system::error_code &ec)
+                                        mutable {
+                                            handler(ec);
+                                        });
+    return true;
+}
+
+template<class ServerSocket, class Response, class String, class Handler>
+bool async_transmit_mapped_ranges(ServerSocket&, Response&, const file_metadata*,
+                                  const String&,
+                                  const std::vector<std::pair<std::uintmax_t,
+                                                              std::uintmax_t>>&,
+                                  std::uintmax_t, Handler&, long)
+{
+    return false;
+}
+
 template<class Socket, class Message, class String, class Handler>
 struct on_async_response_transmit_file_multi
     : public std::enable_shared_from_this<
@@ -929,7 +1246,19 @@ typename asio::async_result<
                                 void(system::error_code)>::type>::type
 async_response_transmit_file(ServerSocket &socket, const Request &imessage,
                              Response &omessage, const filesystem::path &file,
-                             bool is_head_request, CompletionToken &&token)
+                             bool is_head_request, CompletionToken &&token);
+
+template<class ServerSocket, class Request, class Response,
+         class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+async_response_transmit_file(ServerSocket &socket, const Request &imessage,
+                             Response &omessage,
+                             const filesystem::path &requested_file,
+                             bool is_head_request,
+                             const file_server_options &options,
+                             CompletionToken &&token)
 {
     static_assert(is_server_socket<ServerSocket>::value,
                   "ServerSocket must fulfill the ServerSocket concept");
@@ -941,8 +1270,10 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
     typedef typename Request::headers_type::value_type headers_value_type;
     typedef typename Request::headers_type::mapped_type::value_type ReqCharT;
     typedef basic_string_ref<ReqCharT> req_string_ref_type;
-    typedef typename Response::headers_type::mapped_type String;
-    typedef typename String::value_type ResCharT;
+    typedef typename Response::headers_type::mapped_type::value_type ResCharT;
+    /* Owning, as `mapped_type` may only view the storage of the container
+       (e.g. `arena_headers`) */
+    typedef std::basic_string<ResCharT> String;
     typedef basic_string_ref<ResCharT> res_string_ref_type;
     typedef typename Response::body_type::value_type body_value_type;
     typedef typename asio::handler_type<
@@ -965,13 +1296,35 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
 
     detail::constchar_helper crlf("\r\n");
 
+    detail::precompressed_file precompressed;
+    if (options.precompressed)
+        precompressed = detail::negotiate_precompressed(imessage,
+                                                        requested_file);
+
+    // The encoded representation is just another file (ranges included)
+    const filesystem::path &file = precompressed.encoding ? precompressed.file
+        : requested_file;
+
     try {
         /* BEWARE: std::time_t is not TZ aware and some old filesystems report
            time as local (i.e. non-UTC). We don't try to detect filesystem
            behaviour to avoid races and because all modern filesystems adopted
            UTC. */
-        auto last_modified = detail::last_modified_http_date(file);
-        const auto size = file_size(file);
+        /* The mapped file path needs the metadata to tell whether the file
+           still is the one the headers describe */
+        auto metadata = file_server_cache() ? detail::lookup_file_metadata(file)
+            : detail::query_file_metadata(file);
+        // Missing files and such take the regular path to report the error
+        if (metadata && !metadata->is_regular_file)
+            metadata.reset();
+
+        auto last_modified = metadata ? metadata->last_modified
+            : detail::last_modified_http_date(file);
+        const auto size = metadata ? metadata->size : file_size(file);
+
+        /* Only described once the file is known to be there. From now on,
+           failures revert it. */
+        detail::apply_precompressed(omessage, precompressed);
         const auto buffer_size = [&omessage]() {
             auto ret = omessage.body().capacity();
             // can be any number > 0
@@ -988,6 +1341,19 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
             return result.get();
         }
 
+        {
+            auto policy = options.etag_policy;
+            auto header = omessage.headers().equal_range("etag");
+            if (policy != file_etag_policy::none
+                && header.first == header.second) {
+                auto value = file_etag(file, policy, metadata.get());
+                if (value.size()) {
+                    omessage.headers().emplace("etag", value);
+                }
+            }
+        }
+
+        // The whole entity tag (quotes included) and whether it's strong
         auto etag = [](const typename Response::headers_type &headers) {
             auto header = headers.equal_range("etag");
             if (std::distance(header.first, header.second) != 1)
@@ -998,13 +1364,13 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
                 return std::make_pair(res_string_ref_type{}, false);
 
             if (value.front() == '"') {
-                return std::make_pair(res_string_ref_type{&value[1],
-                                                      value.size() - 2},
+                return std::make_pair(res_string_ref_type{&value[0],
+                                                      value.size()},
                                       true);
             } else if (value.size() > 2 && (value[0] == 'W' && value[1] == '/'
                                             && value[2] == '"')) {
-                return std::make_pair(res_string_ref_type{&value[3],
-                                                      value.size() - 4},
+                return std::make_pair(res_string_ref_type{&value[0],
+                                                      value.size()},
                                       false);
             }
 
@@ -1020,9 +1386,6 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
             return etag.second;
         };
 
-        auto current_etag = etag(omessage.headers());
-        auto current_etag_value = etag_value(current_etag);
-
         /* only fill response headers that need no more than the target file
            to be computed (i.e. ignore all input headers) */
         {
@@ -1035,11 +1398,23 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
             if (last_modified > now)
                 last_modified = now;
 
-            omessage.headers().emplace("date", to_http_date<String>(now));
-            omessage.headers()
-            .emplace("last-modified", to_http_date<String>(last_modified));
+            omessage.headers().emplace("date", to_http_date<std::string>(now));
+            if (metadata && last_modified == metadata->last_modified) {
+                omessage.headers().emplace("last-modified",
+                                           metadata->http_last_modified);
+            } else {
+                omessage.headers()
+                    .emplace("last-modified",
+                             to_http_date<std::string>(last_modified));
+            }
         };
 
+        /* Only taken now, as inserting fields might move the stored ones (e.g.
+           `flat_multimap`) and no more fields are inserted until the
+           conditional request headers are checked */
+        auto current_etag = etag(omessage.headers());
+        auto current_etag_value = etag_value(current_etag);
+
         /* The order to check the conditional request headers is defined in
            RFC7232 */
 
@@ -1136,12 +1511,26 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
         if (process_range) {
             auto query = imessage.headers().equal_range("if-range");
             if (std::distance(query.first, query.second) == 1) {
-                auto query_datetime = header_to_ptime(query.first->second);
-
-                /* valid HTTP-date (otherwise must ignore it) */
-                if (!query_datetime.is_not_a_date_time()) {
-                    if (last_modified != query_datetime)
+                const auto &value = query.first->second;
+                bool is_etag = value.size() > 1
+                    && (value[0] == '"'
+                        || (value[0] == 'W' && value[1] == '/'));
+
+                if (is_etag) {
+                    // only a strong match allows the range
+                    req_string_ref_type v{value.data(), value.size()};
+                    if (!etag_is_strong(current_etag)
+                        || !etag_match_strong(current_etag_value, v)) {
                         process_range = false;
+                    }
+                } else {
+                    auto query_datetime = header_to_ptime(value);
+
+                    /* valid HTTP-date (otherwise must ignore it) */
+                    if (!query_datetime.is_not_a_date_time()) {
+                        if (last_modified != query_datetime)
+                            process_range = false;
+                    }
                 }
             }
         }
@@ -1170,6 +1559,20 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
 
                 detail::to_cpp_range(range);
 
+                omessage.status_code() = 206;
+                omessage.reason_phrase() = "Partial Content";
+                if (detail::async_transmit_mapped_file(socket, omessage,
+                                                       metadata.get(),
+                                                       range.first,
+                                                       range.second, handler,
+                                                       0)
+                    || detail::async_transmit_native_file(socket, omessage,
+                                                          file, range.first,
+                                                          range.second,
+                                                          handler, 0)) {
+                    return result.get();
+                }
+
                 if (socket.write_response_native_stream()) {
                     omessage.body().resize(buffer_size);
 
@@ -1191,6 +1594,7 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
                     socket.async_write_response_metadata(omessage, callback);
                 } else {
                     if (range.second > omessage.body().max_size()) {
+                        detail::revert_precompressed(omessage, precompressed);
                         socket.get_io_service().post([handler]() mutable {
                                 handler(system::error_code
                                         {file_server_errc::io_error});
@@ -1216,12 +1620,13 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
                 return result.get();
             } else {
                 // range_set.size() > 1
-                // TODO: use string_ref?
                 String content_type;
                 {
                     auto h = omessage.headers().equal_range("content-type");
-                    if (std::distance(h.first, h.second) == 1)
-                        content_type = h.first->second;
+                    if (std::distance(h.first, h.second) == 1) {
+                        content_type.assign(h.first->second.begin(),
+                                            h.first->second.end());
+                    }
                     omessage.headers().erase(h.first, h.second);
                 }
 
@@ -1229,6 +1634,16 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
                                            "multipart/byteranges;boundary="
                                            BOOST_HTTP_FILE_SERVER_BOUNDARY);
 
+                omessage.status_code() = 206;
+                omessage.reason_phrase() = "Partial Content";
+                if (detail::async_transmit_mapped_ranges(socket, omessage,
+                                                         metadata.get(),
+                                                         content_type,
+                                                         range_set, size,
+                                                         handler, 0)) {
+                    return result.get();
+                }
+
                 if (socket.write_response_native_stream()) {
                     omessage.body().resize(buffer_size);
 
@@ -1319,6 +1734,8 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
                             auto newsiz = detail::safe_add(index, range.second);
                             omessage.body().resize(newsiz);
                         } catch (const std::overflow_error&) {
+                            detail::revert_precompressed(omessage,
+                                                         precompressed);
                             socket.get_io_service().post([handler]() mutable {
                                     handler(system::error_code{file_server_errc
                                                 ::io_error});
@@ -1352,6 +1769,16 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
 
         // non-byte-range-request
 
+        omessage.status_code() = 200;
+        omessage.reason_phrase() = "OK";
+        if (detail::async_transmit_mapped_file(socket, omessage,
+                                               metadata.get(), 0, size,
+                                               handler, 0)
+            || detail::async_transmit_native_file(socket, omessage, file, 0,
+                                                  size, handler, 0)) {
+            return result.get();
+        }
+
         if (socket.write_response_native_stream()) {
             omessage.body().resize(buffer_size);
 
@@ -1371,6 +1798,7 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
             socket.async_write_response_metadata(omessage, callback);
         } else {
             if (size > omessage.body().max_size()) {
+                detail::revert_precompressed(omessage, precompressed);
                 socket.get_io_service().post([handler]() mutable {
                         handler(system::error_code{file_server_errc::io_error});
                     });
@@ -1392,15 +1820,40 @@ async_response_transmit_file(ServerSocket &socket, const Request &imessage,
             socket.async_write_response(omessage, handler);
         }
     } catch (const std::ios_base::failure&) {
+        detail::revert_precompressed(omessage, precompressed);
         socket.get_io_service().post([handler]() mutable {
                 handler(system::error_code{file_server_errc::io_error});
             });
         return result.get();
+    } catch (...) {
+        detail::revert_precompressed(omessage, precompressed);
+        throw;
     }
 
     return result.get();
 }
 
+template<class ServerSocket, class Request, class Response,
+         class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+async_response_transmit_file(ServerSocket &socket, const Request &imessage,
+                             Response &omessage, const filesystem::path &file,
+                             bool is_head_request, CompletionToken &&token)
+{
+    static_assert(is_server_socket<ServerSocket>::value,
+                  "ServerSocket must fulfill the ServerSocket concept");
+    static_assert(is_request_message<Request>::value,
+                  "Request must fulfill the Request concept");
+    static_assert(is_response_message<Response>::value,
+                  "Response must fulfill the Response concept");
+
+    return async_response_transmit_file(socket, imessage, omessage, file,
+                                        is_head_request, file_server_options{},
+                                        std::forward<CompletionToken>(token));
+}
+
 template<class ServerSocket, class Request, class Response,
          class CompletionToken>
 typename asio::async_result<
@@ -1442,6 +1895,18 @@ async_response_transmit_dir(ServerSocket &socket,
                             const ConvertibleToPath &ipath,
                             const Request &imessage, Response &omessage,
                             const filesystem::path &root_dir, Predicate filter,
+                            CompletionToken &&token);
+
+template<class ServerSocket, class ConvertibleToPath, class Request,
+         class Response, class Predicate, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+async_response_transmit_dir(ServerSocket &socket,
+                            const ConvertibleToPath &ipath,
+                            const Request &imessage, Response &omessage,
+                            const filesystem::path &root_dir, Predicate filter,
+                            const file_server_options &options,
                             CompletionToken &&token)
 {
     static_assert(is_server_socket<ServerSocket>::value,
@@ -1468,12 +1933,20 @@ async_response_transmit_dir(ServerSocket &socket,
     bool is_head = (imessage.method() == "HEAD");
 
     try {
-        auto canonical_root = canonical(root_dir);
+        auto root_metadata = detail::query_file_metadata(root_dir);
+        if (root_metadata && !root_metadata->exists) {
+            throw filesystem::filesystem_error("canonical", root_dir,
+                                               system::errc::make_error_code
+                                               (system::errc
+                                                ::no_such_file_or_directory));
+        }
+
+        auto canonical_root = root_metadata ? root_metadata->canonical_path
+            : canonical(root_dir);
         auto canonical_file = canonical_root
             / detail::resolve_dots_or_throw_not_found(ipath);
 
-        if (!detail::path_contains_file(canonical_root, canonical_file)
-            || !exists(canonical_file)) {
+        if (!detail::path_contains_file(canonical_root, canonical_file)) {
             socket.get_io_service().post([handler]() mutable {
                     handler(system::error_code{file_server_errc
                                 ::file_not_found});
@@ -1481,7 +1954,17 @@ async_response_transmit_dir(ServerSocket &socket,
             return result.get();
         }
 
-        if (!is_regular_file(canonical_file)) {
+        auto metadata = detail::query_file_metadata(canonical_file);
+        if (metadata ? !metadata->exists : !exists(canonical_file)) {
+            socket.get_io_service().post([handler]() mutable {
+                    handler(system::error_code{file_server_errc
+                                ::file_not_found});
+                });
+            return result.get();
+        }
+
+        if (metadata ? !metadata->is_regular_file
+            : !is_regular_file(canonical_file)) {
             socket.get_io_service().post([handler]() mutable {
                     handler(system::error_code{file_server_errc
                                 ::file_type_not_supported});
@@ -1497,7 +1980,7 @@ async_response_transmit_dir(ServerSocket &socket,
         }
 
         async_response_transmit_file(socket, imessage, omessage, canonical_file,
-                                     is_head, handler);
+                                     is_head, options, handler);
     } catch (const filesystem::filesystem_error &e) {
         auto err = e.code();
         socket.get_io_service().post([handler,err]() mutable {
@@ -1536,6 +2019,29 @@ async_response_transmit_dir(ServerSocket &socket,
                                        root_dir, filter, token);
 }
 
+template<class ServerSocket, class ConvertibleToPath, class Request,
+         class Response, class Predicate, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+async_response_transmit_dir(ServerSocket &socket,
+                            const ConvertibleToPath &ipath,
+                            const Request &imessage, Response &omessage,
+                            const filesystem::path &root_dir, Predicate filter,
+                            CompletionToken &&token)
+{
+    static_assert(is_server_socket<ServerSocket>::value,
+                  "ServerSocket must fulfill the ServerSocket concept");
+    static_assert(is_request_message<Request>::value,
+                  "Request must fulfill the Request concept");
+    static_assert(is_response_message<Response>::value,
+                  "Response must fulfill the Response concept");
+
+    return async_response_transmit_dir(socket, ipath, imessage, omessage,
+                                       root_dir, filter, file_server_options{},
+                                       std::forward<CompletionToken>(token));
+}
+
 } // namespace http
 } // namespace boost
 
@@ -0,0 +1,111 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_HEADER_FILTER_HPP
+#define BOOST_HTTP_HEADER_FILTER_HPP
+
+#include <algorithm>
+#include <bitset>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include <boost/utility/string_ref.hpp>
+#include <boost/http/header_id.hpp>
+
+namespace boost {
+namespace http {
+
+/* Set of the fields a socket should store in the messages it reads. Fields
+   outside the set are dropped while parsing (they're never copied). Well-known
+   fields are matched by their `header_id` (a bit test) and the rest by name.
+
+   `connection`, `expect` and `upgrade` are always accepted, as the socket and
+   the channel querying algorithms rely on them. */
+class header_filter
+{
+public:
+    // Accepts the always accepted fields only
+    header_filter() = default;
+
+    header_filter(std::initializer_list<header_id::value> ids,
+                  std::initializer_list<string_ref> names = {});
+
+    void allow(header_id::value id);
+
+    // `name` MUST be lowercase
+    void allow(string_ref name);
+
+    /* `id` MUST be the `header_id` of `name` (`header_id::unknown` for names
+       that aren't well-known) */
+    bool accepts(header_id::value id, string_ref name) const;
+
+    bool accepts(string_ref name) const;
+
+private:
+    static const std::size_t nids = header_id::x_forwarded_for + 1;
+
+    std::bitset<nids> ids;
+    // Sorted
+    std::vector<std::string> names;
+};
+
+inline header_filter::header_filter(std::initializer_list<header_id::value> ids,
+                                    std::initializer_list<string_ref> names)
+{
+    for (auto id: ids)
+        allow(id);
+    for (auto name: names)
+        allow(name);
+}
+
+inline void header_filter::allow(header_id::value id)
+{
+    if (id != header_id::unknown)
+        ids.set(id);
+}
+
+inline void header_filter::allow(string_ref name)
+{
+    auto id = to_header_id(name);
+    if (id != header_id::unknown) {
+        ids.set(id);
+        return;
+    }
+
+    auto it = std::lower_bound(names.begin(), names.end(), name,
+                               [](const std::string &a, string_ref b) {
+                                   return string_ref(a) < b;
+                               });
+    if (it == names.end() || string_ref(*it) != name)
+        names.insert(it, std::string(name.data(), name.size()));
+}
+
+inline bool header_filter::accepts(header_id::value id, string_ref name) const
+{
+    switch (id) {
+    case header_id::connection:
+    case header_id::expect:
+    case header_id::upgrade:
+        return true;
+    case header_id::unknown:
+        return std::binary_search(names.begin(), names.end(), name,
+                                  [](string_ref a, string_ref b) {
+                                      return a < b;
+                                  });
+    default:
+        return ids.test(id);
+    }
+}
+
+inline bool header_filter::accepts(string_ref name) const
+{
+    return accepts(to_header_id(name), name);
+}
+
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_HEADER_FILTER_HPP
@@ -0,0 +1,269 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_HEADER_ID_HPP
+#define BOOST_HTTP_HEADER_ID_HPP
+
+#include <cstddef>
+
+#include <boost/utility/string_ref.hpp>
+#include <boost/http/detail/char_class.hpp>
+
+namespace boost {
+namespace http {
+
+struct header_id
+{
+    enum value
+    {
+        unknown,
+        accept,
+        accept_charset,
+        accept_encoding,
+        accept_language,
+        accept_ranges,
+        age,
+        allow,
+        authorization,
+        cache_control,
+        connection,
+        content_disposition,
+        content_encoding,
+        content_language,
+        content_length,
+        content_location,
+        content_range,
+        content_type,
+        cookie,
+        date,
+        etag,
+        expect,
+        expires,
+        forwarded,
+        from,
+        host,
+        if_match,
+        if_modified_since,
+        if_none_match,
+        if_range,
+        if_unmodified_since,
+        keep_alive,
+        last_modified,
+        location,
+        max_forwards,
+        origin,
+        pragma,
+        proxy_authenticate,
+        proxy_authorization,
+        range,
+        referer,
+        retry_after,
+        server,
+        set_cookie,
+        te,
+        trailer,
+        transfer_encoding,
+        upgrade,
+        user_agent,
+        vary,
+        via,
+        warning,
+        www_authenticate,
+        x_forwarded_for
+    };
+};
+
+namespace detail {
+
+struct header_id_slot
+{
+    const char *name;
+    std::size_t size;
+    header_id::value id;
+};
+
+/* Perfect hash over the well-known field names (lowercase, as stored by
+   `basic_socket`). Each name lands in a distinct slot given its size and its
+   first, middle and last octets:
+
+     (size * 229 + f * 169 + l * 202 + m * 136) % 128
+
+   where `f`, `l` and `m` have the 0x20 bit set to fold ASCII case. The
+   multipliers were found by brute-force search and MUST be searched again if
+   the list ever changes (the test suite checks every name). */
+inline const header_id_slot *header_id_table()
+{
+    static const header_id_slot table[128] = {
+            { "if-modified-since", 17, header_id::if_modified_since },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "vary", 4, header_id::vary },
+            { 0, 0, header_id::unknown },
+            { "accept-language", 15, header_id::accept_language },
+            { "set-cookie", 10, header_id::set_cookie },
+            { "warning", 7, header_id::warning },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "etag", 4, header_id::etag },
+            { "pragma", 6, header_id::pragma },
+            { "if-match", 8, header_id::if_match },
+            { 0, 0, header_id::unknown },
+            { "trailer", 7, header_id::trailer },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "accept", 6, header_id::accept },
+            { 0, 0, header_id::unknown },
+            { "content-encoding", 16, header_id::content_encoding },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "referer", 7, header_id::referer },
+            { "age", 3, header_id::age },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "x-forwarded-for", 15, header_id::x_forwarded_for },
+            { 0, 0, header_id::unknown },
+            { "origin", 6, header_id::origin },
+            { "if-none-match", 13, header_id::if_none_match },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "accept-charset", 14, header_id::accept_charset },
+            { 0, 0, header_id::unknown },
+            { "connection", 10, header_id::connection },
+            { "if-unmodified-since", 19, header_id::if_unmodified_since },
+            { "if-range", 8, header_id::if_range },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "te", 2, header_id::te },
+            { "www-authenticate", 16, header_id::www_authenticate },
+            { 0, 0, header_id::unknown },
+            { "expect", 6, header_id::expect },
+            { 0, 0, header_id::unknown },
+            { "content-language", 16, header_id::content_language },
+            { "authorization", 13, header_id::authorization },
+            { "user-agent", 10, header_id::user_agent },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "upgrade", 7, header_id::upgrade },
+            { "cookie", 6, header_id::cookie },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "allow", 5, header_id::allow },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "cache-control", 13, header_id::cache_control },
+            { "last-modified", 13, header_id::last_modified },
+            { "content-range", 13, header_id::content_range },
+            { "keep-alive", 10, header_id::keep_alive },
+            { "accept-ranges", 13, header_id::accept_ranges },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "forwarded", 9, header_id::forwarded },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "content-location", 16, header_id::content_location },
+            { 0, 0, header_id::unknown },
+            { "content-length", 14, header_id::content_length },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "host", 4, header_id::host },
+            { "range", 5, header_id::range },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "location", 8, header_id::location },
+            { 0, 0, header_id::unknown },
+            { "accept-encoding", 15, header_id::accept_encoding },
+            { 0, 0, header_id::unknown },
+            { "from", 4, header_id::from },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "via", 3, header_id::via },
+            { 0, 0, header_id::unknown },
+            { "content-type", 12, header_id::content_type },
+            { "date", 4, header_id::date },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "server", 6, header_id::server },
+            { "content-disposition", 19, header_id::content_disposition },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "retry-after", 11, header_id::retry_after },
+            { "expires", 7, header_id::expires },
+            { "transfer-encoding", 17, header_id::transfer_encoding },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "proxy-authorization", 19, header_id::proxy_authorization },
+            { "proxy-authenticate", 18, header_id::proxy_authenticate },
+            { 0, 0, header_id::unknown },
+            { 0, 0, header_id::unknown },
+            { "max-forwards", 12, header_id::max_forwards }
+    };
+    return table;
+}
+
+inline unsigned char header_id_fold(char c)
+{
+    unsigned char u = static_cast<unsigned char>(c);
+    return has_char_class(u, char_class::alpha) ? (u | 0x20) : u;
+}
+
+} // namespace detail
+
+/* Field names are case-insensitive (section 3.2 of RFC7230). */
+inline header_id::value to_header_id(boost::string_ref name)
+{
+    const std::size_t size = name.size();
+    if (size < 2 || size > 19)
+        return header_id::unknown;
+
+    std::size_t h = size * 229
+        + (static_cast<unsigned char>(name[0]) | 0x20) * 169
+        + (static_cast<unsigned char>(name[size - 1]) | 0x20) * 202
+        + (static_cast<unsigned char>(name[size / 2]) | 0x20) * 136;
+    const detail::header_id_slot &slot = detail::header_id_table()[h % 128];
+
+    if (slot.size != size)
+        return header_id::unknown;
+
+    for (std::size_t i = 0 ; i != size ; ++i) {
+        if (detail::header_id_fold(name[i])
+            != static_cast<unsigned char>(slot.name[i])) {
+            return header_id::unknown;
+        }
+    }
+
+    return slot.id;
+}
+
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_HEADER_ID_HPP
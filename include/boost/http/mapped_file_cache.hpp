@@ -0,0 +1,348 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_MAPPED_FILE_CACHE_HPP
+#define BOOST_HTTP_MAPPED_FILE_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <boost/http/file_metadata_cache.hpp>
+#include <boost/http/detail/singleton.hpp>
+#include <boost/http/detail/native_io.hpp>
+
+#ifndef BOOST_HTTP_MAPPED_FILE_CACHE_DEFAULT_BUDGET
+#define BOOST_HTTP_MAPPED_FILE_CACHE_DEFAULT_BUDGET (std::size_t(64) << 20)
+#endif // BOOST_HTTP_MAPPED_FILE_CACHE_DEFAULT_BUDGET
+
+namespace boost {
+namespace http {
+
+/* A whole file mapped read-only. It stays mapped while any reference to it is
+   alive, even after the cache dropped it. */
+class mapped_file
+{
+public:
+    mapped_file(const mapped_file&) = delete;
+    mapped_file &operator=(const mapped_file&) = delete;
+
+    ~mapped_file();
+
+    const std::uint8_t *data() const
+    {
+        return data_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    // `size` bytes starting at `offset` (the range MUST be within the file)
+    asio::const_buffer buffer(std::uintmax_t offset, std::uintmax_t size) const
+    {
+        return asio::const_buffer(data_ + offset, size);
+    }
+
+private:
+    friend class mapped_file_cache;
+
+    struct identity
+    {
+        std::uintmax_t inode;
+        std::uintmax_t size;
+        std::int_least64_t mtime_sec;
+        long mtime_nsec;
+
+        bool operator==(const identity &o) const
+        {
+            return inode == o.inode && size == o.size
+                && mtime_sec == o.mtime_sec && mtime_nsec == o.mtime_nsec;
+        }
+    };
+
+    mapped_file(const std::uint8_t *data, std::size_t size, identity id,
+                std::shared_ptr<std::atomic<std::size_t>> mapped_size)
+        : data_(data)
+        , size_(size)
+        , id(id)
+        , mapped_size(std::move(mapped_size))
+    {}
+
+    const std::uint8_t *data_;
+    std::size_t size_;
+    identity id;
+    // The owning cache's counter (outlives the cache if needed)
+    std::shared_ptr<std::atomic<std::size_t>> mapped_size;
+};
+
+/* Read-only mappings of regular files, keyed by canonical path and
+   modification time, shared by every user of the same file. Mapped bytes are
+   kept within `budget`: idle mappings are unmapped (least recently used
+   first) to make room and files that still don't fit aren't mapped.
+
+   The files MUST NOT be truncated in place while mapped (replace them by
+   renaming a new file over them). This class is thread-safe. */
+class mapped_file_cache
+{
+public:
+    explicit
+    mapped_file_cache(std::size_t budget
+                      = BOOST_HTTP_MAPPED_FILE_CACHE_DEFAULT_BUDGET)
+        : budget_(budget)
+        , mapped_size_(std::make_shared<std::atomic<std::size_t>>(0))
+    {}
+
+    mapped_file_cache(const mapped_file_cache&) = delete;
+    mapped_file_cache &operator=(const mapped_file_cache&) = delete;
+
+    /* Returns the mapping of `file`, mapping it if it's not cached or was
+       modified since. Returns null if the file can't be mapped (e.g. it's
+       empty, missing or doesn't fit in the budget). */
+    std::shared_ptr<const mapped_file> acquire(const filesystem::path &file);
+
+    /* Same, but a cached mapping matching `metadata` is returned without
+       touching the filesystem. Returns null if the file no longer matches
+       `metadata`. */
+    std::shared_ptr<const mapped_file> acquire(const file_metadata &metadata);
+
+    // Idle mappings above `budget` are released on the next `acquire`
+    void set_budget(std::size_t budget);
+    std::size_t budget() const;
+
+    /* Bytes currently mapped, including mappings the cache dropped but are
+       still referenced */
+    std::size_t mapped_size() const;
+
+    // Number of cached files
+    std::size_t size() const;
+
+    // Drops every entry (referenced mappings stay alive)
+    void clear();
+
+private:
+    typedef std::list<std::pair<std::string,
+                                std::shared_ptr<mapped_file>>> lru_type;
+
+    std::shared_ptr<const mapped_file>
+    acquire(const std::string &path, const mapped_file::identity *expected);
+
+    // Drops idle entries until `size` more bytes fit in the budget
+    bool make_room(std::size_t size);
+
+    mutable std::mutex mutex;
+    std::size_t budget_;
+    std::shared_ptr<std::atomic<std::size_t>> mapped_size_;
+    // Most recently used first
+    lru_type lru;
+    std::unordered_map<std::string, lru_type::iterator> entries;
+};
+
+/* The cache `async_response_transmit_file` serves the files from (none by
+   default). `cache` is not owned and MUST outlive the transmit operations. */
+void set_file_server_cache(mapped_file_cache *cache);
+mapped_file_cache *file_server_cache();
+
+inline mapped_file::~mapped_file()
+{
+#ifdef BOOST_HTTP_DETAIL_HAS_MMAP
+    ::munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif // BOOST_HTTP_DETAIL_HAS_MMAP
+    *mapped_size -= size_;
+}
+
+inline std::shared_ptr<const mapped_file>
+mapped_file_cache::acquire(const filesystem::path &file)
+{
+    system::error_code ec;
+    auto path = filesystem::canonical(file, ec);
+    if (ec)
+        return nullptr;
+
+    return acquire(path.native(), nullptr);
+}
+
+inline std::shared_ptr<const mapped_file>
+mapped_file_cache::acquire(const file_metadata &metadata)
+{
+    if (!metadata.is_regular_file)
+        return nullptr;
+
+    mapped_file::identity id;
+    id.inode = metadata.inode;
+    id.size = metadata.size;
+    id.mtime_sec = metadata.mtime_sec;
+    id.mtime_nsec = metadata.mtime_nsec;
+    return acquire(metadata.canonical_path.native(), &id);
+}
+
+inline std::shared_ptr<const mapped_file>
+mapped_file_cache::acquire(const std::string &path,
+                           const mapped_file::identity *expected)
+{
+#ifdef BOOST_HTTP_DETAIL_HAS_MMAP
+    if (expected) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(path);
+        if (it != entries.end() && it->second->second->id == *expected) {
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return nullptr;
+
+    struct stat st;
+    if (::fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size == 0
+        || std::uintmax_t(st.st_size)
+        > std::numeric_limits<std::size_t>::max()) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    mapped_file::identity id;
+    id.inode = st.st_ino;
+    id.size = st.st_size;
+    id.mtime_sec = st.st_mtime;
+#if defined(__APPLE__)
+    id.mtime_nsec = st.st_mtimespec.tv_nsec;
+#elif defined(__linux__)
+    id.mtime_nsec = st.st_mtim.tv_nsec;
+#else
+    id.mtime_nsec = 0;
+#endif
+
+    // The caller described another file (e.g. its responses use stale headers)
+    if (expected && !(id == *expected)) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = entries.find(path);
+    if (it != entries.end()) {
+        if (it->second->second->id == id) {
+            ::close(fd);
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+
+        // Stale (users of the old contents keep their own reference)
+        lru.erase(it->second);
+        entries.erase(it);
+    }
+
+    std::size_t size = st.st_size;
+    if (!make_room(size)) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    void *data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return nullptr;
+
+    *mapped_size_ += size;
+    std::shared_ptr<mapped_file> ret(new mapped_file(static_cast<const std
+                                                     ::uint8_t*>(data),
+                                                     size, id, mapped_size_));
+    lru.emplace_front(path, ret);
+    entries.emplace(path, lru.begin());
+    return ret;
+#else
+    (void)path;
+    (void)expected;
+    return nullptr;
+#endif // BOOST_HTTP_DETAIL_HAS_MMAP
+}
+
+inline bool mapped_file_cache::make_room(std::size_t size)
+{
+    if (size > budget_)
+        return false;
+
+    /* Only the cache references an idle entry, and new references are only
+       handed out under the lock */
+    for (auto it = lru.end() ; it != lru.begin()
+             && *mapped_size_ > budget_ - size ;) {
+        --it;
+        if (it->second.use_count() != 1)
+            continue;
+
+        entries.erase(it->first);
+        it = lru.erase(it);
+    }
+
+    return *mapped_size_ <= budget_ - size;
+}
+
+inline void mapped_file_cache::set_budget(std::size_t budget)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    budget_ = budget;
+}
+
+inline std::size_t mapped_file_cache::budget() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return budget_;
+}
+
+inline std::size_t mapped_file_cache::mapped_size() const
+{
+    return *mapped_size_;
+}
+
+inline std::size_t mapped_file_cache::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+inline void mapped_file_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lru.clear();
+}
+
+namespace detail {
+
+struct file_server_cache_tag;
+
+} // namespace detail
+
+inline void set_file_server_cache(mapped_file_cache *cache)
+{
+    detail::singleton<std::atomic<mapped_file_cache*>,
+                      detail::file_server_cache_tag>::instance = cache;
+}
+
+inline mapped_file_cache *file_server_cache()
+{
+    return detail::singleton<std::atomic<mapped_file_cache*>,
+                             detail::file_server_cache_tag>::instance;
+}
+
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_MAPPED_FILE_CACHE_HPP
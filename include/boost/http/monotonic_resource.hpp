@@ -0,0 +1,345 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+#ifndef BOOST_HTTP_MONOTONIC_RESOURCE_HPP
+#define BOOST_HTTP_MONOTONIC_RESOURCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/http/traits.hpp>
+
+namespace boost {
+namespace http {
+
+/* Bump allocator carving chunks out of a few big blocks. Nothing is freed
+   individually: deallocations are only counted, and once every allocation is
+   given back `release` rewinds the resource at once (keeping the largest block
+   for the next round). The destructor frees the blocks. Blocks never move, so
+   moving the resource keeps the handed out pointers valid.
+
+   Meant to hold everything allocated for a single exchange (one per
+   connection). This class is not thread-safe. */
+class monotonic_resource
+{
+public:
+    explicit monotonic_resource(std::size_t initial_size = 1024)
+        : next_size(initial_size ? initial_size : 1)
+    {}
+
+    monotonic_resource(const monotonic_resource&) = delete;
+    monotonic_resource &operator=(const monotonic_resource&) = delete;
+
+    monotonic_resource(monotonic_resource &&o)
+        : blocks(o.blocks)
+        , current(o.current)
+        , available(o.available)
+        , next_size(o.next_size)
+        , nlive(o.nlive)
+    {
+        o.blocks = nullptr;
+        o.current = nullptr;
+        o.available = 0;
+        o.nlive = 0;
+    }
+
+    monotonic_resource &operator=(monotonic_resource &&o)
+    {
+        if (this == &o)
+            return *this;
+
+        free_blocks(blocks);
+        blocks = o.blocks;
+        current = o.current;
+        available = o.available;
+        next_size = o.next_size;
+        nlive = o.nlive;
+        o.blocks = nullptr;
+        o.current = nullptr;
+        o.available = 0;
+        o.nlive = 0;
+        return *this;
+    }
+
+    ~monotonic_resource()
+    {
+        free_blocks(blocks);
+    }
+
+    void *allocate(std::size_t size,
+                   std::size_t alignment = alignof(std::max_align_t))
+    {
+        std::size_t padding = (alignment - reinterpret_cast<std::uintptr_t>
+                               (current) % alignment) % alignment;
+
+        if (!current || padding + size > available) {
+            grow(size + alignment);
+            padding = (alignment - reinterpret_cast<std::uintptr_t>(current)
+                       % alignment) % alignment;
+        }
+
+        char *ret = current + padding;
+        current = ret + size;
+        available -= padding + size;
+        ++nlive;
+        return ret;
+    }
+
+    // Only counted (memory is given back by `release`)
+    void deallocate(void*, std::size_t,
+                    std::size_t = alignof(std::max_align_t))
+    {
+        --nlive;
+    }
+
+    /* Rewinds the resource if every allocation was deallocated (see
+       `reset_message`). Returns whether it did (memory still in use is never
+       handed out again). */
+    bool release()
+    {
+        if (nlive != 0)
+            return false;
+
+        if (!blocks)
+            return true;
+
+        // The most recent block is also the largest one
+        free_blocks(blocks->next);
+        blocks->next = nullptr;
+        current = data(blocks);
+        available = blocks->size;
+        return true;
+    }
+
+    // Number of allocations not deallocated yet
+    std::size_t live_allocations() const
+    {
+        return nlive;
+    }
+
+    // Number of blocks owned (i.e. heap allocations done since the last
+    // release)
+    std::size_t nblocks() const
+    {
+        std::size_t n = 0;
+        for (auto b = blocks ; b ; b = b->next)
+            ++n;
+        return n;
+    }
+
+private:
+    struct block
+    {
+        block *next;
+        std::size_t size;
+    };
+
+    static const std::size_t header_size
+        = (sizeof(block) + alignof(std::max_align_t) - 1)
+        / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    static char *data(block *b)
+    {
+        return reinterpret_cast<char*>(b) + header_size;
+    }
+
+    static void free_blocks(block *b)
+    {
+        while (b) {
+            block *next = b->next;
+            ::operator delete(b);
+            b = next;
+        }
+    }
+
+    void grow(std::size_t min_size)
+    {
+        while (next_size < min_size)
+            next_size *= 2;
+
+        block *b = static_cast<block*>(::operator new(header_size
+                                                      + next_size));
+        b->next = blocks;
+        b->size = next_size;
+        blocks = b;
+        current = data(b);
+        available = next_size;
+        next_size *= 2;
+    }
+
+    block *blocks = nullptr;
+    char *current = nullptr;
+    std::size_t available = 0;
+    std::size_t next_size;
+    std::size_t nlive = 0;
+};
+
+/* Allocator drawing from a `monotonic_resource` (or from the global heap when
+   default constructed). Like `std::pmr::polymorphic_allocator`, it's never
+   propagated, so copies of a container live in the global heap and the
+   resource is only shared by objects built with it. */
+template<class T>
+class resource_allocator
+{
+public:
+    typedef T value_type;
+
+    typedef std::false_type propagate_on_container_copy_assignment;
+    typedef std::false_type propagate_on_container_move_assignment;
+    typedef std::false_type propagate_on_container_swap;
+
+    resource_allocator() = default;
+
+    resource_allocator(monotonic_resource *resource)
+        : resource_(resource)
+    {}
+
+    template<class U>
+    resource_allocator(const resource_allocator<U> &o)
+        : resource_(o.resource())
+    {}
+
+    T *allocate(std::size_t n)
+    {
+        if (!resource_)
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+
+        return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n)
+    {
+        if (!resource_)
+            ::operator delete(p);
+        else
+            resource_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    resource_allocator select_on_container_copy_construction() const
+    {
+        return resource_allocator();
+    }
+
+    monotonic_resource *resource() const
+    {
+        return resource_;
+    }
+
+private:
+    monotonic_resource *resource_ = nullptr;
+};
+
+template<class T, class U>
+bool operator==(const resource_allocator<T> &a, const resource_allocator<U> &b)
+{
+    return a.resource() == b.resource();
+}
+
+template<class T, class U>
+bool operator!=(const resource_allocator<T> &a, const resource_allocator<U> &b)
+{
+    return a.resource() != b.resource();
+}
+
+typedef std::basic_string<char, std::char_traits<char>,
+                          resource_allocator<char>>
+resource_string;
+
+typedef std::vector<std::uint8_t, resource_allocator<std::uint8_t>>
+resource_body;
+
+namespace detail {
+
+template<class T>
+auto reset_member(T &member, int)
+    -> decltype(member.get_allocator(), void())
+{
+    /* Move assignment may keep the old buffer (e.g. `std::string` copying a
+       short string into it), but a swap always hands it to the temporary. */
+    T(member.get_allocator()).swap(member);
+}
+
+template<class T>
+void reset_member(T &member, long)
+{
+    member.clear();
+}
+
+template<class Message>
+void reset_message(Message &message, std::true_type /*is_request*/)
+{
+    reset_member(message.method(), 0);
+    reset_member(message.target(), 0);
+}
+
+template<class Message>
+void reset_message(Message &message, std::false_type /*is_request*/)
+{
+    reset_member(message.reason_phrase(), 0);
+}
+
+/* Empties `member`, giving its memory back if it draws from a
+   `monotonic_resource` (which is stored in `resource`). Other members keep
+   their capacity. */
+template<class T>
+auto recycle_member(T &member, monotonic_resource *&resource, int)
+    -> decltype(member.get_allocator().resource(), void())
+{
+    if (auto r = member.get_allocator().resource()) {
+        resource = r;
+        T(member.get_allocator()).swap(member);
+        return;
+    }
+
+    member.clear();
+}
+
+template<class T>
+void recycle_member(T &member, monotonic_resource *&, long)
+{
+    member.clear();
+}
+
+/* Empties `request` before the next one is read into it and rewinds its
+   `monotonic_resource` (if any and nothing else holds memory from it) */
+template<class Request>
+void recycle_request(Request &request)
+{
+    monotonic_resource *resource = nullptr;
+    recycle_member(request.method(), resource, 0);
+    recycle_member(request.target(), resource, 0);
+    recycle_member(request.headers(), resource, 0);
+    recycle_member(request.body(), resource, 0);
+    recycle_member(request.trailers(), resource, 0);
+    if (resource)
+        resource->release();
+}
+
+} // namespace detail
+
+/* Empties `message` so no member keeps memory handed out by its allocator
+   (unlike `clear`, which keeps the capacity). A `monotonic_resource` is only
+   rewound once every message using it is reset. */
+template<class Message>
+void reset_message(Message &message)
+{
+    static_assert(is_message<Message>::value,
+                  "Message must fulfill the Message concept");
+
+    detail::reset_message(message, is_request_message<Message>{});
+    detail::reset_member(message.headers(), 0);
+    detail::reset_member(message.body(), 0);
+    detail::reset_member(message.trailers(), 0);
+}
+
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_MONOTONIC_RESOURCE_HPP
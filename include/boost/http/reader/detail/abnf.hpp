@@ -7,42 +7,40 @@
 #ifndef BOOST_HTTP_READER_DETAIL_ABNF_HPP
 #define BOOST_HTTP_READER_DETAIL_ABNF_HPP
 
+#include <boost/http/detail/char_class.hpp>
+
 namespace boost {
 namespace http {
 namespace reader {
 namespace detail {
 
+/* All predicates are lookups in the shared table from
+   `boost/http/detail/char_class.hpp`. */
+
 inline bool isalpha(unsigned char c)
 {
-    /* ALPHA          =  %x41-5A / %x61-7A   ; A-Z / a-z
-
-       from Appendix B of RFC5234. */
-    return (c >= 0x41 && c <= 0x5A) || (c >= 0x61 && c <= 0x7A);
+    return http::detail::has_char_class(c, http::detail::char_class::alpha);
 }
 
 inline bool isdigit(unsigned char c)
 {
-    /* DIGIT          =  %x30-39   ; 0-9
-
-       from Appendix B of RFC5234. */
-    return c >= 0x30 && c <= 0x39;
+    return http::detail::has_char_class(c, http::detail::char_class::digit);
 }
 
 inline bool isalnum(unsigned char c)
 {
-    return isalpha(c) || isdigit(c);
+    return http::detail::has_char_class(c, http::detail::char_class::alnum);
 }
 
 inline bool is_tchar(unsigned char c)
 {
-    switch (c) {
-    case '!': case '#': case '$': case '%': case '&': case '\'': case '*':
-    case '+': case '-': case '.': case '^': case '_': case '`': case '|':
-    case '~':
-        return true;
-    default:
-        return isalnum(c);
-    }
+    return http::detail::has_char_class(c, http::detail::char_class::tchar);
+}
+
+inline bool is_request_target_char(unsigned char c)
+{
+    return http::detail::has_char_class(c, http::detail::char_class
+                                        ::request_target);
 }
 
 inline bool is_sp(unsigned char c)
@@ -52,42 +50,31 @@ inline bool is_sp(unsigned char c)
 
 inline bool is_vchar(unsigned char c)
 {
-    return c >= '\x21' && c <= '\x7E';
+    return http::detail::has_char_class(c, http::detail::char_class::vchar);
 }
 
 inline bool is_obs_text(unsigned char c)
 {
-    return c >= 0x80
-        // && c <= 0xFF <- This is always true for unsigned char
-        ;
+    return http::detail::has_char_class(c, http::detail::char_class::obs_text);
 }
 
 inline bool is_ows(unsigned char c)
 {
-    switch (c) {
-    case '\x20':
-    case '\x09':
-        return true;
-    default:
-        return false;
-    }
+    return http::detail::has_char_class(c, http::detail::char_class::ows);
 }
 
+/* chunk-ext as accepted by this parser: any field-value char. */
 inline bool is_chunk_ext_char(unsigned char c)
 {
-    switch (c) {
-    case ';':
-    case '=':
-    case '"':
-    case '\t':
-    case ' ':
-    case '!':
-    case '\\':
-        return true;
-    default:
-        return is_tchar(c) || (c >= 0x23 && c <= 0x5B)
-            || (c >= 0x5D && c <= 0x7E) || is_obs_text(c) || is_vchar(c);
-    }
+    return http::detail::has_char_class(c, http::detail::char_class
+                                        ::field_value);
+}
+
+/* field-vchar / OWS. */
+inline bool is_field_value_char(unsigned char c)
+{
+    return http::detail::has_char_class(c, http::detail::char_class
+                                        ::field_value);
 }
 
 } // namespace detail
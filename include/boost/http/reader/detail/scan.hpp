@@ -0,0 +1,313 @@
+/* Copyright (c) 2016 Vinícius dos Santos Oliveira
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt) */
+
+
+#ifndef BOOST_HTTP_READER_DETAIL_SCAN_HPP
+#define BOOST_HTTP_READER_DETAIL_SCAN_HPP
+
+#include <cstddef>
+
+#include <boost/http/reader/detail/abnf.hpp>
+
+/* The SIMD kernels are only compiled on x86 with compilers that allow us to
+   enable instruction sets per function (GCC, Clang) or that always expose every
+   intrinsic (MSVC). Define `BOOST_HTTP_NO_SIMD` to force the scalar code. */
+#if !defined(BOOST_HTTP_NO_SIMD)
+# if (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#  define BOOST_HTTP_DETAIL_SIMD_X86 1
+#  define BOOST_HTTP_DETAIL_TARGET(x) __attribute__((target(x)))
+#  include <immintrin.h>
+# elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  define BOOST_HTTP_DETAIL_SIMD_X86 1
+#  define BOOST_HTTP_DETAIL_TARGET(x)
+#  include <intrin.h>
+#  include <immintrin.h>
+# endif
+#endif // !defined(BOOST_HTTP_NO_SIMD)
+
+namespace boost {
+namespace http {
+namespace reader {
+namespace detail {
+
+enum simd_level_t {
+    SIMD_NONE,
+    SIMD_SSE42,
+    SIMD_AVX2
+};
+
+/* A set of bytes in the layout used by the vectorized kernels.
+
+   `nibbles[lo]` has bit `hi` set if the byte `(hi << 4) | lo` (for `hi < 8`)
+   belongs to the set. Bytes `>= 0x80` (obs-text) are either all in the set or
+   all out of it, as given by `accept_high`. The scalar predicate `contains`
+   remains the reference definition and the tables MUST agree with it. */
+struct tchar_set
+{
+    static bool contains(unsigned char c)
+    {
+        return is_tchar(c);
+    }
+
+    static const unsigned char *nibbles()
+    {
+        static const unsigned char table[16] = {
+            0xE8, 0xFC, 0xF8, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC,
+            0xF8, 0xF8, 0xF4, 0x54, 0xD0, 0x54, 0xF4, 0x70
+        };
+        return table;
+    }
+
+    static bool accept_high()
+    {
+        return false;
+    }
+};
+
+struct request_target_set
+{
+    static bool contains(unsigned char c)
+    {
+        return is_request_target_char(c);
+    }
+
+    static const unsigned char *nibbles()
+    {
+        static const unsigned char table[16] = {
+            0xB8, 0xFC, 0xF8, 0xF8, 0xFC, 0xFC, 0xFC, 0xFC,
+            0xFC, 0xFC, 0xFC, 0x5C, 0x54, 0x5C, 0xD4, 0x7C
+        };
+        return table;
+    }
+
+    static bool accept_high()
+    {
+        return false;
+    }
+};
+
+/* field-vchar / OWS / obs-text. The same set describes reason-phrase and (as
+   far as this parser cares) chunk-ext. */
+struct field_value_set
+{
+    static bool contains(unsigned char c)
+    {
+        return is_field_value_char(c);
+    }
+
+    static const unsigned char *nibbles()
+    {
+        static const unsigned char table[16] = {
+            0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC,
+            0xFC, 0xFD, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0x7C
+        };
+        return table;
+    }
+
+    static bool accept_high()
+    {
+        return true;
+    }
+};
+
+template<class CharSet>
+std::size_t scan_scalar(const unsigned char *data, std::size_t size)
+{
+    std::size_t i = 0;
+    for ( ; i != size ; ++i) {
+        if (!CharSet::contains(data[i]))
+            break;
+    }
+    return i;
+}
+
+#ifdef BOOST_HTTP_DETAIL_SIMD_X86
+
+inline int detect_simd_level()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    int nids = info[0];
+
+    __cpuid(info, 1);
+    const bool ssse3 = (info[2] & (1 << 9)) != 0;
+    const bool sse42 = (info[2] & (1 << 20)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+
+    if (!ssse3 || !sse42)
+        return SIMD_NONE;
+
+    if (nids >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(info, 7, 0);
+        if (info[1] & (1 << 5))
+            return SIMD_AVX2;
+    }
+
+    return SIMD_SSE42;
+#else
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        return SIMD_AVX2;
+
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("ssse3"))
+        return SIMD_SSE42;
+
+    return SIMD_NONE;
+#endif
+}
+
+#else // BOOST_HTTP_DETAIL_SIMD_X86
+
+inline int detect_simd_level()
+{
+    return SIMD_NONE;
+}
+
+#endif // BOOST_HTTP_DETAIL_SIMD_X86
+
+/* The detected level is cached on first use. It's exposed as a reference so
+   tests and benchmarks can force a lower tier (never a higher one). */
+inline int &simd_level()
+{
+    static int level = detect_simd_level();
+    return level;
+}
+
+#ifdef BOOST_HTTP_DETAIL_SIMD_X86
+
+/* Vectorized set membership (Muła's nibble lookup): the low nibble selects a
+   row of the bitmap through `pshufb` and the high nibble selects the bit
+   within the row. Returns the number of leading bytes that belong to the set.
+   Only whole blocks are processed here; the caller finishes the tail. */
+BOOST_HTTP_DETAIL_TARGET("sse4.2,ssse3")
+inline std::size_t scan_sse42(const unsigned char *data, std::size_t size,
+                              const unsigned char *nibbles, bool accept_high)
+{
+    const __m128i bitmap
+        = _mm_loadu_si128(reinterpret_cast<const __m128i*>(nibbles));
+    const __m128i bit_lookup = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64,
+                                             static_cast<char>(128),
+                                             0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i high_accept = accept_high ? _mm_set1_epi8(-1) : zero;
+
+    std::size_t i = 0;
+    for ( ; i + 16 <= size ; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data
+                                                                     + i));
+        __m128i lo = _mm_and_si128(v, low_mask);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), low_mask);
+        __m128i row = _mm_shuffle_epi8(bitmap, lo);
+        __m128i bit = _mm_shuffle_epi8(bit_lookup, hi);
+        __m128i in_set = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_and_si128(row,
+                                                                       bit),
+                                                         zero),
+                                          _mm_set1_epi8(-1));
+        // obs-text: bytes whose sign bit is set
+        in_set = _mm_or_si128(in_set,
+                              _mm_and_si128(_mm_cmplt_epi8(v, zero),
+                                            high_accept));
+        int mask = ~_mm_movemask_epi8(in_set) & 0xFFFF;
+        if (mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long idx;
+            _BitScanForward(&idx, mask);
+            return i + idx;
+#else
+            return i + __builtin_ctz(mask);
+#endif
+        }
+    }
+    return i;
+}
+
+BOOST_HTTP_DETAIL_TARGET("avx2")
+inline std::size_t scan_avx2(const unsigned char *data, std::size_t size,
+                             const unsigned char *nibbles, bool accept_high)
+{
+    const __m256i bitmap = _mm256_broadcastsi128_si256
+        (_mm_loadu_si128(reinterpret_cast<const __m128i*>(nibbles)));
+    const __m256i bit_lookup
+        = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, static_cast<char>(128),
+                           0, 0, 0, 0, 0, 0, 0, 0,
+                           1, 2, 4, 8, 16, 32, 64, static_cast<char>(128),
+                           0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi8(-1);
+    const __m256i high_accept = accept_high ? ones : zero;
+
+    std::size_t i = 0;
+    for ( ; i + 32 <= size ; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data
+                                                                        + i));
+        __m256i lo = _mm256_and_si256(v, low_mask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        __m256i row = _mm256_shuffle_epi8(bitmap, lo);
+        __m256i bit = _mm256_shuffle_epi8(bit_lookup, hi);
+        __m256i in_set
+            = _mm256_andnot_si256(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit),
+                                                    zero),
+                                  ones);
+        in_set = _mm256_or_si256(in_set,
+                                 _mm256_and_si256(_mm256_cmpgt_epi8(zero, v),
+                                                  high_accept));
+        unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(in_set));
+        if (mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long idx;
+            _BitScanForward(&idx, mask);
+            return i + idx;
+#else
+            return i + __builtin_ctz(mask);
+#endif
+        }
+    }
+
+    // 16-byte leftover block
+    return i + scan_sse42(data + i, size - i, nibbles, accept_high);
+}
+
+#endif // BOOST_HTTP_DETAIL_SIMD_X86
+
+/* Returns the number of leading bytes in [data, data + size) that belong to
+   `CharSet`. */
+template<class CharSet>
+std::size_t scan(const unsigned char *data, std::size_t size)
+{
+    std::size_t i = 0;
+
+#ifdef BOOST_HTTP_DETAIL_SIMD_X86
+    // Tokens such as method and version are tiny. Don't pay dispatch for them.
+    if (size >= 16) {
+        switch (simd_level()) {
+        case SIMD_AVX2:
+            i = scan_avx2(data, size, CharSet::nibbles(),
+                          CharSet::accept_high());
+            break;
+        case SIMD_SSE42:
+            i = scan_sse42(data, size, CharSet::nibbles(),
+                           CharSet::accept_high());
+            break;
+        default:
+            break;
+        }
+    }
+#endif // BOOST_HTTP_DETAIL_SIMD_X86
+
+    return i + scan_scalar<CharSet>(data + i, size - i);
+}
+
+} // namespace detail
+} // namespace reader
+} // namespace http
+} // namespace boost
+
+#endif // BOOST_HTTP_READER_DETAIL_SCAN_HPP
@@ -23,6 +23,7 @@
 #include <boost/http/detail/macros.hpp>
 #include <boost/http/reader/detail/transfer_encoding.hpp>
 #include <boost/http/reader/detail/abnf.hpp>
+#include <boost/http/reader/detail/scan.hpp>
 #include <boost/http/reader/detail/common.hpp>
 
 // public
@@ -72,6 +73,23 @@ public:
 
     size_type parsed_count() const;
 
+    /* Whether the header section declared the length of the body (i.e. it
+       isn't chunked). Only meaningful from `end_of_headers` until the next
+       message starts. */
+    bool body_length_known() const;
+
+    // The declared body length (0 for messages without body)
+    uint_least64_t body_length() const;
+
+    /* Body bytes of a message with declared length that weren't delivered yet
+       (0 when the parser isn't in the middle of such body). */
+    uint_least64_t body_remaining() const;
+
+    /* Tells the parser `n` body bytes were consumed without going through the
+       buffer (e.g. read straight into their final storage). Only valid while
+       `code()` is `error_insufficient_data` and `n <= body_remaining()`. */
+    void consume_body(uint_least64_t n);
+
 private:
     enum State {
         ERRORED,
@@ -146,6 +164,15 @@ private:
        already parsed from current token. Otherwise, it contains the token
        size. */
     size_type token_size_;
+
+    /* Classification of the last `field_name`/`trailer_name` token. Only
+       meaningful while `code_` is one of them. */
+    header_id::value field_id;
+
+    // Set on `end_of_headers`
+    bool body_length_known_;
+    uint_least64_t body_length_;
+
     boost::asio::const_buffer ibuffer;
 };
 
@@ -2,22 +2,6 @@ namespace boost {
 namespace http {
 namespace reader {
 
-namespace detail {
-
-inline bool is_request_target_char(unsigned char c)
-{
-    switch (c) {
-    case '?': case '/': case '-': case '.': case '_': case '~': case '%':
-    case '!': case '$': case '&': case '\'': case '(': case ')': case '*':
-    case '+': case ',': case ';': case '=': case ':': case '@':
-        return true;
-    default:
-        return isalnum(c);
-    }
-}
-
-} // namespace detail
-
 inline
 request::request()
     : body_type(NO_BODY)
@@ -25,6 +9,9 @@ request::request()
     , code_(token::code::error_insufficient_data)
     , idx(0)
     , token_size_(0)
+    , field_id(header_id::unknown)
+    , body_length_known_(false)
+    , body_length_(0)
 {}
 
 inline void request::reset()
@@ -34,6 +21,9 @@ inline void request::reset()
     code_ = token::code::error_insufficient_data;
     idx = 0;
     token_size_ = 0;
+    field_id = header_id::unknown;
+    body_length_known_ = false;
+    body_length_ = 0;
     ibuffer = asio::const_buffer();
 }
 
@@ -81,6 +71,15 @@ request::view_type request::value<token::field_name>() const
                      token_size_);
 }
 
+template<> inline
+header_id::value request::value<token::field_name_id>() const
+{
+    // It accepts “implicit conversion” from `trailer_name`
+    assert(code_ == token::field_name::code
+           || code_ == token::trailer_name::code);
+    return field_id;
+}
+
 template<> inline
 request::view_type request::value<token::field_value>() const
 {
@@ -170,6 +169,34 @@ inline request::size_type request::parsed_count() const
     return idx;
 }
 
+inline bool request::body_length_known() const
+{
+    return body_length_known_;
+}
+
+inline uint_least64_t request::body_length() const
+{
+    return body_length_;
+}
+
+inline uint_least64_t request::body_remaining() const
+{
+    return state == EXPECT_BODY ? body_size : 0;
+}
+
+inline void request::consume_body(uint_least64_t n)
+{
+    assert(code_ == token::code::error_insufficient_data);
+    assert(n <= body_remaining());
+
+    if (n == 0)
+        return;
+
+    body_size -= n;
+    if (body_size == 0)
+        state = EXPECT_END_OF_BODY;
+}
+
 inline void request::next()
 {
     if (state == ERRORED)
@@ -212,21 +239,22 @@ inline void request::next()
     switch (state) {
     case EXPECT_METHOD:
         {
+            const unsigned char *data
+                = asio::buffer_cast<const unsigned char*>(ibuffer);
             size_type i = idx + token_size_;
-            for ( ; i != asio::buffer_size(ibuffer) ; ++i) {
-                unsigned char c
-                    = asio::buffer_cast<const unsigned char*>(ibuffer)[i];
-                if (!detail::is_tchar(c)) {
-                    if (i != idx) {
-                        state = EXPECT_SP_AFTER_METHOD;
-                        code_ = token::code::method;
-                        token_size_ = i - idx;
-                    } else {
-                        state = ERRORED;
-                        code_ = token::code::error_invalid_data;
-                    }
-                    return;
+            i += detail::scan<detail::tchar_set>(data + i,
+                                                 asio::buffer_size(ibuffer)
+                                                 - i);
+            if (i != asio::buffer_size(ibuffer)) {
+                if (i != idx) {
+                    state = EXPECT_SP_AFTER_METHOD;
+                    code_ = token::code::method;
+                    token_size_ = i - idx;
+                } else {
+                    state = ERRORED;
+                    code_ = token::code::error_invalid_data;
                 }
+                return;
             }
             token_size_ = i - idx;
             return;
@@ -246,11 +274,13 @@ inline void request::next()
             return;
         }
     case EXPECT_REQUEST_TARGET:
-        for (size_type i = idx + token_size_ ; i != asio::buffer_size(ibuffer)
-                 ; ++i) {
-            unsigned char c
-                = asio::buffer_cast<const unsigned char*>(ibuffer)[i];
-            if (!detail::is_request_target_char(c)) {
+        {
+            const unsigned char *data
+                = asio::buffer_cast<const unsigned char*>(ibuffer);
+            size_type i = idx + token_size_;
+            i += detail::scan<detail::request_target_set>
+                (data + i, asio::buffer_size(ibuffer) - i);
+            if (i != asio::buffer_size(ibuffer)) {
                 if (i != idx) {
                     state = EXPECT_STATIC_STR_AFTER_TARGET;
                     code_ = token::code::request_target;
@@ -261,9 +291,9 @@ inline void request::next()
                 }
                 return;
             }
+            token_size_ = i - idx;
+            return;
         }
-        token_size_ = asio::buffer_size(ibuffer) - idx;
-        return;
     case EXPECT_STATIC_STR_AFTER_TARGET:
         {
             unsigned char skip[] = {' ', 'H', 'T', 'T', 'P', '/', '1', '.'};
@@ -329,10 +359,9 @@ inline void request::next()
         }
     case EXPECT_FIELD_NAME:
         {
-            using boost::algorithm::iequals;
-            typedef syntax::field_name<unsigned char> field_name;
-
-            std::size_t nmatched = field_name::match(rest_view);
+            std::size_t nmatched
+                = detail::scan<detail::tchar_set>(rest_view.data(),
+                                                  rest_view.size());
 
             if (nmatched == 0) {
                 state = EXPECT_CRLF_AFTER_HEADERS;
@@ -352,8 +381,9 @@ inline void request::next()
                - CONTENT_LENGTH_READ
                - CHUNKED_ENCODING_READ
                - RANDOM_ENCODING_READ */
-            string_ref field = value<token::field_name>();
-            if (iequals(field, "Host")) {
+            field_id = to_header_id(value<token::field_name>());
+            switch (field_id) {
+            case header_id::host:
                 /* A server MUST respond with a 400 (Bad Request) status code to
                    any HTTP/1.1 request message that lacks a Host header field
                    and to any request mesage that contains more than one Host
@@ -370,7 +400,8 @@ inline void request::next()
                     code_ = token::code::error_no_host;
                     return;
                 }
-            } else if (iequals(field, "Transfer-Encoding")) {
+                break;
+            case header_id::transfer_encoding:
                 switch (body_type) {
                 case CONTENT_LENGTH_READ:
                     /* Transfer-Encoding overrides Content-Length (section 3.3.3
@@ -386,7 +417,8 @@ inline void request::next()
                 default:
                     BOOST_HTTP_DETAIL_UNREACHABLE("");
                 }
-            } else if (iequals(field, "Content-Length")) {
+                break;
+            case header_id::content_length:
                 switch (body_type) {
                 case NO_BODY:
                     body_type = READING_CONTENT_LENGTH;
@@ -403,6 +435,9 @@ inline void request::next()
                 default:
                     BOOST_HTTP_DETAIL_UNREACHABLE("");
                 }
+                break;
+            default:
+                break;
             }
 
             return;
@@ -448,10 +483,11 @@ inline void request::next()
         }
     case EXPECT_FIELD_VALUE:
         {
-            typedef syntax::left_trimmed_field_value<unsigned char> field_value;
             typedef syntax::content_length<char> content_length;
 
-            std::size_t nmatched = field_value::match(rest_view);
+            std::size_t nmatched
+                = detail::scan<detail::field_value_set>(rest_view.data(),
+                                                        rest_view.size());
 
             if (nmatched == rest_view.size())
                 return;
@@ -581,6 +617,8 @@ inline void request::next()
                 return;
             }
 
+            body_length_known_ = true;
+            body_length_ = 0;
             switch (body_type) {
             case RANDOM_ENCODING_READ:
                 state = ERRORED;
@@ -590,9 +628,11 @@ inline void request::next()
                 state = EXPECT_END_OF_BODY;
                 break;
             case CHUNKED_ENCODING_READ:
+                body_length_known_ = false;
                 state = EXPECT_CHUNK_SIZE;
                 break;
             case CONTENT_LENGTH_READ:
+                body_length_ = body_size;
                 if (body_size == 0) {
                     state = EXPECT_END_OF_BODY;
                     break;
@@ -661,12 +701,14 @@ inline void request::next()
         }
     case EXPECT_CHUNK_EXT:
         {
+            const unsigned char *data
+                = asio::buffer_cast<const unsigned char*>(ibuffer);
             size_type i = idx + token_size_;
-            for ( ; i != asio::buffer_size(ibuffer) ; ++i) {
-                unsigned char c
-                    = asio::buffer_cast<const unsigned char*>(ibuffer)[i];
-                if (detail::is_chunk_ext_char(c))
-                    continue;
+            i += detail::scan<detail::field_value_set>(data + i,
+                                                       asio::buffer_size(ibuffer)
+                                                       - i);
+            if (i != asio::buffer_size(ibuffer)) {
+                unsigned char c = data[i];
 
                 if (c != '\r') {
                     state = ERRORED;
@@ -746,9 +788,9 @@ inline void request::next()
         }
     case EXPECT_TRAILER_NAME:
         {
-            typedef syntax::field_name<unsigned char> field_name;
-
-            std::size_t nmatched = field_name::match(rest_view);
+            std::size_t nmatched
+                = detail::scan<detail::tchar_set>(rest_view.data(),
+                                                  rest_view.size());
 
             if (nmatched == 0) {
                 state = EXPECT_CRLF_AFTER_TRAILERS;
@@ -761,6 +803,7 @@ inline void request::next()
             state = EXPECT_TRAILER_COLON;
             code_ = token::code::trailer_name;
             token_size_ = nmatched;
+            field_id = to_header_id(value<token::trailer_name>());
             return;
         }
     case EXPECT_TRAILER_COLON:
@@ -804,9 +847,9 @@ inline void request::next()
         }
     case EXPECT_TRAILER_VALUE:
         {
-            typedef syntax::left_trimmed_field_value<unsigned char> field_value;
-
-            std::size_t nmatched = field_value::match(rest_view);
+            std::size_t nmatched
+                = detail::scan<detail::field_value_set>(rest_view.data(),
+                                                        rest_view.size());
 
             if (nmatched == rest_view.size())
                 return;
@@ -2,22 +2,6 @@ namespace boost {
 namespace http {
 namespace reader {
 
-namespace detail {
-
-inline bool is_request_target_char(unsigned char c)
-{
-    switch (c) {
-    case '?': case '/': case '-': case '.': case '_': case '~': case '%':
-    case '!': case '$': case '&': case '\'': case '(': case ')': case '*':
-    case '+': case ',': case ';': case '=': case ':': case '@':
-        return true;
-    default:
-        return isalnum(c);
-    }
-}
-
-} // namespace detail
-
 inline
 response::response()
     : eof(false)
@@ -26,6 +10,9 @@ response::response()
     , code_(token::code::error_insufficient_data)
     , idx(0)
     , token_size_(0)
+    , field_id(header_id::unknown)
+    , body_length_known_(false)
+    , body_length_(0)
 {}
 
 template<>
@@ -67,6 +54,9 @@ inline void response::reset()
     code_ = token::code::error_insufficient_data;
     idx = 0;
     token_size_ = 0;
+    field_id = header_id::unknown;
+    body_length_known_ = false;
+    body_length_ = 0;
     ibuffer = asio::const_buffer();
 }
 
@@ -111,6 +101,15 @@ response::view_type response::value<token::field_name>() const
                      token_size_);
 }
 
+template<> inline
+header_id::value response::value<token::field_name_id>() const
+{
+    // It accepts “implicit conversion” from `trailer_name`
+    assert(code_ == token::field_name::code
+           || code_ == token::trailer_name::code);
+    return field_id;
+}
+
 template<>
 response::view_type response::value<token::field_value>() const
 {
@@ -204,6 +203,34 @@ inline response::size_type response::parsed_count() const
     return idx;
 }
 
+inline bool response::body_length_known() const
+{
+    return body_length_known_;
+}
+
+inline uint_least64_t response::body_length() const
+{
+    return body_length_;
+}
+
+inline uint_least64_t response::body_remaining() const
+{
+    return state == EXPECT_BODY ? body_size : 0;
+}
+
+inline void response::consume_body(uint_least64_t n)
+{
+    assert(code_ == token::code::error_insufficient_data);
+    assert(n <= body_remaining());
+
+    if (n == 0)
+        return;
+
+    body_size -= n;
+    if (body_size == 0)
+        state = EXPECT_END_OF_BODY;
+}
+
 inline void response::next()
 {
     if (state == ERRORED)
@@ -353,9 +380,9 @@ inline void response::next()
         }
     case EXPECT_REASON_PHRASE:
         {
-            typedef syntax::reason_phrase<unsigned char> reason_phrase;
-
-            std::size_t nmatched = reason_phrase::match(rest_view);
+            std::size_t nmatched
+                = detail::scan<detail::field_value_set>(rest_view.data(),
+                                                        rest_view.size());
 
             if (nmatched == rest_view.size())
                 return;
@@ -390,10 +417,9 @@ inline void response::next()
         }
     case EXPECT_FIELD_NAME:
         {
-            using boost::algorithm::iequals;
-            typedef syntax::field_name<unsigned char> field_name;
-
-            std::size_t nmatched = field_name::match(rest_view);
+            std::size_t nmatched
+                = detail::scan<detail::tchar_set>(rest_view.data(),
+                                                  rest_view.size());
 
             if (nmatched == 0) {
                 state = EXPECT_CRLF_AFTER_HEADERS;
@@ -415,11 +441,15 @@ inline void response::next()
                - CONTENT_LENGTH_READ
                - CHUNKED_ENCODING_READ
                - RANDOM_ENCODING_READ */
-            string_ref field = value<token::field_name>();
+            field_id = to_header_id(value<token::field_name>());
             if (body_type == FORCE_NO_BODY
                 || body_type == FORCE_NO_BODY_AND_STOP) {
                 // Ignore field
-            } else if (iequals(field, "Transfer-Encoding")) {
+                return;
+            }
+
+            switch (field_id) {
+            case header_id::transfer_encoding:
                 switch (body_type) {
                 case CONTENT_LENGTH_READ:
                     /* Transfer-Encoding overrides Content-Length (section 3.3.3
@@ -435,7 +465,8 @@ inline void response::next()
                 default:
                     BOOST_HTTP_DETAIL_UNREACHABLE("");
                 }
-            } else if (iequals(field, "Content-Length")) {
+                break;
+            case header_id::content_length:
                 switch (body_type) {
                 case CONNECTION_DELIMITED:
                     body_type = READING_CONTENT_LENGTH;
@@ -452,6 +483,9 @@ inline void response::next()
                 default:
                     BOOST_HTTP_DETAIL_UNREACHABLE("");
                 }
+                break;
+            default:
+                break;
             }
 
             return;
@@ -497,10 +531,11 @@ inline void response::next()
         }
     case EXPECT_FIELD_VALUE:
         {
-            typedef syntax::left_trimmed_field_value<unsigned char> field_value;
             typedef syntax::content_length<char> content_length;
 
-            std::size_t nmatched = field_value::match(rest_view);
+            std::size_t nmatched
+                = detail::scan<detail::field_value_set>(rest_view.data(),
+                                                        rest_view.size());
 
             if (nmatched == rest_view.size())
                 return;
@@ -619,9 +654,12 @@ inline void response::next()
                 return;
             }
 
+            body_length_known_ = true;
+            body_length_ = 0;
             switch (body_type) {
             case RANDOM_ENCODING_READ:
             case CONNECTION_DELIMITED:
+                body_length_known_ = false;
                 body_type = FORCE_NO_BODY_AND_STOP;
                 state = EXPECT_UNSAFE_BODY;
                 break;
@@ -630,9 +668,11 @@ inline void response::next()
                 state = EXPECT_END_OF_BODY;
                 break;
             case CHUNKED_ENCODING_READ:
+                body_length_known_ = false;
                 state = EXPECT_CHUNK_SIZE;
                 break;
             case CONTENT_LENGTH_READ:
+                body_length_ = body_size;
                 if (body_size == 0) {
                     state = EXPECT_END_OF_BODY;
                     break;
@@ -707,12 +747,14 @@ inline void response::next()
         }
     case EXPECT_CHUNK_EXT:
         {
+            const unsigned char *data
+                = asio::buffer_cast<const unsigned char*>(ibuffer);
             size_type i = idx + token_size_;
-            for ( ; i != asio::buffer_size(ibuffer) ; ++i) {
-                unsigned char c
-                    = asio::buffer_cast<const unsigned char*>(ibuffer)[i];
-                if (detail::is_chunk_ext_char(c))
-                    continue;
+            i += detail::scan<detail::field_value_set>(data + i,
+                                                       asio::buffer_size(ibuffer)
+                                                       - i);
+            if (i != asio::buffer_size(ibuffer)) {
+                unsigned char c = data[i];
 
                 if (c != '\r') {
                     state = ERRORED;
@@ -792,9 +834,9 @@ inline void response::next()
         }
     case EXPECT_TRAILER_NAME:
         {
-            typedef syntax::field_name<unsigned char> field_name;
-
-            std::size_t nmatched = field_name::match(rest_view);
+            std::size_t nmatched
+                = detail::scan<detail::tchar_set>(rest_view.data(),
+                                                  rest_view.size());
 
             if (nmatched == 0) {
                 state = EXPECT_CRLF_AFTER_TRAILERS;
@@ -807,6 +849,7 @@ inline void response::next()
             state = EXPECT_TRAILER_COLON;
             code_ = token::code::trailer_name;
             token_size_ = nmatched;
+            field_id = to_header_id(value<token::trailer_name>());
             return;
         }
     case EXPECT_TRAILER_COLON:
@@ -850,9 +893,9 @@ inline void response::next()
         }
     case EXPECT_TRAILER_VALUE:
         {
-            typedef syntax::left_trimmed_field_value<unsigned char> field_value;
-
-            std::size_t nmatched = field_value::match(rest_view);
+            std::size_t nmatched
+                = detail::scan<detail::field_value_set>(rest_view.data(),
+                                                        rest_view.size());
 
             if (nmatched == rest_view.size())
                 return;
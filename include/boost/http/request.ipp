@@ -6,6 +6,15 @@
 namespace boost {
 namespace http {
 
+template<class String, class Headers, class Body>
+basic_request<String, Headers, Body>::basic_request(monotonic_resource *resource)
+    : method_(resource)
+    , target_(resource)
+    , headers_(resource)
+    , body_(resource)
+    , trailers_(resource)
+{}
+
 template<class String, class Headers, class Body>
 String &basic_request<String, Headers, Body>::method()
 {
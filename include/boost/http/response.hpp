@@ -10,6 +10,8 @@
 #include <cstdint>
 #include <boost/asio/buffer.hpp>
 #include "headers.hpp"
+#include "arena_headers.hpp"
+#include "monotonic_resource.hpp"
 #include <boost/http/traits.hpp>
 
 namespace boost {
@@ -22,6 +24,12 @@ struct basic_response
     typedef Headers headers_type;
     typedef Body body_type;
 
+    basic_response() = default;
+
+    /* Constructs every member from `resource` (only available when all of
+       them are constructible from a `monotonic_resource*`) */
+    explicit basic_response(monotonic_resource *resource);
+
     std::uint_least16_t &status_code();
 
     const std::uint_least16_t &status_code() const;
@@ -54,6 +62,17 @@ typedef basic_response<std::string, boost::http::headers,
                        std::vector<std::uint8_t>>
 response;
 
+// Fields live in an arena owned by the message (see `arena_headers`)
+typedef basic_response<std::string, boost::http::arena_headers,
+                       std::vector<std::uint8_t>>
+arena_response;
+
+/* Every member draws from a `monotonic_resource` given at construction (see
+   `reset_message`) */
+typedef basic_response<resource_string, boost::http::arena_headers,
+                       resource_body>
+monotonic_response;
+
 template<class String, class Headers, class Body>
 struct is_response_message<basic_response<String, Headers, Body>>
     : public std::true_type
@@ -6,6 +6,16 @@
 namespace boost {
 namespace http {
 
+template<class String, class Headers, class Body>
+basic_response<String, Headers, Body>
+::basic_response(monotonic_resource *resource)
+    : status_code_()
+    , reason_phrase_(resource)
+    , headers_(resource)
+    , body_(resource)
+    , trailers_(resource)
+{}
+
 template<class String, class Headers, class Body>
 std::uint_least16_t &basic_response<String, Headers, Body>::status_code()
 {
@@ -45,7 +45,7 @@ write_state basic_socket<Socket>::write_state() const
 template<class Socket>
 bool basic_socket<Socket>::write_response_native_stream() const
 {
-    return modern_http;
+    return out_modern_http();
 }
 
 template<class Socket>
@@ -72,16 +72,29 @@ basic_socket<Socket>::async_read_request(Request &request,
 
     asio::async_result<Handler> result(handler);
 
-    if (istate != http::read_state::empty) {
+    if (istate != http::read_state::empty || parked_read) {
         invoke_handler(std::forward<decltype(handler)>(handler),
                        http_errc::out_of_order);
         return result.get();
     }
 
-    request.method().clear();
-    request.target().clear();
-    clear_message(request);
-    writer_helper = http::write_state::finished;
+    if (pipelined() && pipeline.size() >= max_pipelined) {
+        // Resumed once the oldest pending response is written
+        parked_read.reset(detail::make_completion
+                          (operation_memory, std::move(handler),
+                           [this,&request](Handler &handler,
+                                           system::error_code /*ignored_ec*/) {
+            detail::recycle_request(request);
+            schedule_on_async_read_message<READY>(handler, request,
+                                                  &request.method(),
+                                                  &request.target());
+        }));
+        return result.get();
+    }
+
+    detail::recycle_request(request);
+    if (!pipelined())
+        writer_helper = http::write_state::finished;
     schedule_on_async_read_message<READY>(handler, request, &request.method(),
                                           &request.target());
 
@@ -145,6 +158,121 @@ basic_socket<Socket>::async_read_trailers(Message &message,
     return result.get();
 }
 
+template<class Socket>
+template<class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code,
+                                     std::size_t)>::type>::type
+basic_socket<Socket>::async_read_body_into(asio::mutable_buffer out,
+                                           CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code, std::size_t)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    /* The parser consumes every buffered byte of such body, so there's never
+       anything left in `buffer` to hand over here. */
+    if (istate != http::read_state::message_ready
+        || parser.body_remaining() == 0 || used_size != 0) {
+        channel.get_io_service().post
+            (detail::make_posted_completion(operation_memory,
+                                            std::move(handler),
+                                            [](Handler &handler,
+                                               const system::error_code &ec) {
+                                                handler(ec, 0);
+                                            },
+                                            make_error_code(http_errc
+                                                            ::out_of_order)));
+        return result.get();
+    }
+
+    auto size = std::min<std::uint_least64_t>(asio::buffer_size(out),
+                                              parser.body_remaining());
+    channel.async_read_some(asio::buffer(out, size), continuation(
+                            std::move(handler),
+                            [this](Handler &handler,
+                                   const system::error_code &ec,
+                                   std::size_t bytes_transferred) {
+        if (ec) {
+            clear_buffer();
+            shrink_buffer();
+            handler(ec, bytes_transferred);
+            return;
+        }
+
+        consume_body(bytes_transferred);
+        handler(ec, bytes_transferred);
+    }));
+
+    return result.get();
+}
+
+#ifdef BOOST_HTTP_DETAIL_HAS_SPLICE
+
+template<class Socket>
+template<class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code,
+                                     std::uint_least64_t)>::type>::type
+basic_socket<Socket>::async_splice_body(int fd, CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code, std::uint_least64_t)>::type
+        Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    auto post_error = [this](Handler &handler, system::error_code ec) {
+        channel.get_io_service().post
+            (detail::make_posted_completion(operation_memory,
+                                            std::move(handler),
+                                            [](Handler &handler,
+                                               const system::error_code &ec) {
+                                                handler(ec, 0);
+                                            },
+                                            ec));
+    };
+
+    // See `async_read_body_into`
+    if (istate != http::read_state::message_ready
+        || parser.body_remaining() == 0 || used_size != 0) {
+        post_error(handler, make_error_code(http_errc::out_of_order));
+        return result.get();
+    }
+
+    splice_operation op;
+    op.fd = fd;
+    op.nspliced = 0;
+    if (::pipe2(op.pipe, O_CLOEXEC | O_NONBLOCK) == -1) {
+        post_error(handler, system::error_code(errno,
+                                               system::system_category()));
+        return result.get();
+    }
+
+    // Readiness is awaited by the reactor, so the splice itself can't block
+    system::error_code ec;
+    channel.native_non_blocking(true, ec);
+    if (ec) {
+        ::close(op.pipe[0]);
+        ::close(op.pipe[1]);
+        post_error(handler, ec);
+        return result.get();
+    }
+
+    schedule_splice_body(handler, op);
+
+    return result.get();
+}
+
+#endif // BOOST_HTTP_DETAIL_HAS_SPLICE
+
 template<class Socket>
 template<class Response, class CompletionToken>
 typename asio::async_result<
@@ -156,25 +284,167 @@ basic_socket<Socket>
     static_assert(is_response_message<Response>::value,
                   "Response must fulfill the Response concept");
 
-    using detail::string_literal_buffer;
+    // Answers the oldest pending request
+    if (pipelined()) {
+        return async_write_response(nrequests - pipeline.size(), response,
+                                    std::forward<CompletionToken>(token));
+    }
+
     typedef typename asio::handler_type<
         CompletionToken, void(system::error_code)>::type Handler;
 
     Handler handler(std::forward<CompletionToken>(token));
     asio::async_result<Handler> result(handler);
 
-    const auto status_code = response.status_code();
-    const auto &reason_phrase = response.reason_phrase();
-    const auto &headers = response.headers();
-
     if (!writer_helper.write_message()) {
         invoke_handler(std::forward<decltype(handler)>(handler),
                        http_errc::out_of_order);
         return result.get();
     }
 
-    auto crlf = string_literal_buffer("\r\n");
-    auto sep = string_literal_buffer(": ");
+    auto body = serialize_response(response, modern_http, connect_request,
+                                   keep_alive, staging_buffer);
+    stage_external(body);
+
+    outbound_commit(std::move(handler),
+                    [this](Handler &handler, const system::error_code &ec) {
+        is_open_ = keep_alive == KEEP_ALIVE_KEEP_ALIVE_READ;
+        if (!is_open_)
+            channel.lowest_layer().close();
+        handler(ec);
+    });
+
+    return result.get();
+}
+
+template<class Socket>
+void basic_socket<Socket>::set_pipeline_depth(std::size_t depth)
+{
+    if (depth == 0)
+        throw std::invalid_argument("pipeline depth must not be 0");
+
+    if (pipeline.size() || parked_read)
+        throw std::logic_error("there are pending responses");
+
+    max_pipelined = depth;
+}
+
+template<class Socket>
+std::size_t basic_socket<Socket>::pipeline_depth() const
+{
+    return max_pipelined;
+}
+
+template<class Socket>
+std::size_t basic_socket<Socket>::pending_responses() const
+{
+    return pipeline.size();
+}
+
+template<class Socket>
+std::size_t basic_socket<Socket>::last_request_id() const
+{
+    return nrequests - 1;
+}
+
+template<class Socket>
+template<class Response, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_socket<Socket>
+::async_write_response(std::size_t request_id, const Response &response,
+                       CompletionToken &&token)
+{
+    static_assert(is_response_message<Response>::value,
+                  "Response must fulfill the Response concept");
+
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    if (!pipelined()) {
+        if (request_id != last_request_id()) {
+            Handler handler(std::forward<CompletionToken>(token));
+            asio::async_result<Handler> result(handler);
+            invoke_handler(std::forward<decltype(handler)>(handler),
+                           http_errc::out_of_order);
+            return result.get();
+        }
+
+        return async_write_response(response,
+                                    std::forward<CompletionToken>(token));
+    }
+
+    Handler handler(std::forward<CompletionToken>(token));
+    asio::async_result<Handler> result(handler);
+
+    const std::size_t first_pending = nrequests - pipeline.size();
+
+    if (request_id < first_pending || request_id >= nrequests
+        || pipeline[request_id - first_pending].ready) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
+    }
+
+    /* The oldest pending response shares `writer_helper` with the streaming
+       API (it might have issued a 100-continue or be in the middle of a
+       chunked response). */
+    if (request_id == first_pending && !writer_helper.write_message()) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
+    }
+
+    auto &entry = pipeline[request_id - first_pending];
+    entry.storage.clear();
+    entry.body = serialize_response(response, entry.modern_http,
+                                    entry.connect_request, entry.keep_alive,
+                                    entry.storage);
+    entry.handler.reset(detail::make_completion(operation_memory,
+                                                std::move(handler)));
+    entry.ready = true;
+
+    flush_pipeline();
+
+    return result.get();
+}
+
+template<class Socket>
+template<class Response>
+asio::const_buffer basic_socket<Socket>
+::serialize_response(const Response &response, bool modern_http,
+                     bool connect_request, keep_alive_state &keep_alive,
+                     std::string &staging)
+{
+    const auto &body = response.body();
+
+    if (!serialize_response_metadata(response, modern_http, connect_request,
+                                     keep_alive, staging, body.size())) {
+        return asio::const_buffer();
+    }
+
+    // Small bodies are cheaper to copy than to pass as another iovec
+    if (body.size() <= BOOST_HTTP_SOCKET_INLINE_BODY_SIZE) {
+        detail::append_body(staging, body);
+        return asio::const_buffer();
+    }
+
+    return asio::buffer(body);
+}
+
+template<class Socket>
+template<class Response>
+bool basic_socket<Socket>
+::serialize_response_metadata(const Response &response, bool modern_http,
+                              bool connect_request,
+                              keep_alive_state &keep_alive,
+                              std::string &staging,
+                              std::uint_least64_t body_size)
+{
+    const auto status_code = response.status_code();
+    const auto &headers = response.headers();
+
     bool implicit_content_length
         = (headers.find("content-length") != headers.end())
         || (status_code / 100 == 1) || (status_code == 204)
@@ -187,75 +457,23 @@ basic_socket<Socket>
     auto use_connection_close_buf = (keep_alive == KEEP_ALIVE_CLOSE_READ)
         && !has_connection_close;
 
-    // because we don't create multiple responses at once with HTTP/1.1
-    // pipelining, it's safe to use this "shared state"
-    content_length_buffer = std::to_string(status_code) + ' ';
-    std::string::size_type content_length_delim = content_length_buffer.size();
-
-    // because we don't create multiple responses at once with HTTP/1.1
-    // pipelining, it's safe to use this "shared state"
-    content_length_buffer += std::to_string(response.body().size());
-
-    const auto nbuffer_pieces =
-        // Start line (http version + status code + reason phrase) + CRLF
-        4
-        // Headers
-        // If user didn't provided "connection: close"
-        + (use_connection_close_buf ? 1 : 0)
-        // Each header is 4 buffer pieces: key + sep + value + crlf
-        + 4 * headers.size()
-        // Extra content-length header uses 3 pieces
-        + (implicit_content_length ? 0 : 3)
-        // Extra CRLF for end of headers
-        + 1
-        // And finally, the message body
-        + (implicit_content_length ? 0 : 1);
-
-    // TODO (C++14): replace by dynarray
-    std::vector<asio::const_buffer> buffers;
-    buffers.reserve(nbuffer_pieces);
-
-    buffers.push_back(modern_http ? string_literal_buffer("HTTP/1.1 ")
-                      : string_literal_buffer("HTTP/1.0 "));
-    buffers.push_back(asio::buffer(content_length_buffer.data(),
-                                   content_length_delim));
-    buffers.push_back(asio::buffer(reason_phrase.data(), reason_phrase.size()));
-    buffers.push_back(crlf);
+    detail::append_status_line(staging, modern_http, status_code,
+                               response.reason_phrase());
 
     if (use_connection_close_buf)
-        buffers.push_back(string_literal_buffer("connection: close\r\n"));
+        detail::append_literal(staging, "connection: close\r\n");
 
-    for (const auto &header: headers) {
-        buffers.push_back(asio::buffer(header.first));
-        buffers.push_back(sep);
-        buffers.push_back(asio::buffer(header.second));
-        buffers.push_back(crlf);
-    }
+    detail::append_headers(staging, headers);
 
     if (!implicit_content_length) {
-        buffers.push_back(string_literal_buffer("content-length: "));
-        buffers.push_back(asio::buffer(content_length_buffer.data()
-                                       + content_length_delim,
-                                       content_length_buffer.size()
-                                       - content_length_delim));
-        buffers.push_back(crlf);
+        detail::append_literal(staging, "content-length: ");
+        detail::append_decimal(staging, body_size);
+        detail::append_literal(staging, "\r\n");
     }
 
-    buffers.push_back(crlf);
-
-    if (!implicit_content_length)
-        buffers.push_back(asio::buffer(response.body()));
+    detail::append_literal(staging, "\r\n");
 
-    asio::async_write(channel, buffers,
-                      [handler,this]
-                      (const system::error_code &ec, std::size_t) mutable {
-        is_open_ = keep_alive == KEEP_ALIVE_KEEP_ALIVE_READ;
-        if (!is_open_)
-            channel.lowest_layer().close();
-        handler(ec);
-    });
-
-    return result.get();
+    return !implicit_content_length;
 }
 
 template<class Socket>
@@ -273,19 +491,31 @@ basic_socket<Socket>
 
     asio::async_result<Handler> result(handler);
 
+    /* Answers the last request read, whose interim response must wait for
+       every previous response when it isn't the oldest pending request */
+    if (pipelined() && pipeline.size() > 1) {
+        auto &entry = pipeline.back();
+        if (entry.ready || entry.continue_issued) {
+            invoke_handler(std::forward<decltype(handler)>(handler),
+                           http_errc::out_of_order);
+            return result.get();
+        }
+
+        entry.continue_issued = true;
+        entry.continue_handler.reset(detail::make_completion
+                                     (operation_memory, std::move(handler)));
+        flush_pipeline();
+        return result.get();
+    }
+
     if (!writer_helper.write_continue()) {
         invoke_handler(std::forward<decltype(handler)>(handler),
                        http_errc::out_of_order);
         return result.get();
     }
 
-    asio::async_write(channel,
-                      detail::string_literal_buffer("HTTP/1.1 100"
-                                                    " Continue\r\n\r\n"),
-                      [handler]
-                      (const system::error_code &ec, std::size_t) mutable {
-        handler(ec);
-    });
+    detail::append_literal(staging_buffer, "HTTP/1.1 100 Continue\r\n\r\n");
+    outbound_commit(std::move(handler));
 
     return result.get();
 }
@@ -302,7 +532,6 @@ basic_socket<Socket>
     static_assert(is_response_message<Response>::value,
                   "Response must fulfill the Response concept");
 
-    using detail::string_literal_buffer;
     typedef typename asio::handler_type<
         CompletionToken, void(system::error_code)>::type Handler;
 
@@ -322,7 +551,7 @@ basic_socket<Socket>
             return result.get();
         }
 
-        if (!modern_http) {
+        if (!out_modern_http()) {
             writer_helper = prev;
             invoke_handler(std::forward<decltype(handler)>(handler),
                            http_errc::native_stream_unsupported);
@@ -330,9 +559,8 @@ basic_socket<Socket>
         }
     }
 
-    auto crlf = string_literal_buffer("\r\n");
-    auto sep = string_literal_buffer(": ");
     auto has_connection_close = detail::has_connection_close(headers);
+    auto &keep_alive = out_keep_alive();
 
     if (has_connection_close)
         keep_alive = KEEP_ALIVE_CLOSE_READ;
@@ -340,49 +568,18 @@ basic_socket<Socket>
     auto use_connection_close_buf = (keep_alive == KEEP_ALIVE_CLOSE_READ)
         && !has_connection_close;
 
-    // because we don't create multiple responses at once with HTTP/1.1
-    // pipelining, it's safe to use this "shared state"
-    content_length_buffer = std::to_string(status_code) + ' ';
-
-    const auto nbuffer_pieces =
-        // Start line (http version + status code + reason phrase) + CRLF
-        4
-        // Headers
-        // If user didn't provided "connection: close"
-        + (use_connection_close_buf ? 1 : 0)
-        // Each header is 4 buffer pieces: key + sep + value + crlf
-        + 4 * headers.size()
-        // Extra transfer-encoding header and extra CRLF for end of headers
-        + 1;
-
-    // TODO (C++14): replace by dynarray
-    std::vector<asio::const_buffer> buffers;
-    buffers.reserve(nbuffer_pieces);
-
-    buffers.push_back(modern_http ? string_literal_buffer("HTTP/1.1 ")
-                      : string_literal_buffer("HTTP/1.0 "));
-    buffers.push_back(asio::buffer(content_length_buffer));
-    buffers.push_back(asio::buffer(reason_phrase.data(), reason_phrase.size()));
-    buffers.push_back(crlf);
+    // Only HTTP/1.1 reaches this point
+    detail::append_status_line(staging_buffer, true, status_code,
+                               reason_phrase);
 
     if (use_connection_close_buf)
-        buffers.push_back(string_literal_buffer("connection: close\r\n"));
-
-    for (const auto &header: headers) {
-        buffers.push_back(asio::buffer(header.first));
-        buffers.push_back(sep);
-        buffers.push_back(asio::buffer(header.second));
-        buffers.push_back(crlf);
-    }
+        detail::append_literal(staging_buffer, "connection: close\r\n");
 
-    buffers.push_back(string_literal_buffer("transfer-encoding: chunked\r\n"
-                                            "\r\n"));
+    detail::append_headers(staging_buffer, headers);
+    detail::append_literal(staging_buffer, "transfer-encoding: chunked\r\n"
+                           "\r\n");
 
-    asio::async_write(channel, buffers,
-                      [handler]
-                      (const system::error_code &ec, std::size_t) mutable {
-        handler(ec);
-    });
+    outbound_cork(std::move(handler));
 
     return result.get();
 }
@@ -398,7 +595,6 @@ basic_socket<Socket>::async_write(const Message &message,
     static_assert(is_message<Message>::value,
                   "Message must fulfill the Message concept");
 
-    using detail::string_literal_buffer;
     typedef typename asio::handler_type<
         CompletionToken, void(system::error_code)>::type Handler;
 
@@ -417,28 +613,21 @@ basic_socket<Socket>::async_write(const Message &message,
         return result.get();
     }
 
-    auto crlf = string_literal_buffer("\r\n");
+    const auto &body = message.body();
 
-    {
-        std::ostringstream ostr;
-        ostr << std::hex << message.body().size();
-        // because we don't create multiple responses at once with HTTP/1.1
-        // pipelining, it's safe to use this "shared state"
-        content_length_buffer = ostr.str();
-    }
-
-    std::array<boost::asio::const_buffer, 4> buffers = {
-        asio::buffer(content_length_buffer),
-        crlf,
-        asio::buffer(message.body()),
-        crlf
-    };
+    /* chunk = chunk-size [ chunk-ext ] CRLF chunk-data CRLF
 
-    asio::async_write(channel, buffers,
-                      [handler]
-                      (const system::error_code &ec, std::size_t) mutable {
-        handler(ec);
-    });
+       from section 4.1 of RFC7230. Small chunks are copied, so adjacent ones
+       end up in the same iovec. */
+    detail::append_hex(staging_buffer, body.size());
+    detail::append_literal(staging_buffer, "\r\n");
+    if (body.size() <= BOOST_HTTP_SOCKET_INLINE_BODY_SIZE)
+        detail::append_body(staging_buffer, body);
+    else
+        stage_external(asio::buffer(body));
+    detail::append_literal(staging_buffer, "\r\n");
+
+    outbound_commit(std::move(handler));
 
     return result.get();
 }
@@ -454,7 +643,6 @@ basic_socket<Socket>::async_write_trailers(const Message &message,
     static_assert(is_message<Message>::value,
                   "Message must fulfill the Message concept");
 
-    using detail::string_literal_buffer;
     typedef typename asio::handler_type<
         CompletionToken, void(system::error_code)>::type Handler;
 
@@ -468,37 +656,58 @@ basic_socket<Socket>::async_write_trailers(const Message &message,
         return result.get();
     }
 
-    auto last_chunk = string_literal_buffer("0\r\n");
-    auto crlf = string_literal_buffer("\r\n");
-    auto sep = string_literal_buffer(": ");
+    detail::append_literal(staging_buffer, "0\r\n");
+    detail::append_headers(staging_buffer, message.trailers());
+    detail::append_literal(staging_buffer, "\r\n");
+
+    outbound_commit(std::move(handler),
+                    [this](Handler &handler, const system::error_code &ec) {
+        if (pipelined()) {
+            on_pipelined_response_written();
+            handler(ec);
+            return;
+        }
+
+        is_open_ = keep_alive == KEEP_ALIVE_KEEP_ALIVE_READ;
+        if (!is_open_)
+            channel.lowest_layer().close();
+        handler(ec);
+    });
+
+    return result.get();
+}
 
-    const auto nbuffer_pieces =
-        // last_chunk
-        1
-        // Trailers
-        // Each header is 4 buffer pieces: key + sep + value + crlf
-        + 4 * message.trailers().size()
-        // Final CRLF for end of trailers
-        + 1;
+template<class Socket>
+template<class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_socket<Socket>
+::async_write_end_of_message(CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
 
-    // TODO (C++14): replace by dynarray
-    std::vector<asio::const_buffer> buffers;
-    buffers.reserve(nbuffer_pieces);
+    Handler handler(std::forward<CompletionToken>(token));
 
-    buffers.push_back(last_chunk);
+    asio::async_result<Handler> result(handler);
 
-    for (const auto &header: message.trailers()) {
-        buffers.push_back(asio::buffer(header.first));
-        buffers.push_back(sep);
-        buffers.push_back(asio::buffer(header.second));
-        buffers.push_back(crlf);
+    if (!writer_helper.end()) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
     }
 
-    buffers.push_back(crlf);
+    detail::append_literal(staging_buffer, "0\r\n\r\n");
+
+    outbound_commit(std::move(handler),
+                    [this](Handler &handler, const system::error_code &ec) {
+        if (pipelined()) {
+            on_pipelined_response_written();
+            handler(ec);
+            return;
+        }
 
-    asio::async_write(channel, buffers,
-                      [handler,this]
-                      (const system::error_code &ec, std::size_t) mutable {
         is_open_ = keep_alive == KEEP_ALIVE_KEEP_ALIVE_READ;
         if (!is_open_)
             channel.lowest_layer().close();
@@ -509,32 +718,39 @@ basic_socket<Socket>::async_write_trailers(const Message &message,
 }
 
 template<class Socket>
-template<class CompletionToken>
+template<class Response, class ConstBufferSequence, class CompletionToken>
 typename asio::async_result<
     typename asio::handler_type<CompletionToken,
                                 void(system::error_code)>::type>::type
 basic_socket<Socket>
-::async_write_end_of_message(CompletionToken &&token)
+::async_write_response_buffers(const Response &response,
+                               const ConstBufferSequence &body,
+                               CompletionToken &&token)
 {
-    using detail::string_literal_buffer;
+    static_assert(is_response_message<Response>::value,
+                  "Response must fulfill the Response concept");
+
     typedef typename asio::handler_type<
         CompletionToken, void(system::error_code)>::type Handler;
 
     Handler handler(std::forward<CompletionToken>(token));
-
     asio::async_result<Handler> result(handler);
 
-    if (!writer_helper.end()) {
+    if (pipelined() || !writer_helper.write_message()) {
         invoke_handler(std::forward<decltype(handler)>(handler),
                        http_errc::out_of_order);
         return result.get();
     }
 
-    auto last_chunk = string_literal_buffer("0\r\n\r\n");
+    if (serialize_response_metadata(response, modern_http, connect_request,
+                                    keep_alive, staging_buffer,
+                                    asio::buffer_size(body))) {
+        for (const auto &buffer: body)
+            stage_external(asio::const_buffer(buffer));
+    }
 
-    asio::async_write(channel, last_chunk,
-                      [handler,this]
-                      (const system::error_code &ec, std::size_t) mutable {
+    outbound_commit(std::move(handler),
+                    [this](Handler &handler, const system::error_code &ec) {
         is_open_ = keep_alive == KEEP_ALIVE_KEEP_ALIVE_READ;
         if (!is_open_)
             channel.lowest_layer().close();
@@ -544,6 +760,76 @@ basic_socket<Socket>
     return result.get();
 }
 
+#ifdef BOOST_HTTP_DETAIL_HAS_SENDFILE
+
+template<class Socket>
+template<class Response, class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_socket<Socket>
+::async_write_response_file(const Response &response, int fd,
+                            std::uint_least64_t offset,
+                            std::uint_least64_t size, CompletionToken &&token)
+{
+    static_assert(is_response_message<Response>::value,
+                  "Response must fulfill the Response concept");
+
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+    asio::async_result<Handler> result(handler);
+
+    if (pipelined() || !writer_helper.write_message()) {
+        invoke_handler(std::forward<decltype(handler)>(handler),
+                       http_errc::out_of_order);
+        return result.get();
+    }
+
+    sendfile_operation op;
+    op.fd = fd;
+    op.offset = offset;
+    op.remaining = serialize_response_metadata(response, modern_http,
+                                               connect_request, keep_alive,
+                                               staging_buffer, size)
+        ? size : 0;
+
+    outbound_commit(std::move(handler),
+                    [this,op](Handler &handler, const system::error_code &ec) {
+        if (ec || op.remaining == 0) {
+            finish_send_file(handler, ec);
+            return;
+        }
+
+        // Readiness is awaited by the reactor, so sendfile itself can't block
+        system::error_code nb_ec;
+        channel.native_non_blocking(true, nb_ec);
+        if (nb_ec) {
+            finish_send_file(handler, nb_ec);
+            return;
+        }
+
+        on_send_file_ready(handler, op);
+    });
+
+    /* Writes issued from now on wait until the body is out (they'd end up
+       between the metadata and the body otherwise) */
+    if (op.remaining != 0) {
+        outbound_held = true;
+        if (!staging_handlers.empty()) {
+            // Still behind another write, so only what's staged so far goes
+            held_node = staging_handlers.back();
+            held_size = staging_buffer.size();
+            held_external = external_buffers.size();
+        }
+    }
+
+    return result.get();
+}
+
+#endif // BOOST_HTTP_DETAIL_HAS_SENDFILE
+
 template<class Socket>
 basic_socket<Socket>
 ::basic_socket(boost::asio::io_service &io_service,
@@ -551,6 +837,10 @@ basic_socket<Socket>
     channel(io_service),
     istate(http::read_state::empty),
     buffer(inbuffer),
+    initial_buffer(inbuffer),
+    max_buffer_size_(std::max<std::size_t>(
+                         BOOST_HTTP_SOCKET_DEFAULT_MAX_BUFFER_SIZE,
+                         asio::buffer_size(inbuffer))),
     writer_helper(http::write_state::empty)
 {
     if (asio::buffer_size(buffer) == 0)
@@ -564,6 +854,10 @@ basic_socket<Socket>
     : channel(std::forward<Args>(args)...)
     , istate(http::read_state::empty)
     , buffer(inbuffer)
+    , initial_buffer(inbuffer)
+    , max_buffer_size_(std::max<std::size_t>(
+                           BOOST_HTTP_SOCKET_DEFAULT_MAX_BUFFER_SIZE,
+                           asio::buffer_size(inbuffer)))
     , writer_helper(http::write_state::empty)
 {
     if (asio::buffer_size(buffer) == 0)
@@ -571,11 +865,40 @@ basic_socket<Socket>
 }
 
 template<class Socket>
-Socket &basic_socket<Socket>::next_layer()
-{
-    return channel;
-}
-
+basic_socket<Socket>
+::basic_socket(boost::asio::io_service &io_service, http::buffer_pool &pool)
+    : channel(io_service)
+    , istate(http::read_state::empty)
+    , max_buffer_size_(BOOST_HTTP_SOCKET_DEFAULT_MAX_BUFFER_SIZE)
+    , pool(&pool)
+    , writer_helper(http::write_state::empty)
+{}
+
+template<class Socket>
+template<class... Args>
+basic_socket<Socket>::basic_socket(http::buffer_pool &pool, Args&&... args)
+    : channel(std::forward<Args>(args)...)
+    , istate(http::read_state::empty)
+    , max_buffer_size_(BOOST_HTTP_SOCKET_DEFAULT_MAX_BUFFER_SIZE)
+    , pool(&pool)
+    , writer_helper(http::write_state::empty)
+{}
+
+template<class Socket>
+basic_socket<Socket>::~basic_socket()
+{
+    if (asio::buffer_cast<char*>(buffer)
+        != asio::buffer_cast<char*>(initial_buffer)) {
+        pool->release(buffer);
+    }
+}
+
+template<class Socket>
+Socket &basic_socket<Socket>::next_layer()
+{
+    return channel;
+}
+
 template<class Socket>
 const Socket &basic_socket<Socket>::next_layer() const
 {
@@ -586,6 +909,10 @@ template<class Socket>
 void basic_socket<Socket>::open()
 {
     is_open_ = true;
+
+    // Nothing is left over from a body a sink gave up on
+    if (istate == http::read_state::finished)
+        istate = http::read_state::empty;
 }
 
 template<class Socket>
@@ -598,15 +925,44 @@ void basic_socket<Socket>
         // Have cached some bytes from a previous read
         on_async_read_message<target>(std::move(handler), method, path, message,
                                          system::error_code{}, 0);
+    } else if (asio::buffer_size(buffer) == 0
+               && !detail::readiness_reflects_input<Socket>::value) {
+        // Bytes may wait inside the layered stream: read them right away
+        buffer = pool->acquire(buffer_pool::min_block_size);
+        schedule_on_async_read_message<target>(handler, message, method, path);
+    } else if (asio::buffer_size(buffer) == 0) {
+        // Idle connection with no buffer: only borrow one once readable
+        channel.async_read_some(asio::null_buffers(), continuation(
+                                std::move(handler),
+                                [this,method,path,&message]
+                                (Handler &handler, const system::error_code &ec,
+                                 std::size_t) {
+            if (ec) {
+                on_async_read_message<target>(std::move(handler), method, path,
+                                              message, ec, 0);
+                return;
+            }
+
+            buffer = pool->acquire(buffer_pool::min_block_size);
+            channel.async_read_some(asio::buffer(buffer), continuation(
+                                    std::move(handler),
+                                    [this,method,path,&message]
+                                    (Handler &handler,
+                                     const system::error_code &ec,
+                                     std::size_t bytes_transferred) {
+                on_async_read_message<target>(std::move(handler), method, path,
+                                              message, ec, bytes_transferred);
+            }));
+        }));
     } else {
-        // TODO (C++14): move in lambda capture list
-        channel.async_read_some(asio::buffer(buffer + used_size),
-                                [this,handler,method,path,&message]
-                                (const system::error_code &ec,
-                                 std::size_t bytes_transferred) mutable {
+        channel.async_read_some(asio::buffer(buffer + used_size), continuation(
+                                std::move(handler),
+                                [this,method,path,&message]
+                                (Handler &handler, const system::error_code &ec,
+                                 std::size_t bytes_transferred) {
             on_async_read_message<target>(std::move(handler), method, path,
                                           message, ec, bytes_transferred);
-        });
+        }));
     }
 }
 
@@ -621,6 +977,7 @@ void basic_socket<Socket>
 
     if (ec) {
         clear_buffer();
+        shrink_buffer();
         handler(ec);
         return;
     }
@@ -640,6 +997,7 @@ void basic_socket<Socket>
     std::size_t nparsed = expecting_field ? field_name_size : 0;
     std::size_t field_name_begin = 0;
     bool use_trailers;
+    http::write_state prev_writer_state;
     int flags = 0;
 
     /* Buffer management is simplified by making `error_insufficient_data` the
@@ -666,14 +1024,7 @@ void basic_socket<Socket>
                                             "Connection: close\r\n"
                                             "\r\n"
                                             "Invalid data\n");
-                asio::async_write(channel, asio::buffer(error_message),
-                                  [this,handler](system::error_code
-                                                 /*ignored_ec*/,
-                                                 std::size_t
-                                                 /*bytes_transferred*/)
-                                  mutable {
-                                      handler(http_errc::parsing_error);
-                                  });
+                reply_error(handler, error_message, http_errc::parsing_error);
                 return;
             }
         case token::code::error_no_host:
@@ -686,14 +1037,7 @@ void basic_socket<Socket>
                                             "Connection: close\r\n"
                                             "\r\n"
                                             "Host missing\n");
-                asio::async_write(channel, asio::buffer(error_message),
-                                  [this,handler](system::error_code
-                                                 /*ignored_ec*/,
-                                                 std::size_t
-                                                 /*bytes_transferred*/)
-                                  mutable {
-                                      handler(http_errc::parsing_error);
-                                  });
+                reply_error(handler, error_message, http_errc::parsing_error);
                 return;
             }
         case token::code::error_invalid_content_length:
@@ -707,14 +1051,7 @@ void basic_socket<Socket>
                                             "Connection: close\r\n"
                                             "\r\n"
                                             "Invalid content-length\n");
-                asio::async_write(channel, asio::buffer(error_message),
-                                  [this,handler](system::error_code
-                                                 /*ignored_ec*/,
-                                                 std::size_t
-                                                 /*bytes_transferred*/)
-                                  mutable {
-                                      handler(http_errc::parsing_error);
-                                  });
+                reply_error(handler, error_message, http_errc::parsing_error);
                 return;
             }
         case token::code::error_invalid_transfer_encoding:
@@ -727,14 +1064,7 @@ void basic_socket<Socket>
                                             "Connection: close\r\n"
                                             "\r\n"
                                             "Invalid transfer-encoding\n");
-                asio::async_write(channel, asio::buffer(error_message),
-                                  [this,handler](system::error_code
-                                                 /*ignored_ec*/,
-                                                 std::size_t
-                                                 /*bytes_transferred*/)
-                                  mutable {
-                                      handler(http_errc::parsing_error);
-                                  });
+                reply_error(handler, error_message, http_errc::parsing_error);
                 return;
             }
         case token::code::error_chunk_size_overflow:
@@ -747,14 +1077,7 @@ void basic_socket<Socket>
                                             "Connection: close\r\n"
                                             "\r\n"
                                             "Can't process chunk size\n");
-                asio::async_write(channel, asio::buffer(error_message),
-                                  [this,handler](system::error_code
-                                                 /*ignored_ec*/,
-                                                 std::size_t
-                                                 /*bytes_transferred*/)
-                                  mutable {
-                                      handler(http_errc::parsing_error);
-                                  });
+                reply_error(handler, error_message, http_errc::parsing_error);
                 return;
             }
         case token::code::skip:
@@ -763,13 +1086,14 @@ void basic_socket<Socket>
             {
                 auto value = parser.value<token::method>();
                 connect_request = value == "CONNECT";
-                *method = String(value.data(), value.size());
+                nexpect_fields = 0;
+                method->assign(value.data(), value.size());
             }
             break;
         case token::code::request_target:
             {
                 auto value = parser.value<token::request_target>();
-                *path = String(value.data(), value.size());
+                path->assign(value.data(), value.size());
             }
             break;
         case token::code::version:
@@ -791,6 +1115,7 @@ void basic_socket<Socket>
                 auto buf_view = asio::buffer_cast<char*>(buffer);
                 field_name_begin = nparsed;
                 field_name_size = parser.token_size();
+                field_id = parser.value<token::field_name_id>();
 
                 for (std::size_t i = 0 ; i != field_name_size ; ++i) {
                     auto &ch = buf_view[field_name_begin + i];
@@ -814,8 +1139,16 @@ void basic_socket<Socket>
                                        field_name_size);
                 auto value = parser.value<token::field_value>();
 
-                if (modern_http || (name != "expect" && name != "upgrade")) {
-                    if (name == "connection") {
+                bool accepted = !header_filter
+                    || header_filter->accepts(field_id, name);
+
+                if (accepted && (modern_http
+                                 || (field_id != header_id::expect
+                                     && field_id != header_id::upgrade))) {
+                    if (field_id == header_id::expect && !use_trailers)
+                        ++nexpect_fields;
+
+                    if (field_id == header_id::connection) {
                         switch (keep_alive) {
                         case KEEP_ALIVE_UNKNOWN:
                         case KEEP_ALIVE_KEEP_ALIVE_READ:
@@ -847,25 +1180,61 @@ void basic_socket<Socket>
         case token::code::end_of_headers:
             istate = http::read_state::message_ready;
             flags |= READY;
+            prev_writer_state = writer_helper.state;
             writer_helper = http::write_state::empty;
 
-            {
+            if (nexpect_fields > 1) {
                 auto er = message.headers().equal_range("expect");
-                if (std::distance(er.first, er.second) > 1)
-                    message.headers().erase(er.first, er.second);
+                message.headers().erase(er.first, er.second);
             }
+            detail::seal_headers(message.headers(), 0);
 
             if (keep_alive == KEEP_ALIVE_UNKNOWN) {
                 keep_alive = modern_http
                     ? KEEP_ALIVE_KEEP_ALIVE_READ : KEEP_ALIVE_CLOSE_READ;
             }
+
+            if (parser.body_length_known() && parser.body_length() != 0) {
+                detail::reserve_body(message.body(),
+                                     std::min<std::uint_least64_t>(
+                                         parser.body_length(),
+                                         body_reserve_limit_),
+                                     0);
+            }
+
+            ++nrequests;
+            if (pipelined()) {
+                auto &entry = pipeline.push_back();
+                entry.reset();
+                entry.modern_http = modern_http;
+                entry.keep_alive = keep_alive;
+                entry.connect_request = connect_request;
+
+                // `writer_helper` only tracks the oldest pending response
+                if (pipeline.size() != 1)
+                    writer_helper = prev_writer_state;
+            }
             break;
         case token::code::body_chunk:
             {
-                auto value = parser.value<token::body_chunk>();
-                auto begin = asio::buffer_cast<const std::uint8_t*>(value);
-                auto size = asio::buffer_size(value);
-                message.body().insert(message.body().end(), begin, begin + size);
+                system::error_code sink_ec;
+                detail::append_body(message.body(),
+                                    parser.value<token::body_chunk>(),
+                                    sink_ec);
+                if (sink_ec) {
+                    /* The rest of the body is still on the wire and can't be
+                       told apart from the next request. So no more reads are
+                       accepted and the connection closes after the
+                       response. */
+                    clear_buffer();
+                    shrink_buffer();
+                    istate = http::read_state::finished;
+                    keep_alive = KEEP_ALIVE_CLOSE_READ;
+                    if (pipelined())
+                        pipeline.back().keep_alive = KEEP_ALIVE_CLOSE_READ;
+                    handler(sink_ec);
+                    return;
+                }
                 flags |= DATA;
             }
             break;
@@ -875,6 +1244,7 @@ void basic_socket<Socket>
         case token::code::end_of_message:
             istate = http::read_state::empty;
             flags |= END;
+            detail::seal_headers(message.trailers(), 0);
             parser.set_buffer(asio::buffer(buffer + nparsed,
                                            parser.token_size()));
             break;
@@ -897,6 +1267,9 @@ void basic_socket<Socket>
     }
     nparsed = 0;
 
+    if (flags & END)
+        shrink_buffer();
+
     if (target == READY && flags & READY) {
         handler(system::error_code{});
     } else if (target == DATA && flags & (DATA|END)) {
@@ -904,43 +1277,656 @@ void basic_socket<Socket>
     } else if (target == END && flags & END) {
         handler(system::error_code{});
     } else {
-        if (used_size == asio::buffer_size(buffer)) {
-            /* TODO: use `expected_token()` to reply with appropriate "... too
-               long" status code */
+        if (used_size == asio::buffer_size(buffer) && !grow_buffer()) {
+            // Still reading the metadata, so nothing was answered yet
+            if (istate == http::read_state::empty) {
+                reply_buffer_exhausted(handler);
+                return;
+            }
+
             handler(system::error_code{http_errc::buffer_exhausted});
             return;
         }
 
-        // TODO (C++14): move in lambda capture list
-        channel.async_read_some(asio::buffer(buffer + used_size),
-                                [this,handler,method,path,&message]
-                                (const system::error_code &ec,
-                                 std::size_t bytes_transferred) mutable {
+        channel.async_read_some(asio::buffer(buffer + used_size), continuation(
+                                std::move(handler),
+                                [this,method,path,&message]
+                                (Handler &handler, const system::error_code &ec,
+                                 std::size_t bytes_transferred) {
             on_async_read_message<target>(std::move(handler), method, path,
                                           message, ec, bytes_transferred);
+        }));
+    }
+}
+
+template<class Socket>
+void basic_socket<Socket>::set_max_buffer_size(std::size_t size)
+{
+    if (size < asio::buffer_size(initial_buffer)) {
+        throw std::invalid_argument("max buffer size must not be smaller than"
+                                    " the initial buffer");
+    }
+
+    max_buffer_size_ = size;
+}
+
+template<class Socket>
+std::size_t basic_socket<Socket>::max_buffer_size() const
+{
+    return max_buffer_size_;
+}
+
+template<class Socket>
+std::size_t basic_socket<Socket>::buffer_size() const
+{
+    return asio::buffer_size(buffer);
+}
+
+template<class Socket>
+void basic_socket<Socket>::set_buffer_pool(http::buffer_pool &pool)
+{
+    if (asio::buffer_cast<char*>(buffer)
+        != asio::buffer_cast<char*>(initial_buffer)) {
+        throw std::logic_error("the current buffer belongs to another pool");
+    }
+
+    this->pool = &pool;
+}
+
+template<class Socket>
+bool basic_socket<Socket>::body_length_known() const
+{
+    return parser.body_length_known();
+}
+
+template<class Socket>
+std::uint_least64_t basic_socket<Socket>::body_length() const
+{
+    return parser.body_length();
+}
+
+template<class Socket>
+void basic_socket<Socket>::set_body_reserve_limit(std::size_t limit)
+{
+    body_reserve_limit_ = limit;
+}
+
+template<class Socket>
+std::size_t basic_socket<Socket>::body_reserve_limit() const
+{
+    return body_reserve_limit_;
+}
+
+template<class Socket>
+void basic_socket<Socket>::set_header_filter(const http::header_filter *filter)
+{
+    header_filter = filter;
+}
+
+template<class Socket>
+bool basic_socket<Socket>::grow_buffer()
+{
+    const auto size = asio::buffer_size(buffer);
+    if (size >= max_buffer_size_)
+        return false;
+
+    // The whole block is used, so the next growth takes another size class
+    auto grown = pool->acquire(std::min(buffer_pool::block_size(size * 2),
+                                        max_buffer_size_));
+    std::copy_n(asio::buffer_cast<char*>(buffer), used_size,
+                asio::buffer_cast<char*>(grown));
+
+    if (asio::buffer_cast<char*>(buffer)
+        != asio::buffer_cast<char*>(initial_buffer)) {
+        pool->release(buffer);
+    }
+
+    buffer = grown;
+    return true;
+}
+
+template<class Socket>
+void basic_socket<Socket>::shrink_buffer()
+{
+    if (asio::buffer_cast<char*>(buffer)
+        == asio::buffer_cast<char*>(initial_buffer)
+        || used_size > asio::buffer_size(initial_buffer)) {
+        return;
+    }
+
+    std::copy_n(asio::buffer_cast<char*>(buffer), used_size,
+                asio::buffer_cast<char*>(initial_buffer));
+    pool->release(buffer);
+    buffer = initial_buffer;
+}
+
+template<class Socket>
+template<class Handler>
+void basic_socket<Socket>::reply_buffer_exhausted(Handler &handler)
+{
+    using detail::string_literal_buffer;
+
+    asio::const_buffer error_message;
+
+    switch (parser.expected_token()) {
+    case token::code::method:
+        /* A server that receives a request method longer than any that it
+           implements SHOULD respond with a 501 (Not Implemented) status code.
+
+           from section 3.1.1 of RFC7230. */
+        error_message = string_literal_buffer("HTTP/1.1 501 Not Implemented\r\n"
+                                              "Content-Length: 23\r\n"
+                                              "Connection: close\r\n"
+                                              "\r\n"
+                                              "Method not implemented\n");
+        break;
+    case token::code::request_target:
+        /* A server that receives a request-target longer than any URI it
+           wishes to parse MUST respond with a 414 (URI Too Long) status code.
+
+           from section 3.1.1 of RFC7230. */
+        error_message = string_literal_buffer("HTTP/1.1 414 URI Too Long\r\n"
+                                              "Content-Length: 13\r\n"
+                                              "Connection: close\r\n"
+                                              "\r\n"
+                                              "URI too long\n");
+        break;
+    case token::code::field_name:
+    case token::code::field_value:
+        // Section 5 of RFC6585
+        error_message = string_literal_buffer("HTTP/1.1 431 Request Header"
+                                              " Fields Too Large\r\n"
+                                              "Content-Length: 24\r\n"
+                                              "Connection: close\r\n"
+                                              "\r\n"
+                                              "Header fields too large\n");
+        break;
+    default:
+        error_message = string_literal_buffer("HTTP/1.1 400 Bad Request\r\n"
+                                              "Content-Length: 17\r\n"
+                                              "Connection: close\r\n"
+                                              "\r\n"
+                                              "Buffer exhausted\n");
+    }
+
+    clear_buffer();
+    shrink_buffer();
+
+    reply_error(handler, error_message, http_errc::buffer_exhausted);
+}
+
+template<class Socket>
+template<class Handler>
+void basic_socket<Socket>::reply_error(Handler &handler,
+                                       asio::const_buffer error_message,
+                                       http_errc error)
+{
+    if (!pipelined()) {
+        stage_external(error_message);
+        outbound_commit(std::move(handler),
+                        [error](Handler &handler,
+                                system::error_code /*ignored_ec*/) {
+            handler(error);
         });
+        return;
+    }
+
+    /* Earlier requests might still be waiting for their responses, so the
+       reply takes its turn in the pipeline (and closes the connection once
+       written) */
+    ++nrequests;
+    auto &entry = pipeline.push_back();
+    entry.reset();
+    entry.modern_http = true;
+    entry.keep_alive = KEEP_ALIVE_CLOSE_READ;
+    entry.connect_request = false;
+    entry.ready = true;
+    entry.body = error_message;
+    entry.handler.reset(detail::make_completion
+                        (operation_memory, std::move(handler),
+                         [error](Handler &handler,
+                                 system::error_code /*ignored_ec*/) {
+                             handler(error);
+                         }));
+
+    if (pipeline.size() == 1)
+        writer_helper = http::write_state::finished;
+
+    flush_pipeline();
+}
+
+template<class Socket>
+bool basic_socket<Socket>::pipelined() const
+{
+    return max_pipelined > 1;
+}
+
+template<class Socket>
+bool basic_socket<Socket>::out_modern_http() const
+{
+    return (pipelined() && pipeline.size())
+        ? pipeline.front().modern_http : modern_http;
+}
+
+template<class Socket>
+typename basic_socket<Socket>::keep_alive_state&
+basic_socket<Socket>::out_keep_alive()
+{
+    return (pipelined() && pipeline.size())
+        ? pipeline.front().keep_alive : keep_alive;
+}
+
+template<class Socket>
+void basic_socket<Socket>::flush_pipeline()
+{
+    // Consecutive ready responses are merged into the same gathered write
+    while (pipeline_queued != pipeline.size()) {
+        auto &entry = pipeline[pipeline_queued];
+
+        /* Every previous response is queued, so is the interim one (it's
+           written once its request is the oldest pending one) */
+        if (entry.continue_issued && !entry.continue_queued) {
+            entry.continue_queued = true;
+            detail::append_literal(staging_buffer,
+                                   "HTTP/1.1 100 Continue\r\n\r\n");
+            outbound_commit([this](const system::error_code &ec) {
+                pipeline.front().continue_handler.release()->complete(ec);
+            });
+        }
+
+        if (!entry.ready)
+            break;
+
+        ++pipeline_queued;
+        stage_external(asio::buffer(entry.storage));
+        stage_external(entry.body);
+
+        outbound_commit([this](const system::error_code &ec) {
+            --pipeline_queued;
+            auto handler = pipeline.front().handler.release();
+            on_pipelined_response_written();
+            handler->complete(ec);
+        });
+    }
+}
+
+template<class Socket>
+void basic_socket<Socket>::on_pipelined_response_written()
+{
+    is_open_ = pipeline.front().keep_alive == KEEP_ALIVE_KEEP_ALIVE_READ;
+    pipeline.pop_front();
+
+    if (!is_open_)
+        channel.lowest_layer().close();
+
+    if (pipeline.empty())
+        writer_helper = http::write_state::finished;
+    else if (pipeline.front().ready)
+        writer_helper = http::write_state::finished;
+    else if (pipeline.front().continue_issued)
+        writer_helper = http::write_state::continue_issued;
+    else
+        writer_helper = http::write_state::empty;
+
+    if (parked_read)
+        parked_read.release()->complete(system::error_code{});
+
+    flush_pipeline();
+}
+
+template<class Socket>
+template<class CompletionToken>
+typename asio::async_result<
+    typename asio::handler_type<CompletionToken,
+                                void(system::error_code)>::type>::type
+basic_socket<Socket>::async_flush(CompletionToken &&token)
+{
+    typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code)>::type Handler;
+
+    Handler handler(std::forward<CompletionToken>(token));
+
+    asio::async_result<Handler> result(handler);
+
+    outbound_corked = false;
+
+    if (!outbound_writing && !outbound_held && staging_buffer.empty()
+        && external_buffers.empty()) {
+        invoke_handler(std::forward<decltype(handler)>(handler));
+        return result.get();
     }
+
+    outbound_commit(std::move(handler));
+
+    return result.get();
+}
+
+template<class Socket>
+void basic_socket<Socket>::stage_external(asio::const_buffer buffer)
+{
+    if (asio::buffer_size(buffer) == 0)
+        return;
+
+    external_buffers.emplace_back(staging_buffer.size(), buffer);
+}
+
+template<class Socket>
+template<class Handler>
+void basic_socket<Socket>::outbound_commit(Handler &&handler)
+{
+    outbound_commit(std::forward<Handler>(handler), detail::call_with_error{});
+}
+
+template<class Socket>
+template<class Handler, class Function>
+void basic_socket<Socket>::outbound_commit(Handler &&handler,
+                                           Function function)
+{
+    staging_handlers.push(detail::make_completion(operation_memory,
+                                                  std::forward<Handler>
+                                                  (handler),
+                                                  std::move(function)));
+    outbound_corked = false;
+    outbound_flush();
+}
+
+template<class Socket>
+template<class Handler>
+void basic_socket<Socket>::outbound_cork(Handler &&handler)
+{
+    staging_handlers.push(detail::make_completion(operation_memory,
+                                                  std::forward<Handler>
+                                                  (handler),
+                                                  detail::call_with_error{}));
+    if (outbound_corked)
+        return;
+
+    /* Writes issued before the io_service gets back to us join the staged
+       data. No write waits for longer than that. */
+    outbound_corked = true;
+    channel.get_io_service().post(recycling([this]() {
+        if (!outbound_corked)
+            return;
+
+        outbound_corked = false;
+        outbound_flush();
+    }));
+}
+
+template<class Socket>
+void basic_socket<Socket>::outbound_flush()
+{
+    if (outbound_writing || outbound_corked || staging_handlers.empty())
+        return;
+
+    // A body is being sent apart (see `async_write_response_file`)
+    if (outbound_held && !held_node)
+        return;
+
+    std::size_t nexternal = external_buffers.size();
+    inflight_handlers.swap(staging_handlers);
+    if (held_node) {
+        // Writes staged after the held one stay behind
+        inflight_buffer.assign(staging_buffer, 0, held_size);
+        staging_buffer.erase(0, held_size);
+        inflight_handlers.split_after(held_node, staging_handlers);
+        nexternal = held_external;
+        held_node = nullptr;
+    } else {
+        std::swap(inflight_buffer, staging_buffer);
+        staging_buffer.clear();
+    }
+
+    inflight_buffers.clear();
+    std::size_t offset = 0;
+    for (std::size_t i = 0 ; i != nexternal ; ++i) {
+        const auto &e = external_buffers[i];
+        if (e.first != offset) {
+            inflight_buffers.push_back(asio::buffer(inflight_buffer.data()
+                                                    + offset,
+                                                    e.first - offset));
+            offset = e.first;
+        }
+        inflight_buffers.push_back(e.second);
+    }
+    if (offset != inflight_buffer.size()) {
+        inflight_buffers.push_back(asio::buffer(inflight_buffer.data() + offset,
+                                                inflight_buffer.size()
+                                                - offset));
+    }
+    external_buffers.erase(external_buffers.begin(),
+                           external_buffers.begin() + nexternal);
+    for (auto &e: external_buffers)
+        e.first -= inflight_buffer.size();
+
+    outbound_writing = true;
+    asio::async_write(channel,
+                      detail::buffers_view<asio::const_buffer>
+                      (inflight_buffers.data(),
+                       inflight_buffers.data() + inflight_buffers.size()),
+                      recycling([this](const system::error_code &ec,
+                                       std::size_t) {
+        on_outbound_written(ec);
+    }));
+}
+
+template<class Socket>
+void basic_socket<Socket>::on_outbound_written(const system::error_code &ec)
+{
+    outbound_writing = false;
+
+    auto handlers = inflight_handlers.release();
+
+    // Writes queued meanwhile go out before the handlers issue even more
+    outbound_flush();
+
+    detail::completion_queue::complete_all(handlers, ec);
 }
 
 template<class Socket>
 void basic_socket<Socket>::clear_buffer()
 {
     istate = http::read_state::empty;
-    writer_helper.state = http::write_state::empty;
+    // When pipelined, `writer_helper` tracks a response to an earlier request
+    if (!pipelined())
+        writer_helper.state = http::write_state::empty;
     used_size = 0;
     parser.reset();
     expecting_field = false;
 }
 
 template<class Socket>
-template<class Message>
-void basic_socket<Socket>::clear_message(Message &message)
+void basic_socket<Socket>::consume_body(std::uint_least64_t n)
+{
+    parser.consume_body(n);
+    if (parser.body_remaining() != 0)
+        return;
+
+    // `end_of_body` and `end_of_message` (such bodies have no trailers)
+    parser.next();
+    parser.next();
+    istate = http::read_state::empty;
+    shrink_buffer();
+}
+
+#ifdef BOOST_HTTP_DETAIL_HAS_SPLICE
+
+template<class Socket>
+template<class Handler>
+void basic_socket<Socket>::schedule_splice_body(Handler &handler,
+                                                splice_operation op)
+{
+    channel.async_read_some(asio::null_buffers(), continuation(
+                            std::move(handler),
+                            [this,op](Handler &handler,
+                                      const system::error_code &ec,
+                                      std::size_t) {
+        if (ec) {
+            finish_splice_body(handler, op, ec);
+            return;
+        }
+
+        on_splice_body_ready(handler, op);
+    }));
+}
+
+template<class Socket>
+template<class Handler>
+void basic_socket<Socket>::on_splice_body_ready(Handler &handler,
+                                                splice_operation op)
 {
-    message.headers().clear();
-    message.body().clear();
-    message.trailers().clear();
+    // Default pipe capacity
+    const std::uint_least64_t max_splice_size = 65536;
+
+    ssize_t n;
+    do {
+        n = ::splice(channel.native_handle(), NULL, op.pipe[1], NULL,
+                     std::min(parser.body_remaining(), max_splice_size),
+                     SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    } while (n == -1 && errno == EINTR);
+
+    if (n == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            schedule_splice_body(handler, op);
+            return;
+        }
+
+        finish_splice_body(handler, op,
+                           system::error_code(errno,
+                                              system::system_category()));
+        return;
+    }
+
+    if (n == 0) {
+        finish_splice_body(handler, op, asio::error::eof);
+        return;
+    }
+
+    // The pipe is always left empty, so its write end never blocks
+    for (ssize_t left = n ; left != 0 ;) {
+        ssize_t m = ::splice(op.pipe[0], NULL, op.fd, NULL, left,
+                             SPLICE_F_MOVE);
+        if (m == -1) {
+            if (errno == EINTR)
+                continue;
+
+            finish_splice_body(handler, op,
+                               system::error_code(errno,
+                                                  system::system_category()));
+            return;
+        }
+        left -= m;
+    }
+
+    op.nspliced += n;
+    consume_body(n);
+
+    if (parser.body_remaining() == 0) {
+        finish_splice_body(handler, op, system::error_code{});
+        return;
+    }
+
+    schedule_splice_body(handler, op);
+}
+
+template<class Socket>
+template<class Handler>
+void basic_socket<Socket>::finish_splice_body(Handler &handler,
+                                              splice_operation op,
+                                              const system::error_code &ec)
+{
+    ::close(op.pipe[0]);
+    ::close(op.pipe[1]);
+
+    if (ec) {
+        clear_buffer();
+        shrink_buffer();
+    }
+
+    handler(ec, op.nspliced);
 }
 
+#endif // BOOST_HTTP_DETAIL_HAS_SPLICE
+
+#ifdef BOOST_HTTP_DETAIL_HAS_SENDFILE
+
+template<class Socket>
+template<class Handler>
+void basic_socket<Socket>::schedule_send_file(Handler &handler,
+                                              sendfile_operation op)
+{
+    channel.async_write_some(asio::null_buffers(), continuation(
+                             std::move(handler),
+                             [this,op](Handler &handler,
+                                       const system::error_code &ec,
+                                       std::size_t) {
+        if (ec) {
+            finish_send_file(handler, ec);
+            return;
+        }
+
+        on_send_file_ready(handler, op);
+    }));
+}
+
+template<class Socket>
+template<class Handler>
+void basic_socket<Socket>::on_send_file_ready(Handler &handler,
+                                              sendfile_operation op)
+{
+    const std::uint_least64_t max_send_size = 1 << 20;
+
+    ssize_t n;
+    do {
+        n = ::sendfile(channel.native_handle(), op.fd, &op.offset,
+                       std::min(op.remaining, max_send_size));
+    } while (n == -1 && errno == EINTR);
+
+    if (n == -1) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            schedule_send_file(handler, op);
+            return;
+        }
+
+        finish_send_file(handler,
+                         system::error_code(errno, system::system_category()));
+        return;
+    }
+
+    // The file is shorter than announced
+    if (n == 0) {
+        finish_send_file(handler, asio::error::eof);
+        return;
+    }
+
+    op.remaining -= n;
+    if (op.remaining == 0) {
+        finish_send_file(handler, system::error_code{});
+        return;
+    }
+
+    schedule_send_file(handler, op);
+}
+
+template<class Socket>
+template<class Handler>
+void basic_socket<Socket>::finish_send_file(Handler &handler,
+                                            const system::error_code &ec)
+{
+    if (outbound_held) {
+        outbound_held = false;
+        outbound_flush();
+    }
+
+    // A body cut short can't be recovered from
+    is_open_ = !ec && keep_alive == KEEP_ALIVE_KEEP_ALIVE_READ;
+    if (!is_open_)
+        channel.lowest_layer().close();
+    handler(ec);
+}
+
+#endif // BOOST_HTTP_DETAIL_HAS_SENDFILE
+
 template<class Socket>
 template <typename Handler,
           typename ErrorCode>
@@ -948,10 +1934,9 @@ void basic_socket<Socket>::invoke_handler(Handler&& handler,
                                           ErrorCode error)
 {
     channel.get_io_service().post
-        ([handler, error] () mutable
-         {
-             handler(make_error_code(error));
-         });
+        (detail::make_posted_completion(operation_memory,
+                                        std::forward<Handler>(handler),
+                                        make_error_code(error)));
 }
 
 template<class Socket>
@@ -959,10 +1944,28 @@ template <class Handler>
 void basic_socket<Socket>::invoke_handler(Handler&& handler)
 {
     channel.get_io_service().post
-        ([handler] () mutable
-         {
-             handler(system::error_code{});
-         });
+        (detail::make_posted_completion(operation_memory,
+                                        std::forward<Handler>(handler),
+                                        system::error_code{}));
+}
+
+template<class Socket>
+template<class Handler>
+detail::recycling_handler<typename std::decay<Handler>::type>
+basic_socket<Socket>::recycling(Handler &&handler)
+{
+    return detail::make_recycling_handler(operation_memory,
+                                          std::forward<Handler>(handler));
+}
+
+template<class Socket>
+template<class Handler, class Function>
+detail::continuation<typename std::decay<Handler>::type, Function>
+basic_socket<Socket>::continuation(Handler &&handler, Function function)
+{
+    return detail::make_continuation(operation_memory,
+                                     std::forward<Handler>(handler),
+                                     std::move(function));
 }
 
 } // namespace boost
@@ -10,8 +10,8 @@
 #include <cstddef>
 
 #include <algorithm>
-#include <sstream>
 #include <array>
+#include <vector>
 #include <type_traits>
 #include <utility>
 
@@ -23,17 +23,51 @@
 #include <boost/asio/write.hpp>
 
 #include <boost/http/reader/request.hpp>
+#include <boost/http/arena_headers.hpp>
+#include <boost/http/header_id.hpp>
 #include <boost/http/traits.hpp>
 #include <boost/http/read_state.hpp>
 #include <boost/http/write_state.hpp>
 #include <boost/http/http_errc.hpp>
+#include <boost/http/buffer_pool.hpp>
+#include <boost/http/body_sink.hpp>
+#include <boost/http/header_filter.hpp>
+#include <boost/http/monotonic_resource.hpp>
 #include <boost/http/detail/writer_helper.hpp>
 #include <boost/http/detail/constchar_helper.hpp>
+#include <boost/http/detail/serializer.hpp>
+#include <boost/http/detail/handler_memory.hpp>
+#include <boost/http/detail/native_io.hpp>
+#include <boost/http/detail/slot_ring.hpp>
 #include <boost/http/algorithm/header.hpp>
 
+#ifndef BOOST_HTTP_SOCKET_INLINE_BODY_SIZE
+#define BOOST_HTTP_SOCKET_INLINE_BODY_SIZE 1024
+#endif // BOOST_HTTP_SOCKET_INLINE_BODY_SIZE
+
+#ifndef BOOST_HTTP_SOCKET_DEFAULT_MAX_BUFFER_SIZE
+#define BOOST_HTTP_SOCKET_DEFAULT_MAX_BUFFER_SIZE 8192
+#endif // BOOST_HTTP_SOCKET_DEFAULT_MAX_BUFFER_SIZE
+
+#ifndef BOOST_HTTP_SOCKET_DEFAULT_BODY_RESERVE_LIMIT
+#define BOOST_HTTP_SOCKET_DEFAULT_BODY_RESERVE_LIMIT 65536
+#endif // BOOST_HTTP_SOCKET_DEFAULT_BODY_RESERVE_LIMIT
+
 namespace boost {
 namespace http {
 
+namespace detail {
+
+/* Whether a readable lowest layer means a readable `Stream`. Layers in between
+   (e.g. `asio::ssl::stream`) may hold bytes of their own, such as already
+   decrypted records, that a wait on the lowest layer would miss. */
+template<class Stream>
+struct readiness_reflects_input
+    : std::is_base_of<typename Stream::lowest_layer_type, Stream>
+{};
+
+} // namespace detail
+
 template<class Socket>
 class basic_socket
 {
@@ -71,6 +105,31 @@ public:
                                     void(system::error_code)>::type>::type
     async_read_trailers(Message &message, CompletionToken &&token);
 
+    /* Reads the rest of a body with declared length straight into `out`,
+       bypassing the internal buffer and the message. Completes with the
+       number of bytes read (body bytes received along with the metadata were
+       already appended to the message). */
+    template<class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code,
+                                         std::size_t)>::type>::type
+    async_read_body_into(asio::mutable_buffer out, CompletionToken &&token);
+
+#ifdef BOOST_HTTP_DETAIL_HAS_SPLICE
+    /* Moves the rest of a body with declared length from the connection to
+       the file descriptor `fd` (at its current offset) through a pipe, so the
+       bytes never reach user space. Completes with the number of bytes moved.
+       The next layer MUST be a native socket (e.g. `asio::ip::tcp::socket`).
+    */
+    template<class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code,
+                                         std::uint_least64_t)>::type>::type
+    async_splice_body(int fd, CompletionToken &&token);
+#endif // BOOST_HTTP_DETAIL_HAS_SPLICE
+
     // ### END OF READ FUNCTIONS ###
 
     // ### WRITE FUNCTIONS ###
@@ -112,8 +171,95 @@ public:
                                     void(system::error_code)>::type>::type
     async_write_end_of_message(CompletionToken &&token);
 
+    /* Writes `response` with the concatenation of `body` as its body
+       (`response.body()` is ignored). The buffers are gathered in the same
+       write as the metadata, so they MUST stay valid until the operation
+       completes. Pipelining MUST be disabled. */
+    template<class Response, class ConstBufferSequence, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_response_buffers(const Response &response,
+                                 const ConstBufferSequence &body,
+                                 CompletionToken &&token);
+
+#ifdef BOOST_HTTP_DETAIL_HAS_SENDFILE
+    /* Writes `response` with a body of `size` bytes taken from `fd` at
+       `offset` with sendfile(2) (`response.body()` is ignored). `fd` is not
+       closed. The next layer MUST be a native socket and pipelining MUST be
+       disabled. */
+    template<class Response, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_response_file(const Response &response, int fd,
+                              std::uint_least64_t offset,
+                              std::uint_least64_t size,
+                              CompletionToken &&token);
+#endif // BOOST_HTTP_DETAIL_HAS_SENDFILE
+
     // ### END OF WRITE FUNCTIONS ###
 
+    // ### PIPELINING FUNCTIONS ###
+
+    void set_pipeline_depth(std::size_t depth);
+    std::size_t pipeline_depth() const;
+    std::size_t pending_responses() const;
+    std::size_t last_request_id() const;
+
+    template<class Response, class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_write_response(std::size_t request_id, const Response &response,
+                         CompletionToken &&token);
+
+    // ### END OF PIPELINING FUNCTIONS ###
+
+    // ### OUTBOUND QUEUE FUNCTIONS ###
+
+    template<class CompletionToken>
+    typename asio::async_result<
+        typename asio::handler_type<CompletionToken,
+                                    void(system::error_code)>::type>::type
+    async_flush(CompletionToken &&token);
+
+    // ### END OF OUTBOUND QUEUE FUNCTIONS ###
+
+    // ### INPUT BUFFER FUNCTIONS ###
+
+    void set_max_buffer_size(std::size_t size);
+    std::size_t max_buffer_size() const;
+    std::size_t buffer_size() const;
+    void set_buffer_pool(http::buffer_pool &pool);
+
+    // ### END OF INPUT BUFFER FUNCTIONS ###
+
+    // ### BODY FUNCTIONS ###
+
+    /* Whether the request being read declared its body length (i.e. the body
+       isn't chunked). Valid once the request metadata is read. */
+    bool body_length_known() const;
+
+    // The declared body length (0 for requests without body)
+    std::uint_least64_t body_length() const;
+
+    /* Bodies with a known length get their storage reserved once, up to
+       `limit` bytes, as soon as the metadata is read (bodies without
+       `reserve()` are left alone). */
+    void set_body_reserve_limit(std::size_t limit);
+    std::size_t body_reserve_limit() const;
+
+    // ### END OF BODY FUNCTIONS ###
+
+    // ### HEADER FILTER FUNCTIONS ###
+
+    /* Only the fields accepted by `filter` are stored in the messages read
+       from now on (null stores every field). `filter` is not copied. */
+    void set_header_filter(const http::header_filter *filter);
+
+    // ### END OF HEADER FILTER FUNCTIONS ###
+
     // ### START OF basic_server SPECIFIC FUNCTIONS ###
 
     basic_socket(boost::asio::io_service &io_service,
@@ -122,6 +268,15 @@ public:
     template<class... Args>
     basic_socket(boost::asio::mutable_buffer inbuffer, Args&&... args);
 
+    /* Every buffer is borrowed from `pool`, so idle connections hold none
+       (unless `Socket` is layered over another stream, e.g. TLS) */
+    basic_socket(boost::asio::io_service &io_service, http::buffer_pool &pool);
+
+    template<class... Args>
+    basic_socket(http::buffer_pool &pool, Args&&... args);
+
+    ~basic_socket();
+
     next_layer_type &next_layer();
     const next_layer_type &next_layer() const;
 
@@ -148,8 +303,104 @@ private:
 
     void clear_buffer();
 
-    template<class Message>
-    static void clear_message(Message &message);
+    // `n` bytes of the body were read bypassing `buffer`
+    void consume_body(std::uint_least64_t n);
+
+#ifdef BOOST_HTTP_DETAIL_HAS_SPLICE
+    struct splice_operation
+    {
+        int fd;
+        // Read end and write end
+        int pipe[2];
+        std::uint_least64_t nspliced;
+    };
+
+    // Moves one pipe load per readiness notification
+    template<class Handler>
+    void schedule_splice_body(Handler &handler, splice_operation op);
+
+    template<class Handler>
+    void on_splice_body_ready(Handler &handler, splice_operation op);
+
+    template<class Handler>
+    void finish_splice_body(Handler &handler, splice_operation op,
+                            const system::error_code &ec);
+#endif // BOOST_HTTP_DETAIL_HAS_SPLICE
+
+#ifdef BOOST_HTTP_DETAIL_HAS_SENDFILE
+    struct sendfile_operation
+    {
+        int fd;
+        off_t offset;
+        std::uint_least64_t remaining;
+    };
+
+    // Sends one socket buffer worth per readiness notification
+    template<class Handler>
+    void schedule_send_file(Handler &handler, sendfile_operation op);
+
+    template<class Handler>
+    void on_send_file_ready(Handler &handler, sendfile_operation op);
+
+    // Also releases the writes held back while the body was sent
+    template<class Handler>
+    void finish_send_file(Handler &handler, const system::error_code &ec);
+#endif // BOOST_HTTP_DETAIL_HAS_SENDFILE
+
+    bool grow_buffer();
+    void shrink_buffer();
+
+    template<class Handler>
+    void reply_buffer_exhausted(Handler &handler);
+
+    /* Writes the static `error_message` (after every pending response) and
+       then completes `handler` with `error` */
+    template<class Handler>
+    void reply_error(Handler &handler, asio::const_buffer error_message,
+                     http_errc error);
+
+    enum keep_alive_state {
+        KEEP_ALIVE_UNKNOWN,
+        KEEP_ALIVE_CLOSE_READ,
+        KEEP_ALIVE_KEEP_ALIVE_READ
+    };
+
+    /* Appends the metadata (and small bodies) to `staging`. Large bodies are
+       returned to be referenced instead (an empty buffer is returned
+       otherwise). */
+    template<class Response>
+    static asio::const_buffer
+    serialize_response(const Response &response, bool modern_http,
+                       bool connect_request, keep_alive_state &keep_alive,
+                       std::string &staging);
+
+    /* Appends the metadata for a body of `body_size` bytes (sent apart).
+       Returns whether the body is to be sent at all. */
+    template<class Response>
+    static bool
+    serialize_response_metadata(const Response &response, bool modern_http,
+                                bool connect_request,
+                                keep_alive_state &keep_alive,
+                                std::string &staging,
+                                std::uint_least64_t body_size);
+
+    bool pipelined() const;
+    bool out_modern_http() const;
+    keep_alive_state &out_keep_alive();
+    void flush_pipeline();
+    void on_pipelined_response_written();
+
+    void stage_external(asio::const_buffer buffer);
+    template<class Handler>
+    void outbound_commit(Handler &&handler);
+    // Completes with `function(handler, ec)`
+    template<class Handler, class Function>
+    void outbound_commit(Handler &&handler, Function function);
+    // Like `outbound_commit`, but the write waits for the next io_service turn
+    template<class Handler>
+    void outbound_cork(Handler &&handler);
+    void outbound_flush();
+    void on_outbound_written(const system::error_code &ec);
 
     template <typename Handler,
               typename ErrorCode>
@@ -159,6 +410,19 @@ private:
     template<class Handler>
     void invoke_handler(Handler &&handler);
 
+    template<class Handler>
+    detail::recycling_handler<typename std::decay<Handler>::type>
+    recycling(Handler &&handler);
+
+    template<class Handler, class Function>
+    detail::continuation<typename std::decay<Handler>::type, Function>
+    continuation(Handler &&handler, Function function);
+
+    /* Backs every internal operation (reads, writes, posted completions and
+       queued write handlers), so a keep-alive connection in steady state
+       doesn't allocate handlers. Declared first so it outlives `channel`. */
+    detail::handler_memory operation_memory;
+
     Socket channel;
     bool is_open_ = true;
     http::read_state istate;
@@ -167,23 +431,118 @@ private:
     asio::mutable_buffer buffer;
     std::size_t used_size = 0;
 
+    /* `buffer` starts as the user-provided `initial_buffer` and grows with
+       blocks taken from `pool` (up to `max_buffer_size_`) when a token doesn't
+       fit. It goes back to `initial_buffer` once the message is over.
+
+       An empty `initial_buffer` means the socket only borrows a buffer once
+       the peer sends something (and gives it back as soon as every buffered
+       byte is consumed). */
+    asio::mutable_buffer initial_buffer;
+    std::size_t max_buffer_size_;
+    http::buffer_pool *pool = &http::buffer_pool::global();
+
+    const http::header_filter *header_filter = nullptr;
+
+    std::size_t body_reserve_limit_
+        = BOOST_HTTP_SOCKET_DEFAULT_BODY_RESERVE_LIMIT;
+
     reader::request parser;
 
     /* `field_name` value is stored in `[buffer[0], field_name_size)`.
        `expecting_field` means don't touch the buffer or madness will come. */
     std::size_t field_name_size;
+    header_id::value field_id;
     bool expecting_field = false;
+    std::size_t nexpect_fields;
     bool modern_http; // at least HTTP/1.1
-    enum {
-        KEEP_ALIVE_UNKNOWN,
-        KEEP_ALIVE_CLOSE_READ,
-        KEEP_ALIVE_KEEP_ALIVE_READ
-    } keep_alive;
+    keep_alive_state keep_alive;
 
     // Output state
     detail::writer_helper writer_helper;
-    std::string content_length_buffer;
     bool connect_request;
+
+    // Outbound queue {{{
+
+    /* Writes issued while another one is in progress are merged into the next
+       gathered write. Their bytes are rendered into `staging_buffer` (and
+       buffers too large to be copied are referenced from `external_buffers`)
+       while `inflight_buffer` is being written. Both strings are swapped and
+       reused, so steady state writes don't allocate. */
+    std::string staging_buffer;
+    std::string inflight_buffer;
+    // Buffers to be gathered at the given offset of `staging_buffer`
+    std::vector<std::pair<std::size_t, asio::const_buffer>> external_buffers;
+    std::vector<asio::const_buffer> inflight_buffers;
+    detail::completion_queue staging_handlers;
+    detail::completion_queue inflight_handlers;
+    bool outbound_writing = false;
+    /* Response metadata is held back until the first chunk (or a flush)
+       follows it or the io_service runs the posted uncork, so a chunk written
+       right away shares its segment (i.e. the userspace counterpart of
+       `TCP_CORK`/`MSG_MORE`, but bounded by a single turn). */
+    bool outbound_corked = false;
+    /* Set from the moment a response whose body is sent apart (i.e. sendfile)
+       is committed until the body is out. While its metadata is still staged
+       behind another write, `held_node` is the metadata's handler and only
+       the first `held_size` bytes (and `held_external` external buffers) of
+       `staging_buffer` may be flushed. */
+    bool outbound_held = false;
+    detail::completion *held_node = nullptr;
+    std::size_t held_size;
+    std::size_t held_external;
+
+    // }}}
+
+    // Pipelining state {{{
+
+    /* What the response to a request needs to know about it. Responses
+       finished out of order wait here (`ready`) until every previous response
+       is written. */
+    struct pipelined_response
+    {
+        bool modern_http;
+        keep_alive_state keep_alive;
+        bool connect_request;
+
+        bool ready = false;
+        std::string storage;
+        asio::const_buffer body;
+        detail::completion_ptr handler;
+
+        /* `async_write_response_continue` was called for this request while
+           it wasn't the oldest one. The interim response is held back like
+           the final one until every previous response is queued. */
+        bool continue_issued = false;
+        bool continue_queued = false;
+        detail::completion_ptr continue_handler;
+
+        // Ready for the next request (`storage` keeps its capacity)
+        void reset()
+        {
+            ready = false;
+            storage.clear();
+            body = asio::const_buffer();
+            handler.reset();
+            continue_issued = false;
+            continue_queued = false;
+            continue_handler.reset();
+        }
+    };
+
+    std::size_t max_pipelined = 1;
+    // Number of requests whose headers were fully read
+    std::size_t nrequests = 0;
+    /* `pipeline[i]` answers request `nrequests - pipeline.size() + i`. Written
+       responses leave their slots for the next requests, so a steady pipeline
+       doesn't allocate. */
+    detail::slot_ring<pipelined_response> pipeline;
+    // Number of ready responses (from the front) handed to the outbound queue
+    std::size_t pipeline_queued = 0;
+    // `async_read_request` waiting for room in the pipeline
+    detail::completion_ptr parked_read;
+
+    // }}}
 };
 
 typedef basic_socket<boost::asio::ip::tcp::socket> socket;
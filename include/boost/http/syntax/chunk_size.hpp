@@ -10,6 +10,7 @@
 #include <cassert>
 
 #include <boost/utility/string_ref.hpp>
+#include <boost/http/detail/char_class.hpp>
 #include <boost/core/scoped_enum.hpp>
 
 namespace boost {
@@ -7,32 +7,16 @@ namespace boost {
 namespace http {
 namespace syntax {
 
-namespace detail {
-
-template<class CharT>
-bool is_hexdigit(CharT c)
-{
-    switch (c) {
-    case '0': case '1': case '2': case '3': case '4': case '5': case '6':
-    case '7': case '8': case '9': case 'A': case 'B': case 'C': case 'D':
-    case 'E': case 'F': case 'a': case 'b': case 'c': case 'd': case 'e':
-    case 'f':
-        return true;
-    default:
-        return false;
-    }
-}
-
-} // namespace detail
-
 template<class CharT>
 std::size_t chunk_size<CharT>::match(view_type view)
 {
     std::size_t res = 0;
 
     for (std::size_t i = 0 ; i != view.size() ; ++i) {
-        if (!detail::is_hexdigit(view[i]))
+        if (!http::detail::has_char_class(view[i],
+                                          http::detail::char_class::hexdig)) {
             break;
+        }
 
         ++res;
     }
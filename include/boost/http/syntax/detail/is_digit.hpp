@@ -7,6 +7,8 @@
 #ifndef BOOST_HTTP_SYNTAX_DETAIL_IS_DIGIT_HPP
 #define BOOST_HTTP_SYNTAX_DETAIL_IS_DIGIT_HPP
 
+#include <boost/http/detail/char_class.hpp>
+
 namespace boost {
 namespace http {
 namespace syntax {
@@ -15,10 +17,7 @@ namespace detail {
 template<class CharT>
 bool is_digit(CharT c)
 {
-    /* DIGIT          =  %x30-39   ; 0-9
-
-       from Appendix B of RFC5234. */
-    return c >= 0x30 && c <= 0x39;
+    return http::detail::has_char_class(c, http::detail::char_class::digit);
 }
 
 } // namespace detail
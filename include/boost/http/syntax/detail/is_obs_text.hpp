@@ -7,6 +7,8 @@
 #ifndef BOOST_HTTP_SYNTAX_DETAIL_IS_OBS_TEXT_HPP
 #define BOOST_HTTP_SYNTAX_DETAIL_IS_OBS_TEXT_HPP
 
+#include <boost/http/detail/char_class.hpp>
+
 namespace boost {
 namespace http {
 namespace syntax {
@@ -15,7 +17,7 @@ namespace detail {
 template<class CharT>
 bool is_obs_text(CharT c)
 {
-    return c >= 0x80 && c <= 0xFF;
+    return http::detail::has_char_class(c, http::detail::char_class::obs_text);
 }
 
 } // namespace detail
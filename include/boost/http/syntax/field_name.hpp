@@ -8,6 +8,7 @@
 #define BOOST_HTTP_SYNTAX_FIELD_NAME_HPP
 
 #include <boost/utility/string_ref.hpp>
+#include <boost/http/detail/char_class.hpp>
 
 namespace boost {
 namespace http {
@@ -7,31 +7,16 @@ namespace boost {
 namespace http {
 namespace syntax {
 
-namespace detail {
-
-template<class CharT>
-bool is_tchar(CharT c)
-{
-    switch (c) {
-    case '!': case '#': case '$': case '%': case '&': case '\'': case '*':
-    case '+': case '-': case '.': case '^': case '_': case '`': case '|':
-    case '~':
-        return true;
-    default:
-        return isalnum(c);
-    }
-}
-
-} // namespace detail
-
 template<class CharT>
 std::size_t field_name<CharT>::match(view_type view)
 {
     std::size_t res = 0;
 
     for (std::size_t i = 0 ; i != view.size() ; ++i) {
-        if (!detail::is_tchar(view[i]))
+        if (!http::detail::has_char_class(view[i],
+                                          http::detail::char_class::tchar)) {
             break;
+        }
 
         ++res;
     }
@@ -13,13 +13,15 @@ namespace detail {
 template<class CharT>
 bool is_nonnull_field_value_char(CharT c)
 {
-    return is_vchar(c) || is_obs_text(c);
+    return http::detail::has_char_class(c, http::detail::char_class::vchar
+                                        | http::detail::char_class::obs_text);
 }
 
 template<class CharT>
 bool is_field_value_char(CharT c)
 {
-    return is_nonnull_field_value_char(c) || is_ows(c);
+    return http::detail::has_char_class(c, http::detail::char_class
+                                        ::field_value);
 }
 
 } // namespace detail
@@ -12,7 +12,8 @@ namespace detail {
 template<class CharT>
 bool is_reason_phrase_char(CharT ch)
 {
-    return is_ows(ch) || is_vchar(ch) || is_obs_text(ch);
+    return http::detail::has_char_class(ch, http::detail::char_class
+                                        ::field_value);
 }
 
 } // namespace detail
@@ -10,6 +10,7 @@
 #include <boost/utility/string_ref.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/cstdint.hpp>
+#include <boost/http/header_id.hpp>
 
 namespace boost {
 namespace http {
@@ -63,6 +64,14 @@ struct field_name
     static const token::code::value code = token::code::field_name;
 };
 
+/* Same token as `field_name` (or `trailer_name`), classified against the
+   well-known field names. */
+struct field_name_id
+{
+    typedef header_id::value type;
+    static const token::code::value code = token::code::field_name;
+};
+
 struct field_value
 {
     typedef boost::string_ref type;
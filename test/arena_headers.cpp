@@ -0,0 +1,289 @@
+#include <cstdlib>
+#include <type_traits>
+
+#include "unit_test.hpp"
+
+#include "mocksocket.hpp"
+
+#include <boost/http/arena_headers.hpp>
+#include <boost/http/algorithm.hpp>
+#include <boost/http/request.hpp>
+#include <boost/http/response.hpp>
+#include <boost/http/socket.hpp>
+
+using namespace boost;
+using namespace std;
+
+// Heap allocations done by the whole program (see arena_headers_allocations)
+static std::size_t nallocations = 0;
+
+void *operator new(std::size_t size)
+{
+    ++nallocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+template<std::size_t N>
+void fill_vector(vector<char> &v, const char (&s)[N])
+{
+    v.insert(v.end(), s, s + N - 1);
+}
+
+static string to_string(const http::arena_headers &headers)
+{
+    string ret;
+    for (const auto &field: headers) {
+        ret.append(field.first.data(), field.first.size());
+        ret += ": ";
+        ret.append(field.second.data(), field.second.size());
+        ret += '\n';
+    }
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(arena_headers_lookup) {
+    http::arena_headers headers;
+    BOOST_REQUIRE(headers.empty());
+    BOOST_REQUIRE(headers.begin() == headers.end());
+    BOOST_REQUIRE(headers.find("host") == headers.end());
+
+    headers.emplace("x-b", "1");
+    headers.emplace("host", "example.com");
+    headers.emplace("x-b", "2");
+    headers.emplace("accept", "");
+    headers.emplace("x-b", "3");
+
+    BOOST_REQUIRE(headers.size() == 5);
+    BOOST_CHECK(to_string(headers) ==
+                "accept: \n"
+                "host: example.com\n"
+                "x-b: 1\n"
+                "x-b: 2\n"
+                "x-b: 3\n");
+
+    BOOST_CHECK(headers.count("x-b") == 3);
+    BOOST_CHECK(headers.count("x-a") == 0);
+    BOOST_REQUIRE(headers.find("host") != headers.end());
+    BOOST_CHECK(headers.find("host")->second == "example.com");
+    BOOST_CHECK(headers.find("accept")->second.empty());
+    BOOST_CHECK(headers.find("x-a") == headers.end());
+    BOOST_CHECK(headers.find("zzz") == headers.end());
+
+    {
+        auto range = headers.equal_range("x-b");
+        BOOST_REQUIRE(std::distance(range.first, range.second) == 3);
+        BOOST_CHECK(range.first->second == "1");
+        BOOST_CHECK((++range.first)->second == "2");
+        BOOST_CHECK((++range.first)->second == "3");
+    }
+
+    // New fields go after the equivalent names
+    {
+        headers.emplace("x-b", "0");
+        auto it = headers.find("x-b");
+        std::advance(it, 3);
+        BOOST_CHECK(it->second == "0");
+        BOOST_CHECK(++it == headers.end());
+        headers.emplace("content-length", "4");
+        BOOST_CHECK(headers.find("content-length")->second == "4");
+    }
+    BOOST_CHECK(headers.count("x-b") == 4);
+    BOOST_CHECK(headers.lower_bound("x-b")->second == "1");
+    BOOST_CHECK(headers.upper_bound("host")->first == "x-b");
+    BOOST_CHECK(headers.upper_bound("x-b") == headers.end());
+
+    // Sealed, so the const members below only read it
+    headers.emplace("x-a", "5");
+    headers.seal();
+    const http::arena_headers &cheaders = headers;
+    BOOST_CHECK(cheaders.find("content-length")->second == "4");
+    BOOST_CHECK(cheaders.find("x-a")->second == "5");
+    BOOST_CHECK(std::distance(cheaders.begin(), cheaders.end()) == 8);
+}
+
+BOOST_AUTO_TEST_CASE(arena_headers_modifiers) {
+    http::arena_headers headers;
+    headers.emplace("connection", "close");
+    headers.emplace("expect", "100-continue");
+    headers.emplace("expect", "x-other");
+    headers.insert(http::arena_headers::value_type("host", "example.com"));
+    BOOST_CHECK(headers.find("host")->second == "example.com");
+
+    // Views are only stored by `emplace` (fields are read-only)
+    static_assert(std::is_same<decltype(*headers.begin()),
+                               const http::arena_headers::value_type&>::value,
+                  "fields must not be assignable");
+
+    BOOST_CHECK(headers.erase("expect") == 2);
+    BOOST_CHECK(headers.erase("expect") == 0);
+    BOOST_CHECK(to_string(headers) ==
+                "connection: close\n"
+                "host: example.com\n");
+
+    auto it = headers.erase(headers.find("connection"));
+    BOOST_REQUIRE(it != headers.end());
+    BOOST_CHECK(it->first == "host");
+    it = headers.erase(it);
+    BOOST_CHECK(it == headers.end());
+    BOOST_CHECK(headers.empty());
+
+    headers.emplace("a", "1");
+    headers.emplace("b", "2");
+    headers.emplace("c", "3");
+    it = headers.erase(headers.begin(), headers.find("c"));
+    BOOST_CHECK(it == headers.begin());
+    BOOST_CHECK(to_string(headers) == "c: 3\n");
+
+    // The views never point to the caller's strings
+    {
+        std::string name = "x-temporary";
+        std::string value = "value";
+        headers.emplace(name, value);
+        name.assign(name.size(), '?');
+        value.assign(value.size(), '?');
+    }
+    BOOST_CHECK(headers.find("x-temporary")->second == "value");
+
+    headers.clear();
+    BOOST_CHECK(headers.empty());
+    BOOST_CHECK(headers.find("c") == headers.end());
+    headers.emplace("d", "4");
+    BOOST_CHECK(to_string(headers) == "d: 4\n");
+}
+
+BOOST_AUTO_TEST_CASE(arena_headers_copy_move) {
+    http::arena_headers headers;
+    headers.emplace("host", "example.com");
+    headers.emplace("accept", "*/*");
+
+    http::arena_headers copy(headers);
+    BOOST_CHECK(copy == headers);
+    BOOST_CHECK(copy.find("host")->second.data()
+                != headers.find("host")->second.data());
+
+    copy.emplace("x-extra", "1");
+    BOOST_CHECK(copy != headers);
+
+    const char *data = headers.find("host")->second.data();
+    http::arena_headers moved(std::move(headers));
+    BOOST_CHECK(moved.find("host")->second.data() == data);
+    BOOST_CHECK(moved.size() == 2);
+
+    copy = moved;
+    BOOST_CHECK(copy == moved);
+
+    http::arena_headers other;
+    other.emplace("server", "test");
+    swap(other, moved);
+    BOOST_CHECK(to_string(other) ==
+                "accept: */*\n"
+                "host: example.com\n");
+    BOOST_CHECK(to_string(moved) == "server: test\n");
+
+    moved = std::move(other);
+    BOOST_CHECK(moved.find("host")->second.data() == data);
+}
+
+BOOST_AUTO_TEST_CASE(arena_headers_allocations) {
+    http::arena_headers headers;
+    std::vector<std::string> names;
+    for (int i = 0 ; i != 30 ; ++i)
+        names.push_back("x-field-" + std::to_string(i));
+
+    auto fill = [&]() {
+        const std::size_t before = nallocations;
+        for (const auto &name: names)
+            headers.emplace(name, "some value for the field");
+        headers.find("host");
+        return nallocations - before;
+    };
+
+    // Arena block(s), the field vector and the index
+    BOOST_CHECK(fill() <= 4);
+    BOOST_CHECK(headers.count("x-field-7") == 1);
+
+    headers.clear();
+    BOOST_CHECK_EQUAL(fill(), 0u);
+    BOOST_CHECK(headers.count("x-field-7") == 1);
+
+    // Erasing shifts the survivors in place
+    const std::size_t before = nallocations;
+    auto n = headers.erase("x-field-7");
+    // x-field-1 and x-field-10 to x-field-19
+    headers.erase(headers.find("x-field-1"), headers.find("x-field-2"));
+    const std::size_t erase_allocations = nallocations - before;
+    BOOST_CHECK_EQUAL(erase_allocations, 0u);
+    BOOST_CHECK(n == 1);
+    BOOST_CHECK(headers.size() == names.size() - 12);
+    BOOST_CHECK(headers.count("x-field-7") == 0);
+    BOOST_CHECK(headers.count("x-field-8") == 1);
+    BOOST_CHECK(headers.find("x-field-2")->second
+                == "some value for the field");
+}
+
+BOOST_AUTO_TEST_CASE(arena_headers_socket) {
+    asio::io_service ios;
+    char buffer[256];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.back(),
+                "POST /upload HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "X-Tag: a\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "Connection: close\r\n"
+                "\r\n"
+                "4\r\n"
+                "ping\r\n"
+                "0\r\n"
+                "X-Tag: b\r\n"
+                "\r\n");
+
+    http::arena_request request;
+    system::error_code result = asio::error::operation_aborted;
+    socket.async_read_request(request, [&result](system::error_code ec) {
+            result = ec;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(!result);
+    BOOST_CHECK(request.method() == "POST");
+    BOOST_CHECK(request.headers().find("host")->second == "example.com");
+    BOOST_CHECK(request.headers().count("x-tag") == 1);
+
+    while (socket.read_state() != http::read_state::empty) {
+        result = asio::error::operation_aborted;
+        socket.async_read_some(request, [&result](system::error_code ec) {
+                result = ec;
+            });
+        ios.run();
+        ios.reset();
+        BOOST_REQUIRE(!result);
+    }
+    BOOST_CHECK(request.body() == (std::vector<std::uint8_t>{'p', 'i', 'n',
+                                                               'g'}));
+    BOOST_CHECK(request.trailers().find("x-tag")->second == "b");
+
+    http::arena_response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    reply.headers().emplace("x-reply", "yes");
+    result = asio::error::operation_aborted;
+    socket.async_write_response(reply, [&result](system::error_code ec) {
+            result = ec;
+        });
+    ios.run();
+    BOOST_REQUIRE(!result);
+
+    const auto &output = socket.next_layer().output_buffer;
+    std::string written(output.begin(), output.end());
+    BOOST_CHECK(written.find("x-reply: yes\r\n") != std::string::npos);
+    BOOST_CHECK(written.find("connection: close\r\n") != std::string::npos);
+}
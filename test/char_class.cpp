@@ -0,0 +1,106 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include <cstring>
+#include <boost/http/detail/char_class.hpp>
+
+namespace http = boost::http;
+typedef http::detail::char_class char_class;
+
+// Straightforward transcriptions of the ABNF used as the reference
+namespace reference {
+
+bool is_alpha(unsigned c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+bool is_digit(unsigned c)
+{
+    return c >= '0' && c <= '9';
+}
+
+bool is_hexdig(unsigned c)
+{
+    return c != 0 && std::strchr("0123456789ABCDEFabcdef", c) != NULL;
+}
+
+bool is_tchar(unsigned c)
+{
+    return is_alpha(c) || is_digit(c)
+        || (c != 0 && c < 0x80 && std::strchr("!#$%&'*+-.^_`|~", c) != NULL);
+}
+
+bool is_request_target(unsigned c)
+{
+    return is_alpha(c) || is_digit(c)
+        || (c != 0 && c < 0x80
+            && std::strchr("?/-._~%!$&'()*+,;=:@", c) != NULL);
+}
+
+bool is_vchar(unsigned c)
+{
+    return c >= 0x21 && c <= 0x7E;
+}
+
+bool is_obs_text(unsigned c)
+{
+    return c >= 0x80 && c <= 0xFF;
+}
+
+bool is_ows(unsigned c)
+{
+    return c == ' ' || c == '\t';
+}
+
+} // namespace reference
+
+TEST_CASE("Character class table matches the grammar", "[char_class]")
+{
+    for (unsigned i = 0 ; i != 256 ; ++i) {
+        unsigned char c = static_cast<unsigned char>(i);
+        INFO("byte " << i);
+        REQUIRE(http::detail::has_char_class(c, char_class::alpha)
+                == reference::is_alpha(i));
+        REQUIRE(http::detail::has_char_class(c, char_class::digit)
+                == reference::is_digit(i));
+        REQUIRE(http::detail::has_char_class(c, char_class::alnum)
+                == (reference::is_alpha(i) || reference::is_digit(i)));
+        REQUIRE(http::detail::has_char_class(c, char_class::hexdig)
+                == reference::is_hexdig(i));
+        REQUIRE(http::detail::has_char_class(c, char_class::tchar)
+                == reference::is_tchar(i));
+        REQUIRE(http::detail::has_char_class(c, char_class::request_target)
+                == reference::is_request_target(i));
+        REQUIRE(http::detail::has_char_class(c, char_class::vchar)
+                == reference::is_vchar(i));
+        REQUIRE(http::detail::has_char_class(c, char_class::obs_text)
+                == reference::is_obs_text(i));
+        REQUIRE(http::detail::has_char_class(c, char_class::ows)
+                == reference::is_ows(i));
+        REQUIRE(http::detail::has_char_class(c, char_class::field_value)
+                == (reference::is_vchar(i) || reference::is_obs_text(i)
+                    || reference::is_ows(i)));
+    }
+}
+
+TEST_CASE("Character classes of other character types", "[char_class]")
+{
+    // `char` views must agree with `unsigned char` views
+    for (unsigned i = 0 ; i != 256 ; ++i) {
+        char c = static_cast<char>(i);
+        INFO("byte " << i);
+        REQUIRE(http::detail::has_char_class(c, char_class::field_value)
+                == http::detail::has_char_class(static_cast<unsigned char>(i),
+                                                char_class::field_value));
+    }
+
+    // Code points outside of the octet range belong to no class
+    REQUIRE(!http::detail::has_char_class(wchar_t(0x161), char_class::alpha));
+    REQUIRE(!http::detail::has_char_class(wchar_t(0x100),
+                                          char_class::obs_text));
+    REQUIRE(http::detail::has_char_class(wchar_t('a'), char_class::tchar));
+}
@@ -0,0 +1,461 @@
+#include <boost/asio.hpp>
+
+#include "unit_test.hpp"
+
+#include <boost/asio/spawn.hpp>
+
+#include <boost/http/buffered_socket.hpp>
+#include <boost/http/buffered_client_socket.hpp>
+#include <boost/http/connection_pool.hpp>
+#include <boost/http/request.hpp>
+#include <boost/http/response.hpp>
+
+#include "mocksocket.hpp"
+
+using namespace boost;
+using namespace std;
+
+/* Loopback server answering every request with "<method> <target> <body>" and
+   counting accepted connections. */
+struct loopback_server
+{
+    loopback_server(asio::io_service &ios)
+        : acceptor(ios, asio::ip::tcp::endpoint(asio::ip::address_v4
+                                                ::loopback(), 0))
+    {
+        asio::spawn(ios, [this,&ios](asio::yield_context yield) {
+            for (;;) {
+                auto socket = make_shared<http::buffered_socket>(ios);
+                system::error_code ec;
+                acceptor.async_accept(socket->next_layer(), yield[ec]);
+                if (ec)
+                    return;
+
+                ++naccepted;
+                asio::spawn(ios, [socket](asio::yield_context yield) {
+                    serve(*socket, yield);
+                });
+            }
+        });
+    }
+
+    static void serve(http::buffered_socket &socket, asio::yield_context yield)
+    {
+        system::error_code ec;
+        while (socket.is_open()) {
+            http::request request;
+            socket.async_read_request(request, yield[ec]);
+            if (ec)
+                return;
+
+            while (socket.read_state() != http::read_state::empty) {
+                switch (socket.read_state()) {
+                case http::read_state::message_ready:
+                    socket.async_read_some(request, yield[ec]);
+                    break;
+                case http::read_state::body_ready:
+                    socket.async_read_trailers(request, yield[ec]);
+                    break;
+                default:
+                    break;
+                }
+                if (ec)
+                    return;
+            }
+
+            http::response response;
+            response.status_code() = 200;
+            response.reason_phrase() = "OK";
+            string body = request.method() + ' ' + request.target() + ' '
+                + string(request.body().begin(), request.body().end());
+            if (request.method() == "HEAD") {
+                response.headers().emplace("content-length",
+                                           to_string(body.size()));
+            } else {
+                response.body().assign(body.begin(), body.end());
+            }
+            socket.async_write_response(response, yield[ec]);
+            if (ec)
+                return;
+        }
+    }
+
+    string port() const
+    {
+        return to_string(acceptor.local_endpoint().port());
+    }
+
+    asio::ip::tcp::acceptor acceptor;
+    size_t naccepted = 0;
+};
+
+string body_of(const http::response &response)
+{
+    return string(response.body().begin(), response.body().end());
+}
+
+BOOST_AUTO_TEST_CASE(client_socket_ctor) {
+    bool captured = false;
+    try {
+        asio::io_service ios;
+        http::client_socket s(ios, asio::mutable_buffer{});
+    } catch(invalid_argument &) {
+        captured = true;
+    }
+    BOOST_REQUIRE(captured);
+}
+
+BOOST_AUTO_TEST_CASE(client_socket_loopback) {
+    asio::io_service ios;
+    loopback_server server(ios);
+
+    asio::spawn(ios, [&](asio::yield_context yield) {
+        http::buffered_client_socket socket(ios);
+        socket.next_layer().async_connect(server.acceptor.local_endpoint(),
+                                          yield);
+
+        http::request request;
+        http::response response;
+
+        // Nothing to read before a request is written
+        {
+            system::error_code ec;
+            socket.async_read_response(response, yield[ec]);
+            BOOST_CHECK(ec == system::error_code{http::http_errc
+                                                 ::out_of_order});
+        }
+
+        // Simple exchange
+        request.method() = "GET";
+        request.target() = "/hello";
+        request.headers().emplace("host", "localhost");
+        socket.async_write_request(request, yield);
+        BOOST_CHECK(socket.write_state() == http::write_state::empty);
+        BOOST_CHECK(socket.pending_requests() == 1);
+
+        socket.async_read_response(response, yield);
+        BOOST_CHECK(socket.read_state() == http::read_state::empty);
+        BOOST_CHECK(socket.pending_requests() == 0);
+        BOOST_CHECK(response.status_code() == 200);
+        BOOST_CHECK(response.reason_phrase() == "OK");
+        BOOST_CHECK(body_of(response) == "GET /hello ");
+        BOOST_CHECK(response.headers().find("content-length")
+                    != response.headers().end());
+        BOOST_CHECK(socket.is_open());
+
+        // Pipelined requests
+        request.target() = "/1";
+        socket.async_write_request(request, yield);
+        request.method() = "POST";
+        request.target() = "/2";
+        request.body().push_back('x');
+        socket.async_write_request(request, yield);
+        BOOST_CHECK(socket.pending_requests() == 2);
+
+        socket.async_read_response(response, yield);
+        BOOST_CHECK(body_of(response) == "GET /1 ");
+        socket.async_read_response(response, yield);
+        BOOST_CHECK(body_of(response) == "POST /2 x");
+        BOOST_CHECK(socket.pending_requests() == 0);
+
+        // Bodies too large to be inlined in the staging buffer
+        request.target() = "/large";
+        request.body().assign(4096, 'y');
+        socket.async_write_request(request, yield);
+        socket.async_read_response(response, yield);
+        while (socket.read_state() == http::read_state::message_ready)
+            socket.async_read_some(response, yield);
+        if (socket.read_state() == http::read_state::body_ready)
+            socket.async_read_trailers(response, yield);
+        BOOST_CHECK(body_of(response) == "POST /large " + string(4096, 'y'));
+
+        // Chunked upload
+        request.target() = "/upload";
+        request.body().clear();
+        socket.async_write_request_metadata(request, yield);
+        BOOST_CHECK(socket.write_state()
+                    == http::write_state::metadata_issued);
+        {
+            http::request chunk;
+            const char data[] = "chunked";
+            chunk.body().assign(data, data + sizeof(data) - 1);
+            socket.async_write(chunk, yield);
+        }
+        socket.async_write_end_of_message(yield);
+        BOOST_CHECK(socket.write_state() == http::write_state::empty);
+
+        socket.async_read_response(response, yield);
+        BOOST_CHECK(body_of(response) == "POST /upload chunked");
+
+        // HEAD responses have no body even if content-length is present
+        request.method() = "HEAD";
+        request.target() = "/";
+        socket.async_write_request(request, yield);
+        socket.async_read_response(response, yield);
+        BOOST_CHECK(response.status_code() == 200);
+        BOOST_CHECK(response.body().size() == 0);
+        BOOST_CHECK(socket.is_open());
+
+        // The client asks to close the connection
+        request.method() = "GET";
+        request.headers().emplace("connection", "close");
+        socket.async_write_request(request, yield);
+        socket.async_read_response(response, yield);
+        BOOST_CHECK(body_of(response) == "GET / ");
+        BOOST_CHECK(!socket.is_open());
+
+        server.acceptor.close();
+    });
+
+    ios.run();
+    BOOST_CHECK(server.naccepted == 1);
+}
+
+// A failed read leaves the request being written alone
+BOOST_AUTO_TEST_CASE(client_socket_read_error_keeps_writer) {
+    asio::io_service ios;
+    char buffer[64];
+    http::basic_client_socket<mock_socket> socket(ios, asio::buffer(buffer));
+
+    http::request request;
+    request.method() = "POST";
+    request.target() = "/upload";
+    request.headers().emplace("host", "example.com");
+
+    socket.async_write_request_metadata(request, [](system::error_code ec) {
+            BOOST_CHECK(!ec);
+        });
+    // Nothing to read, so the response fails with eof
+    bool read = false;
+    http::response response;
+    socket.async_read_response(response, [&read](system::error_code ec) {
+            BOOST_CHECK(ec == system::error_code{asio::error::eof});
+            read = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(read);
+    BOOST_CHECK(socket.read_state() == http::read_state::empty);
+    BOOST_CHECK(socket.write_state() == http::write_state::metadata_issued);
+
+    // Another request can't be staged under the one being written
+    {
+        bool failed = false;
+        socket.async_write_request(request, [&failed](system::error_code ec) {
+                failed = ec == system::error_code{http::http_errc
+                                                  ::out_of_order};
+            });
+        ios.run();
+        ios.reset();
+        BOOST_CHECK(failed);
+    }
+
+    bool ended = false;
+    socket.async_write_end_of_message([&ended](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            ended = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(ended);
+    BOOST_CHECK(socket.write_state() == http::write_state::empty);
+
+    auto &output = socket.next_layer().output_buffer;
+    std::string written(output.begin(), output.end());
+    BOOST_CHECK(written == "POST /upload HTTP/1.1\r\n"
+                "host: example.com\r\n"
+                "transfer-encoding: chunked\r\n"
+                "\r\n"
+                "0\r\n"
+                "\r\n");
+}
+
+BOOST_AUTO_TEST_CASE(connection_pool_loopback) {
+    asio::io_service ios;
+    loopback_server server(ios);
+
+    asio::spawn(ios, [&](asio::yield_context yield) {
+        http::connection_pool pool(ios);
+        const string host = "127.0.0.1";
+        const string port = server.port();
+
+        http::request request;
+        request.method() = "GET";
+        request.target() = "/";
+        request.headers().emplace("host", "localhost");
+        http::response response;
+
+        // Connecting completes before the server gets to accept
+        auto accepted = [&](size_t expected) {
+            asio::steady_timer timer(ios);
+            for (int i = 0 ; i != 1000 && server.naccepted < expected ; ++i) {
+                timer.expires_from_now(chrono::milliseconds(1));
+                timer.async_wait(yield);
+            }
+            return server.naccepted;
+        };
+
+        // Connections are reused
+        for (int i = 0 ; i != 3 ; ++i) {
+            auto connection = pool.async_acquire(host, port, yield);
+            BOOST_REQUIRE(connection);
+            BOOST_CHECK(pool.idle_count() == 0);
+            connection->async_write_request(request, yield);
+            connection->async_read_response(response, yield);
+            BOOST_CHECK(body_of(response) == "GET / ");
+            pool.release(host, port, std::move(connection));
+            BOOST_CHECK(pool.idle_count() == 1);
+            BOOST_CHECK(pool.idle_count(host, port) == 1);
+        }
+        BOOST_CHECK(server.naccepted == 1);
+
+        // Connections in the middle of an exchange aren't kept
+        {
+            auto connection = pool.async_acquire(host, port, yield);
+            connection->async_write_request(request, yield);
+            pool.release(host, port, std::move(connection));
+            BOOST_CHECK(pool.idle_count() == 0);
+        }
+
+        // Pre-warming
+        pool.async_prewarm(host, port, 3, yield);
+        BOOST_CHECK(pool.idle_count(host, port) == 3);
+        BOOST_CHECK(accepted(4) == 4);
+        pool.async_prewarm(host, port, 2, yield);
+        BOOST_CHECK(pool.idle_count(host, port) == 3);
+
+        // Limits evict the least recently used connections
+        pool.set_max_idle_per_host(2);
+        BOOST_CHECK(pool.idle_count(host, port) == 2);
+        pool.set_max_idle(1);
+        BOOST_CHECK(pool.idle_count() == 1);
+
+        {
+            auto connection = pool.async_acquire(host, port, yield);
+            BOOST_CHECK(pool.idle_count() == 0);
+            connection->async_write_request(request, yield);
+            connection->async_read_response(response, yield);
+            BOOST_CHECK(body_of(response) == "GET / ");
+            BOOST_CHECK(server.naccepted == 4);
+        }
+
+        // Unknown hosts fail
+        {
+            system::error_code ec;
+            auto connection = pool.async_acquire("host.invalid", port,
+                                                 yield[ec]);
+            BOOST_CHECK(ec);
+            BOOST_CHECK(!connection);
+        }
+
+        // Expired idle connections aren't reused
+        BOOST_CHECK(pool.idle_timeout() == chrono::seconds(
+                        BOOST_HTTP_CONNECTION_POOL_DEFAULT_IDLE_TIMEOUT));
+        pool.async_prewarm(host, port, 1, yield);
+        BOOST_CHECK(accepted(5) == 5);
+        pool.set_idle_timeout(chrono::nanoseconds(1));
+        BOOST_CHECK(pool.idle_count() == 1);
+        {
+            asio::steady_timer timer(ios, chrono::milliseconds(1));
+            timer.async_wait(yield);
+        }
+        {
+            auto connection = pool.async_acquire(host, port, yield);
+            BOOST_CHECK(accepted(6) == 6);
+        }
+
+        pool.clear();
+        server.acceptor.close();
+    });
+
+    ios.run();
+}
+
+BOOST_AUTO_TEST_CASE(connection_pool_stale) {
+    asio::io_service ios;
+    asio::ip::tcp::acceptor acceptor(ios, asio::ip::tcp::endpoint(
+                                         asio::ip::address_v4::loopback(), 0));
+    const string host = "127.0.0.1";
+    const string port = to_string(acceptor.local_endpoint().port());
+    size_t naccepted = 0;
+
+    // Answers a single request and closes the connection without a word
+    asio::spawn(ios, [&](asio::yield_context yield) {
+        for (;;) {
+            auto socket = make_shared<asio::ip::tcp::socket>(ios);
+            system::error_code ec;
+            acceptor.async_accept(*socket, yield[ec]);
+            if (ec)
+                return;
+
+            ++naccepted;
+            asio::spawn(ios, [socket](asio::yield_context yield) {
+                system::error_code ec;
+                asio::streambuf buffer;
+                asio::async_read_until(*socket, buffer, "\r\n\r\n", yield[ec]);
+                if (ec)
+                    return;
+                const char response[]
+                    = "HTTP/1.1 200 OK\r\ncontent-length: 0\r\n\r\n";
+                asio::async_write(*socket, asio::buffer(response,
+                                                        sizeof(response) - 1),
+                                  yield[ec]);
+                socket->close();
+            });
+        }
+    });
+
+    asio::spawn(ios, [&](asio::yield_context yield) {
+        http::connection_pool pool(ios);
+
+        http::request request;
+        request.method() = "GET";
+        request.target() = "/";
+        request.headers().emplace("host", "localhost");
+        http::response response;
+
+        for (int i = 0 ; i != 2 ; ++i) {
+            auto connection = pool.async_acquire(host, port, yield);
+            BOOST_REQUIRE(connection);
+            connection->async_write_request(request, yield);
+            connection->async_read_response(response, yield);
+            BOOST_CHECK(response.status_code() == 200);
+            pool.release(host, port, std::move(connection));
+            BOOST_CHECK(pool.idle_count() == 1);
+
+            // Gives the end of the stream time to arrive
+            asio::steady_timer timer(ios, chrono::milliseconds(10));
+            timer.async_wait(yield);
+        }
+
+        // The closed connection was discarded rather than handed out
+        BOOST_CHECK(naccepted == 2);
+        BOOST_CHECK(pool.idle_count() == 1);
+
+        acceptor.close();
+    });
+
+    ios.run();
+}
+
+BOOST_AUTO_TEST_CASE(connection_pool_prewarm_lifetime) {
+    asio::io_service ios;
+    loopback_server server(ios);
+
+    // Connections completing after the pool is gone are just closed
+    system::error_code ec;
+    bool called = false;
+    {
+        http::connection_pool pool(ios);
+        pool.async_prewarm("127.0.0.1", server.port(), 2,
+                           [&](const system::error_code &e) {
+            ec = e;
+            called = true;
+            server.acceptor.close();
+        });
+    }
+
+    ios.run();
+    BOOST_CHECK(called);
+    BOOST_CHECK(ec == asio::error::operation_aborted);
+}
@@ -0,0 +1,517 @@
+#include <boost/asio.hpp>
+
+#include "unit_test.hpp"
+
+#include <cstdlib>
+
+#include <functional>
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <boost/http/compressing_server_socket.hpp>
+#include <boost/http/file_server.hpp>
+#include <boost/http/socket.hpp>
+#include <boost/http/request.hpp>
+#include <boost/http/response.hpp>
+
+#include "mocksocket.hpp"
+
+using namespace boost;
+using namespace std;
+
+typedef http::compressing_server_socket<http::basic_socket<mock_socket>>
+compressing_socket;
+
+// The body of a written response (dechunked if needed)
+static std::string body_of(const std::string &response)
+{
+    auto pos = response.find("\r\n\r\n");
+    BOOST_REQUIRE(pos != std::string::npos);
+    if (response.find("transfer-encoding: chunked") > pos)
+        return response.substr(pos + 4);
+
+    std::string ret;
+    pos += 4;
+    for (;;) {
+        auto end = response.find("\r\n", pos);
+        BOOST_REQUIRE(end != std::string::npos);
+        auto size = std::strtoul(response.substr(pos, end - pos).c_str(),
+                                 nullptr, 16);
+        if (size == 0)
+            return ret;
+        ret.append(response, end + 2, size);
+        pos = end + 2 + size + 2;
+    }
+}
+
+static std::string inflate_body(const std::string &data)
+{
+    z_stream stream = z_stream();
+    // Detects gzip and zlib wrappers
+    BOOST_REQUIRE(inflateInit2(&stream, 15 + 32) == Z_OK);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = data.size();
+
+    std::string ret;
+    int status;
+    do {
+        char buffer[4096];
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        status = inflate(&stream, Z_NO_FLUSH);
+        BOOST_REQUIRE(status != Z_STREAM_ERROR);
+        BOOST_REQUIRE(status != Z_DATA_ERROR);
+        BOOST_REQUIRE(status != Z_BUF_ERROR);
+        ret.append(buffer, sizeof(buffer) - stream.avail_out);
+    } while (status != Z_STREAM_END);
+    inflateEnd(&stream);
+    return ret;
+}
+
+static std::string output_of(compressing_socket &socket)
+{
+    auto &output = socket.next_layer().next_layer().output_buffer;
+    return std::string(output.begin(), output.end());
+}
+
+// Reads a "GET /" with the `headers` lines
+static http::request read_request(compressing_socket &socket,
+                                  asio::io_service &ios,
+                                  const std::string &headers)
+{
+    std::string request_text = "GET / HTTP/1.1\r\n"
+        "Host: example.com\r\n" + headers + "\r\n";
+    socket.next_layer().next_layer().input_buffer
+        .emplace_back(request_text.begin(), request_text.end());
+    socket.next_layer().next_layer().output_buffer.clear();
+
+    http::request request;
+    bool done = false;
+    socket.async_read_request(request, [&done](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            done = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(done);
+    return request;
+}
+
+BOOST_AUTO_TEST_CASE(compressing_server_socket_atomic) {
+    asio::io_service ios;
+    char buffer[512];
+    compressing_socket socket(ios, asio::buffer(buffer));
+
+    std::string text;
+    for (int i = 0 ; i != 200 ; ++i)
+        text += "{\"id\": " + std::to_string(i) + ", \"name\": \"item\"},";
+
+    // Returns the whole response
+    auto exchange = [&](const std::string &accept_encoding,
+                        const std::string &content, const char *type) {
+        read_request(socket, ios, accept_encoding);
+
+        http::response response;
+        response.status_code() = 200;
+        response.reason_phrase() = "OK";
+        response.headers().emplace("content-type", type);
+        response.headers().emplace("etag", "\"v1\"");
+        response.headers().emplace("accept-ranges", "bytes");
+        response.body().assign(content.begin(), content.end());
+        bool done = false;
+        socket.async_write_response(response, [&done](system::error_code ec) {
+                BOOST_REQUIRE(!ec);
+                done = true;
+            });
+        ios.run();
+        ios.reset();
+        BOOST_REQUIRE(done);
+        return output_of(socket);
+    };
+
+    auto gzip = exchange("Accept-Encoding: gzip, deflate\r\n", text,
+                         "application/json");
+    BOOST_CHECK(gzip.find("content-encoding: gzip\r\n") != std::string::npos);
+    BOOST_CHECK(gzip.find("vary: accept-encoding\r\n") != std::string::npos);
+    // Another representation, which can't be resumed with ranges
+    BOOST_CHECK(gzip.find("etag: \"v1-gzip\"\r\n") != std::string::npos);
+    BOOST_CHECK(gzip.find("accept-ranges") == std::string::npos);
+    BOOST_CHECK(body_of(gzip).size() < text.size());
+    BOOST_CHECK(inflate_body(body_of(gzip)) == text);
+
+    auto deflate = exchange("Accept-Encoding: gzip;q=0.5, deflate\r\n", text,
+                            "application/json");
+    BOOST_CHECK(deflate.find("content-encoding: deflate\r\n")
+                != std::string::npos);
+    BOOST_CHECK(deflate.find("etag: \"v1-deflate\"\r\n")
+                != std::string::npos);
+    BOOST_CHECK(inflate_body(body_of(deflate)) == text);
+
+    auto identity = exchange("", text, "application/json");
+    BOOST_CHECK(identity.find("content-encoding") == std::string::npos);
+    BOOST_CHECK(body_of(identity) == text);
+    // It'd be compressed for other clients
+    BOOST_CHECK(identity.find("vary: accept-encoding\r\n")
+                != std::string::npos);
+    BOOST_CHECK(identity.find("etag: \"v1\"\r\n") != std::string::npos);
+    BOOST_CHECK(identity.find("accept-ranges: bytes\r\n")
+                != std::string::npos);
+
+    auto refused = exchange("Accept-Encoding: *;q=0\r\n", text,
+                            "application/json");
+    BOOST_CHECK(body_of(refused) == text);
+
+    auto small = exchange("Accept-Encoding: gzip\r\n", "{}",
+                          "application/json");
+    BOOST_CHECK(small.find("content-encoding") == std::string::npos);
+    BOOST_CHECK(small.find("vary") == std::string::npos);
+    BOOST_CHECK(body_of(small) == "{}");
+
+    auto image = exchange("Accept-Encoding: gzip\r\n", text, "image/png");
+    BOOST_CHECK(image.find("content-encoding") == std::string::npos);
+    BOOST_CHECK(image.find("vary") == std::string::npos);
+    BOOST_CHECK(body_of(image) == text);
+
+    auto svg = exchange("Accept-Encoding: gzip\r\n", text, "image/svg+xml");
+    BOOST_CHECK(svg.find("content-encoding: gzip\r\n") != std::string::npos);
+
+    socket.set_min_size(1);
+    socket.set_compression_level(9);
+    BOOST_CHECK(socket.compression_level() == 9);
+    auto tiny = exchange("Accept-Encoding: gzip\r\n", "{}", "application/json");
+    // Compressing would only make it bigger
+    BOOST_CHECK(body_of(tiny) == "{}");
+    BOOST_CHECK(socket.is_open());
+
+    // The entity tag is replaced when the values are read-only
+    read_request(socket, ios, "Accept-Encoding: gzip\r\n");
+    http::arena_response arena;
+    arena.status_code() = 200;
+    arena.reason_phrase() = "OK";
+    arena.headers().emplace("etag", "\"v1\"");
+    arena.body().assign(text.begin(), text.end());
+    bool done = false;
+    socket.async_write_response(arena, [&done](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            done = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(done);
+    auto encoded = output_of(socket);
+    BOOST_CHECK(encoded.find("etag: \"v1-gzip\"\r\n") != std::string::npos);
+    BOOST_CHECK(inflate_body(body_of(encoded)) == text);
+}
+
+// Each response is encoded as its own request asked, even if read later
+BOOST_AUTO_TEST_CASE(compressing_server_socket_pipelining) {
+    asio::io_service ios;
+    char buffer[512];
+    compressing_socket socket(ios, asio::buffer(buffer));
+    socket.next_layer().set_pipeline_depth(2);
+
+    std::string requests = "GET /1 HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "Accept-Encoding: gzip\r\n"
+        "\r\n"
+        "GET /2 HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "\r\n";
+    socket.next_layer().next_layer().input_buffer
+        .emplace_back(requests.begin(), requests.end());
+
+    std::string text;
+    for (int i = 0 ; i != 200 ; ++i)
+        text += "{\"id\": " + std::to_string(i) + ", \"name\": \"item\"},";
+
+    // Both requests are read before the first response is written
+    http::request request1, request2;
+    int nread = 0;
+    socket.async_read_request(request1, [&nread](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            ++nread;
+        });
+    ios.run();
+    ios.reset();
+    socket.async_read_request(request2, [&nread](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            ++nread;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(nread == 2);
+    BOOST_REQUIRE(socket.next_layer().pending_responses() == 2);
+
+    http::response reply1, reply2;
+    for (auto reply: {&reply1, &reply2}) {
+        reply->status_code() = 200;
+        reply->reason_phrase() = "OK";
+        reply->headers().emplace("content-type", "application/json");
+        reply->body().assign(text.begin(), text.end());
+    }
+    // Each response answers the oldest request not answered yet
+    int nwritten = 0;
+    socket.async_write_response(reply1, [&](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            ++nwritten;
+            socket.async_write_response(reply2,
+                                        [&nwritten](system::error_code ec) {
+                                            BOOST_REQUIRE(!ec);
+                                            ++nwritten;
+                                        });
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(nwritten == 2);
+
+    auto output = output_of(socket);
+    auto second = output.find("HTTP/1.1 200 OK\r\n", 1);
+    BOOST_REQUIRE(second != std::string::npos);
+    auto first_response = output.substr(0, second);
+    auto second_response = output.substr(second);
+    BOOST_CHECK(first_response.find("content-encoding: gzip\r\n")
+                != std::string::npos);
+    BOOST_CHECK(inflate_body(body_of(first_response)) == text);
+    BOOST_CHECK(second_response.find("content-encoding")
+                == std::string::npos);
+    BOOST_CHECK(body_of(second_response) == text);
+}
+
+BOOST_AUTO_TEST_CASE(compressing_server_socket_streaming) {
+    asio::io_service ios;
+    char buffer[512];
+    compressing_socket socket(ios, asio::buffer(buffer));
+
+    auto run = [&ios]() {
+        ios.run();
+        ios.reset();
+    };
+
+    auto write_metadata = [&](http::response &response) {
+        response.status_code() = 200;
+        response.reason_phrase() = "OK";
+        response.headers().emplace("content-type", "text/plain");
+        socket.async_write_response_metadata(response,
+                                             [](system::error_code ec) {
+                                                 BOOST_REQUIRE(!ec);
+                                             });
+        run();
+    };
+
+    auto write = [&](const std::string &data) {
+        http::response chunk;
+        chunk.body().assign(data.begin(), data.end());
+        socket.async_write(chunk, [](system::error_code ec) {
+                BOOST_REQUIRE(!ec);
+            });
+        run();
+    };
+
+    auto end = [&]() {
+        socket.async_write_end_of_message([](system::error_code ec) {
+                BOOST_REQUIRE(!ec);
+            });
+        run();
+    };
+
+    std::string line = "event: tick, payload: 0123456789abcdef\n";
+
+    // Buffered: small writes are held back while the writer is busy
+    {
+        read_request(socket, ios, "Accept-Encoding: gzip\r\n");
+        http::response response;
+        write_metadata(response);
+        auto metadata = output_of(socket);
+
+        http::response chunk, empty;
+        chunk.body().assign(line.begin(), line.end());
+        int nwritten = 0;
+        std::size_t size_while_writing = 0;
+        std::function<void(system::error_code)> on_write
+            = [&](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            if (++nwritten == 3) {
+                size_while_writing = output_of(socket).size();
+                return;
+            }
+            socket.async_write(chunk, on_write);
+        };
+        socket.async_write(chunk, on_write);
+        run();
+        BOOST_CHECK(nwritten == 3);
+        BOOST_CHECK(size_while_writing == metadata.size());
+
+        // And flushed once it goes idle
+        auto size = output_of(socket).size();
+        BOOST_CHECK(size > metadata.size());
+
+        // Explicit flush
+        bool flushed = false;
+        socket.async_write(chunk, [&](system::error_code ec) {
+                BOOST_REQUIRE(!ec);
+                BOOST_CHECK(output_of(socket).size() == size);
+                socket.async_write(empty, [&](system::error_code ec) {
+                        BOOST_REQUIRE(!ec);
+                        BOOST_CHECK(output_of(socket).size() > size);
+                        flushed = true;
+                    });
+            });
+        run();
+        BOOST_CHECK(flushed);
+
+        write(line);
+        end();
+        BOOST_CHECK(output_of(socket).find("content-encoding: gzip\r\n")
+                    != std::string::npos);
+        BOOST_CHECK(inflate_body(body_of(output_of(socket)))
+                    == line + line + line + line + line);
+    }
+
+    // Every write
+    {
+        socket.set_flush(http::compression_flush::every_write);
+        read_request(socket, ios, "Accept-Encoding: deflate\r\n");
+        http::response response;
+        write_metadata(response);
+        std::size_t size = output_of(socket).size();
+
+        std::string expected;
+        for (int i = 0 ; i != 3 ; ++i) {
+            write(line);
+            expected += line;
+            BOOST_CHECK(output_of(socket).size() > size);
+            size = output_of(socket).size();
+        }
+
+        end();
+        BOOST_CHECK(output_of(socket).find("content-encoding: deflate\r\n")
+                    != std::string::npos);
+        BOOST_CHECK(inflate_body(body_of(output_of(socket))) == expected);
+    }
+
+    // Not accepted
+    {
+        read_request(socket, ios, "");
+        http::response response;
+        write_metadata(response);
+        write(line);
+        end();
+        BOOST_CHECK(output_of(socket).find("vary: accept-encoding\r\n")
+                    != std::string::npos);
+        BOOST_CHECK(body_of(output_of(socket)) == line);
+    }
+
+    // Already encoded
+    {
+        read_request(socket, ios, "Accept-Encoding: gzip\r\n");
+        http::response response;
+        response.headers().emplace("content-encoding", "br");
+        write_metadata(response);
+        write(line);
+        end();
+        BOOST_CHECK(body_of(output_of(socket)) == line);
+    }
+
+    // Known to be small
+    {
+        read_request(socket, ios, "Accept-Encoding: gzip\r\n");
+        http::response response;
+        response.headers().emplace("content-length", "10");
+        write_metadata(response);
+        write("0123456789");
+        end();
+        BOOST_CHECK(output_of(socket).find("content-encoding")
+                    == std::string::npos);
+    }
+
+    BOOST_CHECK(socket.is_open());
+}
+
+// Clients send back the tags of the encoded representations
+BOOST_AUTO_TEST_CASE(compressing_server_socket_validators) {
+    asio::io_service ios;
+    char buffer[512];
+    compressing_socket socket(ios, asio::buffer(buffer));
+
+    auto request = read_request(socket, ios, "Accept-Encoding: gzip\r\n"
+                                "If-None-Match: \"a\", W/\"v1-gzip\"\r\n"
+                                "If-Match: \"v1-deflate\"\r\n");
+    BOOST_CHECK(request.headers().find("if-none-match")->second
+                == "\"a\", W/\"v1-gzip\", \"a\", W/\"v1\"");
+    BOOST_CHECK(request.headers().find("if-match")->second
+                == "\"v1-deflate\", \"v1\"");
+
+    // The application's 304 describes the representation the client holds
+    http::response response;
+    response.status_code() = 304;
+    response.reason_phrase() = "Not Modified";
+    response.headers().emplace("etag", "\"v1\"");
+    bool done = false;
+    socket.async_write_response(response, [&done](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            done = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(done);
+    BOOST_CHECK(output_of(socket).find("etag: \"v1-gzip\"\r\n")
+                != std::string::npos);
+
+    // Behind the stage, the file server validates the tags it gave out
+    auto file = filesystem::temp_directory_path() / filesystem::unique_path();
+    std::string text;
+    for (int i = 0 ; i != 200 ; ++i)
+        text += "line " + std::to_string(i) + "\n";
+    {
+        filesystem::ofstream out(file, std::ios::binary);
+        out << text;
+    }
+    http::file_server_options options;
+    options.etag_policy = http::file_etag_policy::metadata;
+    auto etag = http::file_etag(file, options.etag_policy);
+    BOOST_REQUIRE(etag.size() > 2);
+    auto encoded = etag.substr(0, etag.size() - 1) + "-gzip\"";
+
+    auto transmit = [&](const std::string &headers) {
+        auto request = read_request(socket, ios, headers);
+        http::response response;
+        bool done = false;
+        http::async_response_transmit_file(socket, request, response, file,
+                                           false, options,
+                                           [&done](system::error_code ec) {
+                                               BOOST_REQUIRE(!ec);
+                                               done = true;
+                                           });
+        ios.run();
+        ios.reset();
+        BOOST_REQUIRE(done);
+        return output_of(socket);
+    };
+
+    auto full = transmit("Accept-Encoding: gzip\r\n");
+    BOOST_CHECK(full.find("HTTP/1.1 200 OK\r\n") == 0);
+    BOOST_CHECK(full.find("etag: " + encoded + "\r\n") != std::string::npos);
+    BOOST_CHECK(inflate_body(body_of(full)) == text);
+
+    auto not_modified = transmit("Accept-Encoding: gzip\r\n"
+                                 "If-None-Match: " + encoded + "\r\n");
+    BOOST_CHECK(not_modified.find("HTTP/1.1 304 Not Modified\r\n") == 0);
+    BOOST_CHECK(not_modified.find("etag: " + encoded + "\r\n")
+                != std::string::npos);
+
+    auto matched = transmit("Accept-Encoding: gzip\r\n"
+                            "If-Match: " + encoded + "\r\n");
+    BOOST_CHECK(matched.find("HTTP/1.1 200 OK\r\n") == 0);
+    BOOST_CHECK(inflate_body(body_of(matched)) == text);
+
+    auto failed = transmit("Accept-Encoding: gzip\r\n"
+                           "If-Match: \"x-gzip\"\r\n");
+    BOOST_CHECK(failed.find("HTTP/1.1 412 Precondition Failed\r\n") == 0);
+
+    filesystem::remove(file);
+
+    auto untouched = read_request(socket, ios, "If-None-Match: \"v1\"\r\n");
+    BOOST_CHECK(untouched.headers().find("if-none-match")->second
+                == "\"v1\"");
+}
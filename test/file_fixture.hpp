@@ -0,0 +1,210 @@
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <boost/http/file_server.hpp>
+#include <boost/http/socket.hpp>
+#include <boost/http/request.hpp>
+#include <boost/http/response.hpp>
+
+#include "mocksocket.hpp"
+
+// `size` bytes cycling through the alphabet, so ranges are easy to tell apart
+inline std::string alphabet_contents(std::size_t size)
+{
+    std::string ret;
+    ret.reserve(size);
+    for (std::size_t i = 0 ; i != size ; ++i)
+        ret.push_back(char('a' + i % 26));
+    return ret;
+}
+
+// Replaces the contents of `file`
+inline void write_file(const boost::filesystem::path &file,
+                       const std::string &contents)
+{
+    boost::filesystem::ofstream out(file, std::ios::binary);
+    out << contents;
+}
+
+// A new file holding `contents` in the temporary directory
+inline boost::filesystem::path make_temp_file(const std::string &contents)
+{
+    auto file = boost::filesystem::temp_directory_path()
+        / boost::filesystem::unique_path();
+    write_file(file, contents);
+    return file;
+}
+
+// A new empty directory in the temporary directory (canonical path)
+inline boost::filesystem::path make_temp_dir()
+{
+    auto dir = boost::filesystem::temp_directory_path()
+        / boost::filesystem::unique_path();
+    boost::filesystem::create_directory(dir);
+    return boost::filesystem::canonical(dir);
+}
+
+// Removes `path` (recursively) on scope exit, even if a check aborted the test
+struct scoped_remove
+{
+    ~scoped_remove()
+    {
+        boost::system::error_code ignored_ec;
+        boost::filesystem::remove_all(path, ignored_ec);
+    }
+
+    boost::filesystem::path path;
+};
+
+/* Installs `value` as one of the process-wide file server settings for the
+   scope, restoring the previous one even if a check aborted the test */
+template<class T, void (*Set)(T*), T *(*Get)()>
+class scoped_setting
+{
+public:
+    explicit scoped_setting(T *value)
+        : previous(Get())
+    {
+        Set(value);
+    }
+
+    scoped_setting(const scoped_setting&) = delete;
+    scoped_setting &operator=(const scoped_setting&) = delete;
+
+    ~scoped_setting()
+    {
+        Set(previous);
+    }
+
+private:
+    T *previous;
+};
+
+typedef scoped_setting<boost::http::mapped_file_cache,
+                       boost::http::set_file_server_cache,
+                       boost::http::file_server_cache>
+    scoped_file_server_cache;
+
+typedef scoped_setting<boost::http::file_metadata_cache,
+                       boost::http::set_file_server_metadata_cache,
+                       boost::http::file_server_metadata_cache>
+    scoped_file_server_metadata_cache;
+
+// "GET `target`" plus the `headers` lines
+inline std::string get_request(const std::string &target,
+                               const std::string &headers = "")
+{
+    return "GET " + target + " HTTP/1.1\r\n"
+        "Host: example.com\r\n" + headers + "\r\n";
+}
+
+// Everything after the metadata of `response`
+inline std::string body_of(const std::string &response)
+{
+    auto pos = response.find("\r\n\r\n");
+    BOOST_REQUIRE(pos != std::string::npos);
+    return response.substr(pos + 4);
+}
+
+// A mock connection whose requests are answered by the file server
+struct file_server_fixture
+{
+    typedef std::function<void(boost::system::error_code)> handler_type;
+
+    file_server_fixture()
+        : socket(ios, boost::asio::buffer(buffer))
+    {}
+
+    /* Feeds `request_text` to the socket and answers it with
+       `transmit(request, response, handler)`. Returns the completion error
+       and the whole output. Errors reported before the socket was touched are
+       answered with a 404, so the socket is ready for the next request. */
+    template<class Response, class Transmit>
+    std::pair<boost::system::error_code, std::string>
+    exchange(const std::string &request_text, Response response,
+             Transmit transmit)
+    {
+        using namespace boost;
+
+        socket.next_layer().input_buffer.emplace_back(request_text.begin(),
+                                                      request_text.end());
+        socket.next_layer().output_buffer.clear();
+        socket.next_layer().write_calls = 0;
+
+        http::request request;
+        system::error_code result;
+        bool done = false;
+        socket.async_read_request(request, [&](system::error_code ec) {
+                BOOST_REQUIRE(!ec);
+                transmit(request, response, [&](system::error_code ec) {
+                        result = ec;
+                        done = true;
+                    });
+            });
+        ios.run();
+        ios.reset();
+        BOOST_REQUIRE(done);
+
+        if (result && socket.write_state() == http::write_state::empty) {
+            response.status_code() = 404;
+            response.reason_phrase() = "Not Found";
+            socket.async_write_response(response, [](system::error_code) {});
+            ios.run();
+            ios.reset();
+        }
+
+        const auto &output = socket.next_layer().output_buffer;
+        return std::make_pair(result, std::string(output.begin(),
+                                                  output.end()));
+    }
+
+    // Answers with `async_response_transmit_file`, which MUST succeed
+    std::string transmit_file(const std::string &request_text,
+                              const boost::filesystem::path &file,
+                              const boost::http::file_server_options &options
+                              = boost::http::file_server_options(),
+                              boost::http::response response
+                              = boost::http::response())
+    {
+        using namespace boost;
+
+        auto ret = exchange(request_text, std::move(response),
+                            [&](http::request &request,
+                                http::response &response,
+                                handler_type handler) {
+            http::async_response_transmit_file(socket, request, response,
+                                               file, false, options, handler);
+        });
+        BOOST_REQUIRE(!ret.first);
+        return ret.second;
+    }
+
+    // Answers with `async_response_transmit_dir` (serving every file)
+    std::pair<boost::system::error_code, std::string>
+    transmit_dir(const std::string &request_text,
+                 const boost::filesystem::path &root,
+                 const boost::http::file_server_options &options
+                 = boost::http::file_server_options())
+    {
+        using namespace boost;
+
+        return exchange(request_text, http::response(),
+                        [&](http::request &request, http::response &response,
+                            handler_type handler) {
+            auto filter = [](const filesystem::path&) { return true; };
+            http::async_response_transmit_dir(socket, request.target(),
+                                              request, response, root, filter,
+                                              options, handler);
+        });
+    }
+
+    boost::asio::io_service ios;
+    char buffer[512];
+    boost::http::basic_socket<mock_socket> socket;
+};
@@ -0,0 +1,214 @@
+#include "unit_test.hpp"
+
+#include <boost/http/file_metadata_cache.hpp>
+#include "file_fixture.hpp"
+
+using namespace boost;
+using namespace std;
+
+// Lets the cache handle the pending change notifications
+static void handle_events(asio::io_service &ios)
+{
+    for (int i = 0 ; i != 16 ; ++i) {
+        ios.poll();
+        ios.reset();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(file_metadata_cache_lookup) {
+    asio::io_service ios;
+    http::file_metadata_cache cache(ios, std::chrono::hours(1));
+
+    scoped_remove temp{make_temp_dir()};
+    const auto &dir = temp.path;
+    auto file = dir / "file";
+    write_file(file, "0123456789");
+
+    auto a = cache.lookup(file);
+    BOOST_REQUIRE(a);
+    BOOST_CHECK(a->exists);
+    BOOST_CHECK(a->is_regular_file);
+    BOOST_CHECK(a->canonical_path == file);
+    BOOST_CHECK(a->size == 10);
+    BOOST_CHECK(a->last_modified
+                == posix_time::from_time_t(filesystem::last_write_time(file)));
+    BOOST_CHECK(a->http_last_modified
+                == http::to_http_date<std::string>(a->last_modified));
+    BOOST_CHECK(a->etag.size() > 2);
+    BOOST_CHECK(a->etag.front() == '"');
+    BOOST_CHECK(a->etag.back() == '"');
+    BOOST_CHECK(cache.lookup(file) == a);
+
+    auto d = cache.lookup(dir);
+    BOOST_REQUIRE(d);
+    BOOST_CHECK(d->exists);
+    BOOST_CHECK(!d->is_regular_file);
+
+    // Negative entries
+    auto missing = cache.lookup(dir / "missing");
+    BOOST_REQUIRE(missing);
+    BOOST_CHECK(!missing->exists);
+    BOOST_CHECK(cache.lookup(dir / "missing") == missing);
+    BOOST_CHECK(cache.size() == 3);
+
+    cache.invalidate(file);
+    BOOST_CHECK(cache.size() == 2);
+    auto b = cache.lookup(file);
+    BOOST_CHECK(b != a);
+    BOOST_CHECK(b->etag == a->etag);
+
+    cache.clear();
+    BOOST_CHECK(cache.size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(file_metadata_cache_limits) {
+    asio::io_service ios;
+    scoped_remove temp{make_temp_dir()};
+    const auto &dir = temp.path;
+    auto file = dir / "file";
+    write_file(file, "0123456789");
+    filesystem::create_symlink(file, dir / "link");
+
+    // Least recently used entries go first
+    {
+        http::file_metadata_cache cache(ios, std::chrono::hours(1), 2);
+        auto a = cache.lookup(dir / "a");
+        cache.lookup(dir / "b");
+        BOOST_CHECK(cache.lookup(dir / "a") == a);
+        cache.lookup(dir / "c");
+        BOOST_CHECK(cache.size() == 2);
+        BOOST_CHECK(cache.lookup(dir / "a") == a);
+    }
+
+    // Paths crossing symlinks aren't watched, so they expire
+    {
+        http::file_metadata_cache cache(ios, std::chrono::seconds(0));
+        auto a = cache.lookup(dir / "link");
+        BOOST_REQUIRE(a);
+        BOOST_CHECK(a->exists);
+        BOOST_CHECK(a->canonical_path == file);
+        BOOST_CHECK(a->size == 10);
+        BOOST_CHECK(cache.lookup(dir / "link") != a);
+    }
+    {
+        http::file_metadata_cache cache(ios, std::chrono::hours(1));
+        auto a = cache.lookup(dir / "link");
+        BOOST_CHECK(cache.lookup(dir / "link") == a);
+    }
+
+    handle_events(ios);
+}
+
+#ifdef BOOST_HTTP_DETAIL_HAS_INOTIFY
+BOOST_AUTO_TEST_CASE(file_metadata_cache_inotify) {
+    asio::io_service ios;
+    http::file_metadata_cache cache(ios, std::chrono::hours(1));
+    BOOST_REQUIRE(cache.watching());
+
+    scoped_remove temp{make_temp_dir()};
+    const auto &dir = temp.path;
+    auto file = dir / "file";
+    auto nested = dir / "a" / "b" / "file";
+
+    BOOST_CHECK(!cache.lookup(file)->exists);
+    BOOST_CHECK(!cache.lookup(nested)->exists);
+
+    // Creation
+    write_file(file, "0123456789");
+    handle_events(ios);
+    auto a = cache.lookup(file);
+    BOOST_CHECK(a->exists);
+    BOOST_CHECK(a->size == 10);
+
+    // Modification
+    {
+        filesystem::ofstream out(file, std::ios::binary | std::ios::app);
+        out << "abc";
+    }
+    handle_events(ios);
+    BOOST_CHECK(cache.lookup(file)->size == 13);
+
+    // The missing directories are created
+    filesystem::create_directories(nested.parent_path());
+    write_file(nested, "x");
+    handle_events(ios);
+    BOOST_CHECK(cache.lookup(nested)->exists);
+
+    // Removal of a whole directory
+    filesystem::remove_all(dir / "a");
+    handle_events(ios);
+    BOOST_CHECK(!cache.lookup(nested)->exists);
+
+    // Removal
+    filesystem::remove(file);
+    handle_events(ios);
+    BOOST_CHECK(!cache.lookup(file)->exists);
+
+    filesystem::remove_all(dir);
+    handle_events(ios);
+}
+
+// Number of inotify watches held by the process
+static std::size_t count_watches()
+{
+    std::size_t ret = 0;
+    for (filesystem::directory_iterator it("/proc/self/fdinfo"), end
+             ; it != end ; ++it) {
+        filesystem::ifstream in(it->path());
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.compare(0, 11, "inotify wd:") == 0)
+                ++ret;
+        }
+    }
+    return ret;
+}
+
+BOOST_AUTO_TEST_CASE(file_metadata_cache_inotify_limits) {
+    asio::io_service ios;
+    scoped_remove temp{make_temp_dir()};
+    const auto &dir = temp.path;
+    filesystem::create_directory(dir / "a");
+    filesystem::create_directory(dir / "b");
+
+    // Changes further up aren't reported, so watched entries expire too
+    {
+        http::file_metadata_cache cache(ios, std::chrono::seconds(0));
+        BOOST_REQUIRE(cache.watching());
+        auto a = cache.lookup(dir / "a" / "file");
+        BOOST_CHECK(cache.lookup(dir / "a" / "file") != a);
+    }
+    handle_events(ios);
+
+    // Watches go away with the last entry needing them
+    {
+        auto nwatches = count_watches();
+        http::file_metadata_cache cache(ios, std::chrono::hours(1), 2);
+        cache.lookup(dir / "a" / "x");
+        cache.lookup(dir / "a" / "y");
+        BOOST_CHECK(count_watches() == nwatches + 1);
+        cache.lookup(dir / "b" / "x");
+        BOOST_CHECK(count_watches() == nwatches + 2);
+        cache.lookup(dir / "b" / "y");
+        BOOST_CHECK(count_watches() == nwatches + 1);
+        cache.invalidate(dir / "b" / "x");
+        BOOST_CHECK(count_watches() == nwatches + 1);
+        cache.clear();
+        BOOST_CHECK(count_watches() == nwatches);
+        handle_events(ios);
+    }
+    handle_events(ios);
+}
+#endif // BOOST_HTTP_DETAIL_HAS_INOTIFY
+
+BOOST_AUTO_TEST_CASE(file_metadata_cache_file_server_metadata_cache) {
+    BOOST_CHECK(http::file_server_metadata_cache() == nullptr);
+
+    asio::io_service ios;
+    http::file_metadata_cache cache(ios);
+    {
+        scoped_file_server_metadata_cache installed(&cache);
+        BOOST_CHECK(http::file_server_metadata_cache() == &cache);
+    }
+    BOOST_CHECK(http::file_server_metadata_cache() == nullptr);
+}
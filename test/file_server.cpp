@@ -2,8 +2,8 @@
 
 #include "unit_test.hpp"
 
-#include <boost/http/file_server.hpp>
-#include "mocksocket.hpp"
+#include <boost/http/buffered_socket.hpp>
+#include "file_fixture.hpp"
 
 using namespace boost;
 using namespace std;
@@ -51,3 +51,454 @@ BOOST_AUTO_TEST_CASE(resolve_dots_or_throw_not_found) {
     BOOST_CHECK_EQUAL(resolve_dots_or_throw_not_found(path{} / "abc" / ".."),
                       path{});
 }
+
+#ifdef BOOST_HTTP_DETAIL_HAS_SENDFILE
+// `socket` is a ServerSocket over a tcp::socket not connected yet
+template<class ServerSocket>
+static void check_sendfile(ServerSocket &socket)
+{
+    using asio::ip::tcp;
+
+    const auto contents = alphabet_contents(300000);
+    scoped_remove file{make_temp_file(contents)};
+
+    auto &ios = socket.get_io_service();
+    tcp::acceptor acceptor(ios, tcp::endpoint(asio::ip::address_v4
+                                              ::loopback(), 0));
+    tcp::socket client(ios);
+    client.connect(acceptor.local_endpoint());
+    acceptor.accept(socket.next_layer());
+
+    // Returns the body (after checking the metadata has `expected`)
+    auto exchange = [&](const std::string &request_text,
+                        const std::string &expected) {
+        asio::write(client, asio::buffer(request_text));
+
+        http::request request;
+        http::response response;
+        bool done = false;
+        socket.async_read_request(request, [&](system::error_code ec) {
+                BOOST_REQUIRE(!ec);
+                http::async_response_transmit_file(socket, request, response,
+                                                   file.path,
+                                                   [&done](system::error_code
+                                                           ec) {
+                                                       BOOST_REQUIRE(!ec);
+                                                       done = true;
+                                                   });
+            });
+
+        asio::streambuf input;
+        std::size_t metadata_size = 0;
+        asio::async_read_until(client, input, "\r\n\r\n",
+                               [&](system::error_code ec, std::size_t n) {
+                                   BOOST_REQUIRE(!ec);
+                                   metadata_size = n;
+                               });
+        while (!metadata_size)
+            ios.run_one();
+        ios.reset();
+
+        std::string metadata(asio::buffer_cast<const char*>(input.data()),
+                             metadata_size);
+        input.consume(metadata_size);
+        BOOST_CHECK(metadata.find(expected) != std::string::npos);
+        BOOST_CHECK(metadata.find("transfer-encoding")
+                    == std::string::npos);
+
+        auto pos = metadata.find("content-length: ");
+        BOOST_REQUIRE(pos != std::string::npos);
+        std::size_t length = std::stoul(metadata.substr(pos + 16));
+
+        bool read = false;
+        asio::async_read(client, input,
+                         asio::transfer_exactly(length - input.size()),
+                         [&read](system::error_code ec, std::size_t) {
+                             BOOST_REQUIRE(!ec);
+                             read = true;
+                         });
+        while (!read || !done)
+            ios.run_one();
+        ios.reset();
+
+        return std::string(asio::buffer_cast<const char*>(input.data()),
+                           input.size());
+    };
+
+    BOOST_CHECK(exchange("GET / HTTP/1.1\r\n"
+                         "Host: example.com\r\n"
+                         "\r\n", "HTTP/1.1 200 OK\r\n") == contents);
+    BOOST_CHECK(socket.is_open());
+
+    BOOST_CHECK(exchange("GET / HTTP/1.1\r\n"
+                         "Host: example.com\r\n"
+                         "Range: bytes=1000-200999\r\n"
+                         "\r\n", "HTTP/1.1 206 Partial Content\r\n")
+                == contents.substr(1000, 200000));
+    BOOST_CHECK(socket.is_open());
+}
+
+BOOST_AUTO_TEST_CASE(file_server_sendfile) {
+    asio::io_service ios;
+    char buffer[512];
+    http::basic_socket<asio::ip::tcp::socket> socket(ios,
+                                                     asio::buffer(buffer));
+    check_sendfile(socket);
+
+    http::buffered_socket buffered(ios);
+    check_sendfile(buffered);
+}
+#endif // BOOST_HTTP_DETAIL_HAS_SENDFILE
+
+#ifdef BOOST_HTTP_DETAIL_HAS_MMAP
+BOOST_AUTO_TEST_CASE(file_server_mapped) {
+    const auto contents = alphabet_contents(100000);
+    scoped_remove file{make_temp_file(contents)};
+
+    http::mapped_file_cache cache;
+    scoped_file_server_cache installed(&cache);
+
+    file_server_fixture server;
+    auto exchange = [&](const std::string &headers) {
+        return server.transmit_file(get_request("/", headers), file.path);
+    };
+    auto &socket = server.socket;
+
+    auto full = exchange("");
+    BOOST_CHECK(full.find("HTTP/1.1 200 OK\r\n") == 0);
+    BOOST_CHECK(full.find("content-length: 100000\r\n") != std::string::npos);
+    BOOST_CHECK(body_of(full) == contents);
+    BOOST_CHECK(cache.size() == 1);
+
+    auto single = exchange("Range: bytes=1000-50999\r\n");
+    BOOST_CHECK(single.find("HTTP/1.1 206 Partial Content\r\n") == 0);
+    BOOST_CHECK(single.find("content-range: bytes 1000-50999/100000\r\n")
+                != std::string::npos);
+    BOOST_CHECK(body_of(single) == contents.substr(1000, 50000));
+    // Metadata and body are gathered in a single write
+    BOOST_CHECK(socket.next_layer().write_calls == 1);
+
+    auto multi = exchange("Range: bytes=0-9,-5\r\n");
+    BOOST_CHECK(multi.find("HTTP/1.1 206 Partial Content\r\n") == 0);
+    BOOST_CHECK(multi.find("content-type: multipart/byteranges;boundary="
+                           BOOST_HTTP_FILE_SERVER_BOUNDARY "\r\n")
+                != std::string::npos);
+    BOOST_CHECK(body_of(multi)
+                == "\r\n--" BOOST_HTTP_FILE_SERVER_BOUNDARY "\r\n"
+                "content-range: bytes 0-9/100000\r\n"
+                "\r\n" + contents.substr(0, 10)
+                + "\r\n--" BOOST_HTTP_FILE_SERVER_BOUNDARY "\r\n"
+                "content-range: bytes 99995-99999/100000\r\n"
+                "\r\n" + contents.substr(99995)
+                + "\r\n--" BOOST_HTTP_FILE_SERVER_BOUNDARY "--\r\n");
+    BOOST_CHECK(socket.next_layer().write_calls == 1);
+
+    // Every response shared the same mapping, which is idle again
+    BOOST_CHECK(cache.size() == 1);
+    BOOST_CHECK(cache.mapped_size() == contents.size());
+    BOOST_CHECK(socket.is_open());
+}
+#endif // BOOST_HTTP_DETAIL_HAS_MMAP
+
+BOOST_AUTO_TEST_CASE(file_server_metadata_cache) {
+    // Separate, as the change notifications are always awaited
+    asio::io_service cache_ios;
+    http::file_metadata_cache cache(cache_ios, std::chrono::hours(1));
+    scoped_file_server_metadata_cache installed(&cache);
+
+    scoped_remove dir{make_temp_dir()};
+    file_server_fixture server;
+
+    // Returns the completion error and the whole response
+    auto exchange = [&](const std::string &target) {
+        return server.transmit_dir(get_request(target), dir.path);
+    };
+
+    auto missing = exchange("/file");
+    BOOST_CHECK(missing.first
+                == system::error_code{http::file_server_errc::file_not_found});
+    BOOST_CHECK(cache.size() == 2);
+
+    write_file(dir.path / "file", "0123456789");
+    cache_ios.poll();
+    cache_ios.reset();
+    cache_ios.poll();
+    if (!cache.watching())
+        cache.clear();
+    auto found = exchange("/file");
+    BOOST_CHECK(!found.first);
+    BOOST_CHECK(found.second.find("HTTP/1.1 200 OK\r\n") == 0);
+    BOOST_CHECK(found.second.find("last-modified: "
+                                  + cache.lookup(dir.path / "file")
+                                  ->http_last_modified + "\r\n")
+                != std::string::npos);
+    BOOST_CHECK(found.second.find("0123456789") != std::string::npos);
+
+    auto directory = exchange("/");
+    BOOST_CHECK(directory.first
+                == system::error_code{http::file_server_errc
+                                      ::file_type_not_supported});
+}
+
+BOOST_AUTO_TEST_CASE(file_server_etag) {
+    scoped_remove file{make_temp_file("0123456789")};
+    file_server_fixture server;
+    http::file_server_options options;
+
+    // Returns the whole response
+    auto exchange = [&](const std::string &headers) {
+        return server.transmit_file(get_request("/", headers), file.path,
+                                    options);
+    };
+
+    // Opt-in
+    BOOST_CHECK(exchange("").find("etag") == std::string::npos);
+
+    for (auto policy: {http::file_etag_policy::metadata,
+                       http::file_etag_policy::content_hash}) {
+        options.etag_policy = policy;
+
+        auto etag = http::file_etag(file.path, policy);
+        BOOST_REQUIRE(etag.size() > 2);
+        BOOST_CHECK(etag.front() == '"');
+        BOOST_CHECK(etag.back() == '"');
+        BOOST_CHECK(http::file_etag(file.path, policy) == etag);
+
+        auto full = exchange("");
+        BOOST_CHECK(full.find("HTTP/1.1 200 OK\r\n") == 0);
+        BOOST_CHECK(full.find("etag: " + etag + "\r\n") != std::string::npos);
+
+        auto not_modified = exchange("If-None-Match: \"x\", " + etag + "\r\n");
+        BOOST_CHECK(not_modified.find("HTTP/1.1 304 Not Modified\r\n") == 0);
+        BOOST_CHECK(not_modified.find("etag: " + etag + "\r\n")
+                    != std::string::npos);
+
+        auto weak = exchange("If-None-Match: W/" + etag + "\r\n");
+        BOOST_CHECK(weak.find("HTTP/1.1 304 Not Modified\r\n") == 0);
+
+        auto matched = exchange("If-Match: " + etag + "\r\n");
+        BOOST_CHECK(matched.find("HTTP/1.1 200 OK\r\n") == 0);
+
+        auto failed = exchange("If-Match: \"x\"\r\n");
+        BOOST_CHECK(failed.find("HTTP/1.1 412 Precondition Failed\r\n") == 0);
+
+        auto resumed = exchange("Range: bytes=5-\r\n"
+                                "If-Range: " + etag + "\r\n");
+        BOOST_CHECK(resumed.find("HTTP/1.1 206 Partial Content\r\n") == 0);
+        BOOST_CHECK(resumed.find("content-range: bytes 5-9/10\r\n")
+                    != std::string::npos);
+
+        auto restarted = exchange("Range: bytes=5-\r\n"
+                                  "If-Range: \"x\"\r\n");
+        BOOST_CHECK(restarted.find("HTTP/1.1 200 OK\r\n") == 0);
+
+        auto weak_range = exchange("Range: bytes=5-\r\n"
+                                   "If-Range: W/" + etag + "\r\n");
+        BOOST_CHECK(weak_range.find("HTTP/1.1 200 OK\r\n") == 0);
+    }
+
+    // Different contents, different tags
+    auto content_etag
+        = http::file_etag(file.path, http::file_etag_policy::content_hash);
+    write_file(file.path, "9876543210");
+    auto t = filesystem::last_write_time(file.path);
+    filesystem::last_write_time(file.path, t + 10);
+    BOOST_CHECK(http::file_etag(file.path,
+                                http::file_etag_policy::content_hash)
+                != content_etag);
+    BOOST_CHECK(http::file_etag(file.path,
+                                http::file_etag_policy::none).empty());
+    BOOST_CHECK(http::file_etag(file.path.parent_path(),
+                                http::file_etag_policy::metadata).empty());
+
+    // Big files aren't hashed
+    write_file(file.path,
+               std::string(BOOST_HTTP_FILE_ETAG_MAX_HASH_SIZE + 1, 'a'));
+    BOOST_CHECK(http::file_etag(file.path,
+                                http::file_etag_policy::content_hash)
+                == http::file_etag(file.path,
+                                   http::file_etag_policy::metadata));
+}
+
+BOOST_AUTO_TEST_CASE(file_server_precompressed) {
+    scoped_remove dir{make_temp_dir()};
+    auto file = dir.path / "app.js";
+    write_file(file, "plain contents");
+    write_file(dir.path / "app.js.gz", "gzip contents");
+    write_file(dir.path / "app.js.br", "br contents");
+    auto t = filesystem::last_write_time(file);
+    filesystem::last_write_time(dir.path / "app.js.gz", t + 10);
+    filesystem::last_write_time(dir.path / "app.js.br", t + 10);
+
+    file_server_fixture server;
+    http::file_server_options options;
+    options.precompressed = true;
+
+    // Returns the whole response
+    auto exchange = [&](const std::string &headers, const std::string &etag) {
+        http::response response;
+        if (etag.size())
+            response.headers().emplace("etag", etag);
+        return server.transmit_file(get_request("/", headers), file, options,
+                                    std::move(response));
+    };
+
+    auto has = [](const std::string &response, const std::string &text) {
+        return response.find(text) != std::string::npos;
+    };
+
+    auto identity = exchange("", "");
+    BOOST_CHECK(has(identity, "plain contents"));
+    BOOST_CHECK(!has(identity, "content-encoding"));
+    BOOST_CHECK(has(identity, "vary: accept-encoding\r\n"));
+
+    auto gzip = exchange("Accept-Encoding: gzip\r\n", "");
+    BOOST_CHECK(has(gzip, "gzip contents"));
+    BOOST_CHECK(has(gzip, "content-encoding: gzip\r\n"));
+    BOOST_CHECK(has(gzip, "vary: accept-encoding\r\n"));
+
+    BOOST_CHECK(has(exchange("Accept-Encoding: X-GZIP\r\n", ""),
+                    "gzip contents"));
+    BOOST_CHECK(has(exchange("Accept-Encoding: gzip, deflate, br\r\n", ""),
+                    "content-encoding: br\r\n"));
+    BOOST_CHECK(has(exchange("Accept-Encoding: br;q=0.5, gzip;q=0.8\r\n", ""),
+                    "content-encoding: gzip\r\n"));
+    BOOST_CHECK(has(exchange("Accept-Encoding: br;q=0, *\r\n", ""),
+                    "content-encoding: gzip\r\n"));
+    BOOST_CHECK(has(exchange("Accept-Encoding: gzip;q=0.5, identity\r\n", ""),
+                    "plain contents"));
+    BOOST_CHECK(has(exchange("Accept-Encoding: gzip;q=0\r\n", ""),
+                    "plain contents"));
+    BOOST_CHECK(has(exchange("Accept-Encoding: gzip;q=2\r\n", ""),
+                    "plain contents"));
+
+    // Ranges apply to the encoded representation
+    auto range = exchange("Accept-Encoding: gzip\r\n"
+                          "Range: bytes=0-3\r\n", "");
+    BOOST_CHECK(range.find("HTTP/1.1 206 Partial Content\r\n") == 0);
+    BOOST_CHECK(has(range, "content-range: bytes 0-3/13\r\n"));
+    BOOST_CHECK(has(range, "content-encoding: gzip\r\n"));
+
+    // And so do the entity tags
+    auto tagged = exchange("Accept-Encoding: br\r\n", "\"v1\"");
+    BOOST_CHECK(has(tagged, "etag: \"v1-br\"\r\n"));
+    auto not_modified = exchange("Accept-Encoding: br\r\n"
+                                 "If-None-Match: \"v1-br\"\r\n", "\"v1\"");
+    BOOST_CHECK(not_modified.find("HTTP/1.1 304 Not Modified\r\n") == 0);
+    BOOST_CHECK(has(not_modified, "content-encoding: br\r\n"));
+    auto other = exchange("If-None-Match: \"v1-br\"\r\n", "\"v1\"");
+    BOOST_CHECK(other.find("HTTP/1.1 200 OK\r\n") == 0);
+    BOOST_CHECK(has(other, "etag: \"v1\"\r\n"));
+
+    // The options reach the file through `async_response_transmit_dir` too
+    auto dir_response = server.transmit_dir(get_request("/app.js",
+                                                        "Accept-Encoding: gzip"
+                                                        "\r\n"),
+                                            dir.path, options);
+    BOOST_CHECK(!dir_response.first);
+    BOOST_CHECK(has(dir_response.second, "gzip contents"));
+
+    // Disabled by default
+    options = http::file_server_options();
+    BOOST_CHECK(has(exchange("Accept-Encoding: gzip\r\n", ""),
+                    "plain contents"));
+    options.precompressed = true;
+
+    // Stale siblings are ignored
+    filesystem::last_write_time(dir.path / "app.js.gz", t - 10);
+    filesystem::remove(dir.path / "app.js.br");
+    auto stale = exchange("Accept-Encoding: gzip, br\r\n", "");
+    BOOST_CHECK(has(stale, "plain contents"));
+    BOOST_CHECK(!has(stale, "vary"));
+
+    /* A sibling gone after being picked (here, through the stale metadata of
+       a cache) fails the transmission, but leaves the response as given */
+    filesystem::last_write_time(dir.path / "app.js.gz", t + 10);
+    asio::io_service cache_ios;
+    http::file_metadata_cache cache(cache_ios, std::chrono::hours(1));
+    scoped_file_server_metadata_cache installed(&cache);
+    BOOST_REQUIRE(cache.lookup(dir.path / "app.js.gz")->exists);
+    filesystem::remove(dir.path / "app.js.gz");
+
+    http::response response;
+    response.headers().emplace("etag", "\"v1\"");
+    auto gone = server.exchange(get_request("/", "Accept-Encoding: gzip\r\n"),
+                                std::move(response),
+                                [&](http::request &request,
+                                    http::response &response,
+                                    file_server_fixture::handler_type
+                                    handler) {
+        http::async_response_transmit_file(server.socket, request, response,
+                                           file, false, options, handler);
+    });
+    BOOST_CHECK(gone.first
+                == system::error_code{http::file_server_errc::io_error});
+    BOOST_CHECK(gone.second.find("HTTP/1.1 404 Not Found\r\n") == 0);
+    BOOST_CHECK(!has(gone.second, "content-encoding"));
+    BOOST_CHECK(!has(gone.second, "vary"));
+    BOOST_CHECK(has(gone.second, "etag: \"v1\"\r\n"));
+}
+
+// The entity tag is replaced, not edited, when the values are read-only
+BOOST_AUTO_TEST_CASE(file_server_precompressed_arena) {
+    scoped_remove dir{make_temp_dir()};
+    auto file = dir.path / "app.js";
+    write_file(file, "plain contents");
+    write_file(dir.path / "app.js.gz", "gzip contents");
+    auto t = filesystem::last_write_time(file);
+    filesystem::last_write_time(dir.path / "app.js.gz", t + 10);
+
+    file_server_fixture server;
+    http::file_server_options options;
+    options.precompressed = true;
+    options.etag_policy = http::file_etag_policy::metadata;
+
+    auto has = [](const std::string &response, const std::string &text) {
+        return response.find(text) != std::string::npos;
+    };
+
+    auto exchange = [&](const std::string &headers, http::arena_response
+                        response) {
+        return server.exchange(get_request("/", headers), std::move(response),
+                               [&](http::request &request,
+                                   http::arena_response &response,
+                                   file_server_fixture::handler_type
+                                   handler) {
+            http::async_response_transmit_file(server.socket, request,
+                                               response, file, false, options,
+                                               handler);
+        });
+    };
+
+    http::arena_response tagged;
+    tagged.headers().emplace("etag", "\"v1\"");
+    auto gzip = exchange("Accept-Encoding: gzip\r\n", std::move(tagged));
+    BOOST_CHECK(!gzip.first);
+    BOOST_CHECK(has(gzip.second, "gzip contents"));
+    BOOST_CHECK(has(gzip.second, "content-encoding: gzip\r\n"));
+    BOOST_CHECK(has(gzip.second, "etag: \"v1-gzip\"\r\n"));
+    BOOST_CHECK(has(gzip.second, "last-modified: "));
+
+    // Tags generated for the encoded file are added as new fields
+    auto generated = exchange("Accept-Encoding: gzip\r\n",
+                              http::arena_response());
+    BOOST_CHECK(!generated.first);
+    BOOST_CHECK(has(generated.second, "gzip contents"));
+    BOOST_CHECK(has(generated.second, "etag: \""));
+
+    // And the response is restored when the sibling is gone
+    asio::io_service cache_ios;
+    http::file_metadata_cache cache(cache_ios, std::chrono::hours(1));
+    scoped_file_server_metadata_cache installed(&cache);
+    BOOST_REQUIRE(cache.lookup(dir.path / "app.js.gz")->exists);
+    filesystem::remove(dir.path / "app.js.gz");
+
+    tagged = http::arena_response();
+    tagged.headers().emplace("etag", "\"v1\"");
+    auto gone = exchange("Accept-Encoding: gzip\r\n", std::move(tagged));
+    BOOST_CHECK(gone.first
+                == system::error_code{http::file_server_errc::io_error});
+    BOOST_CHECK(gone.second.find("HTTP/1.1 404 Not Found\r\n") == 0);
+    BOOST_CHECK(!has(gone.second, "content-encoding"));
+    BOOST_CHECK(has(gone.second, "etag: \"v1\"\r\n"));
+}
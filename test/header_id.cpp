@@ -0,0 +1,161 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "common.hpp"
+#include <cctype>
+#include <string>
+#include <boost/http/header_id.hpp>
+#include <boost/http/reader/request.hpp>
+#include <boost/http/reader/response.hpp>
+
+namespace asio = boost::asio;
+namespace http = boost::http;
+
+struct well_known_header
+{
+    const char *name;
+    http::header_id::value id;
+};
+
+const well_known_header well_known_headers[] = {
+    { "accept", http::header_id::accept },
+    { "accept-charset", http::header_id::accept_charset },
+    { "accept-encoding", http::header_id::accept_encoding },
+    { "accept-language", http::header_id::accept_language },
+    { "accept-ranges", http::header_id::accept_ranges },
+    { "age", http::header_id::age },
+    { "allow", http::header_id::allow },
+    { "authorization", http::header_id::authorization },
+    { "cache-control", http::header_id::cache_control },
+    { "connection", http::header_id::connection },
+    { "content-disposition", http::header_id::content_disposition },
+    { "content-encoding", http::header_id::content_encoding },
+    { "content-language", http::header_id::content_language },
+    { "content-length", http::header_id::content_length },
+    { "content-location", http::header_id::content_location },
+    { "content-range", http::header_id::content_range },
+    { "content-type", http::header_id::content_type },
+    { "cookie", http::header_id::cookie },
+    { "date", http::header_id::date },
+    { "etag", http::header_id::etag },
+    { "expect", http::header_id::expect },
+    { "expires", http::header_id::expires },
+    { "forwarded", http::header_id::forwarded },
+    { "from", http::header_id::from },
+    { "host", http::header_id::host },
+    { "if-match", http::header_id::if_match },
+    { "if-modified-since", http::header_id::if_modified_since },
+    { "if-none-match", http::header_id::if_none_match },
+    { "if-range", http::header_id::if_range },
+    { "if-unmodified-since", http::header_id::if_unmodified_since },
+    { "keep-alive", http::header_id::keep_alive },
+    { "last-modified", http::header_id::last_modified },
+    { "location", http::header_id::location },
+    { "max-forwards", http::header_id::max_forwards },
+    { "origin", http::header_id::origin },
+    { "pragma", http::header_id::pragma },
+    { "proxy-authenticate", http::header_id::proxy_authenticate },
+    { "proxy-authorization", http::header_id::proxy_authorization },
+    { "range", http::header_id::range },
+    { "referer", http::header_id::referer },
+    { "retry-after", http::header_id::retry_after },
+    { "server", http::header_id::server },
+    { "set-cookie", http::header_id::set_cookie },
+    { "te", http::header_id::te },
+    { "trailer", http::header_id::trailer },
+    { "transfer-encoding", http::header_id::transfer_encoding },
+    { "upgrade", http::header_id::upgrade },
+    { "user-agent", http::header_id::user_agent },
+    { "vary", http::header_id::vary },
+    { "via", http::header_id::via },
+    { "warning", http::header_id::warning },
+    { "www-authenticate", http::header_id::www_authenticate },
+    { "x-forwarded-for", http::header_id::x_forwarded_for }
+};
+
+TEST_CASE("to_header_id", "[header_id]")
+{
+    const std::size_t n = sizeof(well_known_headers)
+        / sizeof(well_known_headers[0]);
+    REQUIRE(n == http::header_id::x_forwarded_for);
+
+    for (std::size_t i = 0 ; i != n ; ++i) {
+        std::string name = well_known_headers[i].name;
+        INFO(name);
+        REQUIRE(http::to_header_id(name) == well_known_headers[i].id);
+
+        std::string upper = name;
+        for (std::size_t j = 0 ; j != upper.size() ; ++j)
+            upper[j] = std::toupper(upper[j]);
+        REQUIRE(http::to_header_id(upper) == well_known_headers[i].id);
+
+        // Same size, first, middle and last octets, different name
+        std::string other = name;
+        if (other.size() > 2) {
+            std::size_t mid = other.size() / 2;
+            std::size_t j = (mid == 1) ? 2 : 1;
+            other[j] = (other[j] == 'q') ? 'z' : 'q';
+            REQUIRE(http::to_header_id(other) == http::header_id::unknown);
+        }
+
+        REQUIRE(http::to_header_id(name + "s") != well_known_headers[i].id);
+        REQUIRE(http::to_header_id(name.substr(1))
+                != well_known_headers[i].id);
+    }
+
+    REQUIRE(http::to_header_id("") == http::header_id::unknown);
+    REQUIRE(http::to_header_id("x") == http::header_id::unknown);
+    REQUIRE(http::to_header_id("X-Powered-By") == http::header_id::unknown);
+    REQUIRE(http::to_header_id("Hos\x54") == http::header_id::host);
+    REQUIRE(http::to_header_id(std::string("hos\0", 4))
+            == http::header_id::unknown);
+    REQUIRE(http::to_header_id("content-length-and-more-bytes")
+            == http::header_id::unknown);
+}
+
+TEST_CASE("Parsers classify field names", "[header_id]")
+{
+    http::reader::request parser;
+    parser.set_buffer(my_buffer("GET / HTTP/1.1\r\n"
+                                "hOST: example.com\r\n"
+                                "X-Custom: 1\r\n"
+                                "Transfer-Encoding: chunked\r\n"
+                                "\r\n"
+                                "0\r\n"
+                                "Expect: 100-continue\r\n"
+                                "\r\n"));
+
+    http::header_id::value expected[] = {
+        http::header_id::host,
+        http::header_id::unknown,
+        http::header_id::transfer_encoding,
+        http::header_id::expect
+    };
+    std::size_t nfields = 0;
+
+    while (parser.code() != http::token::code::end_of_message) {
+        REQUIRE(parser.code() != http::token::code::error_invalid_data);
+        if (parser.code() == http::token::code::field_name
+            || parser.code() == http::token::code::trailer_name) {
+            REQUIRE(nfields < 4);
+            REQUIRE(parser.value<http::token::field_name_id>()
+                    == expected[nfields++]);
+        }
+        parser.next();
+    }
+    REQUIRE(nfields == 4);
+
+    http::reader::response rparser;
+    rparser.set_buffer(my_buffer("HTTP/1.1 200 OK\r\n"
+                                 "content-LENGTH: 0\r\n"
+                                 "\r\n"));
+    do {
+        rparser.next();
+        if (rparser.code() == http::token::code::status_code)
+            rparser.set_method("GET");
+    } while (rparser.code() != http::token::code::field_name);
+    REQUIRE(rparser.value<http::token::field_name_id>()
+            == http::header_id::content_length);
+}
@@ -0,0 +1,133 @@
+#include "unit_test.hpp"
+
+#include <boost/http/mapped_file_cache.hpp>
+#include "file_fixture.hpp"
+
+using namespace boost;
+using namespace std;
+
+static std::string to_string(const http::mapped_file &mapping)
+{
+    return std::string(reinterpret_cast<const char*>(mapping.data()),
+                       mapping.size());
+}
+
+#ifdef BOOST_HTTP_DETAIL_HAS_MMAP
+BOOST_AUTO_TEST_CASE(mapped_file_cache_acquire) {
+    http::mapped_file_cache cache;
+    scoped_remove temp{make_temp_file("0123456789")};
+    const auto &file = temp.path;
+
+    auto a = cache.acquire(file);
+    BOOST_REQUIRE(a);
+    BOOST_CHECK(to_string(*a) == "0123456789");
+    BOOST_CHECK(asio::buffer_size(a->buffer(2, 5)) == 5);
+    BOOST_CHECK(asio::buffer_cast<const std::uint8_t*>(a->buffer(2, 5))
+                == a->data() + 2);
+
+    // Same mapping, even through another spelling of the path
+    auto b = cache.acquire(file.parent_path() / "." / file.filename());
+    BOOST_CHECK(a == b);
+    BOOST_CHECK(cache.size() == 1);
+    BOOST_CHECK(cache.mapped_size() == 10);
+
+    // A replaced file is mapped again (the old mapping stays valid)
+    filesystem::remove(file);
+    write_file(file, "abcdefghijklmnopqrst");
+    auto c = cache.acquire(file);
+    BOOST_REQUIRE(c);
+    BOOST_CHECK(c != a);
+    BOOST_CHECK(to_string(*c) == "abcdefghijklmnopqrst");
+    BOOST_CHECK(to_string(*a) == "0123456789");
+    BOOST_CHECK(cache.size() == 1);
+    BOOST_CHECK(cache.mapped_size() == 30);
+
+    a.reset();
+    b.reset();
+    BOOST_CHECK(cache.mapped_size() == 20);
+
+    // Mappings outlive the cache entries
+    cache.clear();
+    BOOST_CHECK(cache.size() == 0);
+    BOOST_CHECK(cache.mapped_size() == 20);
+    c.reset();
+    BOOST_CHECK(cache.mapped_size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file_cache_acquire_metadata) {
+    http::mapped_file_cache cache;
+    scoped_remove temp{make_temp_file("0123456789")};
+    const auto &file = temp.path;
+
+    auto metadata = http::file_metadata_cache::query(file);
+    BOOST_REQUIRE(metadata);
+    auto a = cache.acquire(*metadata);
+    BOOST_REQUIRE(a);
+    BOOST_CHECK(to_string(*a) == "0123456789");
+    BOOST_CHECK(cache.acquire(*metadata) == a);
+    BOOST_CHECK(cache.acquire(file) == a);
+
+    /* Stale metadata never gets the new contents (only the mapping it
+       describes, while cached) */
+    filesystem::remove(file);
+    write_file(file, "abcdefghijklmnopqrst");
+    BOOST_CHECK(cache.acquire(*metadata) == a);
+    cache.clear();
+    BOOST_CHECK(!cache.acquire(*metadata));
+    BOOST_CHECK(cache.size() == 0);
+
+    metadata = http::file_metadata_cache::query(file);
+    BOOST_REQUIRE(metadata);
+    auto b = cache.acquire(*metadata);
+    BOOST_REQUIRE(b);
+    BOOST_CHECK(to_string(*b) == "abcdefghijklmnopqrst");
+    BOOST_CHECK(to_string(*a) == "0123456789");
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file_cache_budget) {
+    http::mapped_file_cache cache(100);
+    BOOST_CHECK(cache.budget() == 100);
+
+    scoped_remove big{make_temp_file(std::string(80, 'a'))};
+    scoped_remove small{make_temp_file(std::string(50, 'b'))};
+    scoped_remove huge{make_temp_file(std::string(101, 'c'))};
+    scoped_remove empty{make_temp_file("")};
+
+    BOOST_CHECK(!cache.acquire(huge.path));
+    BOOST_CHECK(!cache.acquire(empty.path));
+    auto dir = big.path.parent_path();
+    BOOST_CHECK(!cache.acquire(dir / filesystem::unique_path()));
+    BOOST_CHECK(!cache.acquire(dir));
+    BOOST_CHECK(cache.size() == 0);
+
+    // Mappings in use are never dropped
+    auto a = cache.acquire(big.path);
+    BOOST_REQUIRE(a);
+    BOOST_CHECK(!cache.acquire(small.path));
+    BOOST_CHECK(cache.size() == 1);
+
+    // But idle ones are
+    a.reset();
+    BOOST_CHECK(cache.mapped_size() == 80);
+    auto b = cache.acquire(small.path);
+    BOOST_REQUIRE(b);
+    BOOST_CHECK(cache.size() == 1);
+    BOOST_CHECK(cache.mapped_size() == 50);
+
+    cache.set_budget(200);
+    BOOST_CHECK(cache.acquire(big.path));
+    BOOST_CHECK(cache.size() == 2);
+    BOOST_CHECK(cache.mapped_size() == 130);
+}
+#endif // BOOST_HTTP_DETAIL_HAS_MMAP
+
+BOOST_AUTO_TEST_CASE(mapped_file_cache_file_server_cache) {
+    BOOST_CHECK(http::file_server_cache() == nullptr);
+
+    http::mapped_file_cache cache;
+    {
+        scoped_file_server_cache installed(&cache);
+        BOOST_CHECK(http::file_server_cache() == &cache);
+    }
+    BOOST_CHECK(http::file_server_cache() == nullptr);
+}
@@ -1,6 +1,7 @@
 #include <vector>
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/buffer.hpp>
+#include <boost/asio/detail/bind_handler.hpp>
 
 class mock_socket
 {
@@ -35,9 +36,10 @@ public:
         asio::async_result<Handler> result(handler);
 
         if (input_buffer.size() == 0 || input_buffer.front().size() == 0) {
-            io_service.post([handler]() mutable {
-                    handler(system::error_code(asio::error::eof), 0);
-                });
+            io_service.post(asio::detail::bind_handler
+                            (std::move(handler),
+                             system::error_code(asio::error::eof),
+                             std::size_t(0)));
             return result.get();
         }
 
@@ -52,9 +54,36 @@ public:
             input_buffer.front() = std::move(v);
         }
 
-        io_service.post([handler, bytes_transfered]() mutable {
-                handler(system::error_code(), bytes_transfered);
-            });
+        io_service.post(asio::detail::bind_handler(std::move(handler),
+                                                   system::error_code(),
+                                                   bytes_transfered));
+
+        return result.get();
+    }
+
+    // Waits for readability
+    template<class CompletionToken>
+    typename boost::asio::async_result<
+        typename boost::asio::handler_type<
+            CompletionToken, void(boost::system::error_code, std::size_t)
+        >::type>::type
+    async_read_some(const boost::asio::null_buffers&, CompletionToken &&token)
+    {
+        using namespace boost;
+
+        typedef typename asio::handler_type<
+        CompletionToken, void(system::error_code, std::size_t)>::type Handler;
+
+        Handler handler(std::forward<CompletionToken>(token));
+        asio::async_result<Handler> result(handler);
+
+        ++readiness_waits;
+        system::error_code ec;
+        if (input_buffer.size() == 0 || input_buffer.front().size() == 0)
+            ec = asio::error::eof;
+
+        io_service.post(asio::detail::bind_handler(std::move(handler), ec,
+                                                   std::size_t(0)));
 
         return result.get();
     }
@@ -80,15 +109,15 @@ public:
         Handler handler(std::forward<CompletionToken>(token));
         asio::async_result<Handler> result(handler);
 
+        ++write_calls;
         auto more = asio::buffer_size(buffers);
         auto offset = output_buffer.size();
         output_buffer.resize(offset + more);
         asio::buffer_copy(asio::buffer(output_buffer.data() + offset, more),
                           buffers);
 
-        io_service.post([more,handler]() mutable {
-                handler(system::error_code(), more);
-            });
+        io_service.post(asio::detail::bind_handler(std::move(handler),
+                                                   system::error_code(), more));
 
         return result.get();
     }
@@ -100,6 +129,8 @@ public:
 
     std::vector<std::vector<char>> input_buffer;
     std::vector<char> output_buffer;
+    std::size_t write_calls = 0;
+    std::size_t readiness_waits = 0;
 
 private:
     boost::asio::io_service &io_service;
@@ -0,0 +1,224 @@
+#include <cstdlib>
+
+#include "unit_test.hpp"
+
+#include "mocksocket.hpp"
+
+#include <boost/http/monotonic_resource.hpp>
+#include <boost/http/request.hpp>
+#include <boost/http/response.hpp>
+#include <boost/http/socket.hpp>
+
+using namespace boost;
+using namespace std;
+
+// Heap allocations done by the whole program (see monotonic_resource_socket)
+static std::size_t nallocations = 0;
+
+void *operator new(std::size_t size)
+{
+    ++nallocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+template<std::size_t N>
+void fill_vector(vector<char> &v, const char (&s)[N])
+{
+    v.insert(v.end(), s, s + N - 1);
+}
+
+BOOST_AUTO_TEST_CASE(monotonic_resource_allocate) {
+    http::monotonic_resource resource(64);
+    BOOST_CHECK(resource.nblocks() == 0);
+
+    void *a = resource.allocate(10, 1);
+    void *b = resource.allocate(8, 8);
+    BOOST_CHECK(resource.nblocks() == 1);
+    BOOST_CHECK(b > a);
+    BOOST_CHECK(reinterpret_cast<std::uintptr_t>(b) % 8 == 0);
+
+    // Bigger than what's left
+    void *c = resource.allocate(200);
+    BOOST_CHECK(resource.nblocks() == 2);
+    BOOST_CHECK(reinterpret_cast<std::uintptr_t>(c)
+                % alignof(std::max_align_t) == 0);
+
+    resource.deallocate(c, 200);
+    BOOST_CHECK(resource.nblocks() == 2);
+    BOOST_CHECK(resource.live_allocations() == 2);
+
+    // `a` and `b` are still in use
+    BOOST_CHECK(!resource.release());
+    BOOST_CHECK(resource.nblocks() == 2);
+
+    resource.deallocate(a, 10, 1);
+    resource.deallocate(b, 8, 8);
+
+    // The largest block is kept
+    BOOST_CHECK(resource.release());
+    BOOST_CHECK(resource.nblocks() == 1);
+    std::size_t before = nallocations;
+    void *d = resource.allocate(200);
+    std::size_t allocations = nallocations - before;
+    BOOST_CHECK(d == c);
+    BOOST_CHECK_EQUAL(allocations, 0u);
+
+    http::monotonic_resource moved(std::move(resource));
+    BOOST_CHECK(resource.nblocks() == 0);
+    BOOST_CHECK(moved.nblocks() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(monotonic_resource_allocator) {
+    http::monotonic_resource resource;
+    http::monotonic_resource other;
+
+    http::resource_allocator<char> a(&resource);
+    http::resource_allocator<std::uint8_t> b(a);
+    BOOST_CHECK(a == b);
+    BOOST_CHECK(a != http::resource_allocator<char>(&other));
+    BOOST_CHECK(a != http::resource_allocator<char>());
+
+    http::resource_string s(&resource);
+    s.assign(100, 'x');
+    BOOST_CHECK(resource.nblocks() == 1);
+
+    // Copies don't share the resource
+    http::resource_string copy(s);
+    BOOST_CHECK(copy.get_allocator() == http::resource_allocator<char>());
+    BOOST_CHECK(copy == s);
+
+    // Default constructed allocators use the global heap
+    std::size_t before = nallocations;
+    http::resource_body body;
+    body.resize(100);
+    std::size_t allocations = nallocations - before;
+    BOOST_CHECK_EQUAL(allocations, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(monotonic_resource_reset_message) {
+    http::monotonic_resource resource;
+    http::monotonic_request request(&resource);
+    request.method() = "POST";
+    request.target().assign(64, '/');
+    request.headers().emplace("host", "example.com");
+    request.body().resize(512);
+    request.trailers().emplace("x-checksum", "0");
+
+    BOOST_CHECK(!resource.release());
+
+    http::reset_message(request);
+    BOOST_CHECK(resource.live_allocations() == 0);
+    BOOST_CHECK(request.method().empty());
+    BOOST_CHECK(request.target().capacity() < 64);
+    BOOST_CHECK(request.headers().empty());
+    BOOST_CHECK(request.body().capacity() == 0);
+    BOOST_CHECK(request.trailers().empty());
+
+    // Members still draw from the resource
+    BOOST_CHECK(request.target().get_allocator().resource() == &resource);
+    BOOST_CHECK(request.body().get_allocator().resource() == &resource);
+
+    http::response reply;
+    reply.reason_phrase() = "OK";
+    reply.headers().emplace("server", "test");
+    reply.body().resize(10);
+    http::reset_message(reply);
+    BOOST_CHECK(reply.reason_phrase().empty());
+    BOOST_CHECK(reply.headers().empty());
+    BOOST_CHECK(reply.body().capacity() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(monotonic_resource_socket) {
+    asio::io_service ios;
+    char buffer[512];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+
+    const std::size_t ncycles = 8;
+    for (std::size_t i = 0 ; i != ncycles ; ++i) {
+        socket.next_layer().input_buffer.emplace_back();
+        fill_vector(socket.next_layer().input_buffer.back(),
+                    "POST /some/rather/long/path/to/defeat/the/sso HTTP/1.1\r\n"
+                    "Host: example.com\r\n"
+                    "User-Agent: a user agent string long enough too\r\n"
+                    "Content-Length: 40\r\n"
+                    "\r\n"
+                    "0123456789012345678901234567890123456789");
+    }
+
+    http::monotonic_resource resource;
+    http::monotonic_request request(&resource);
+    http::monotonic_response reply(&resource);
+
+    std::size_t nreads = 0;
+    std::size_t nwrites = 0;
+    // The request is reset (and the resource rewound) by the socket
+    auto cycle = [&]() {
+        http::reset_message(reply);
+
+        socket.async_read_request(request, [&nreads](system::error_code ec) {
+                if (!ec)
+                    ++nreads;
+            });
+        ios.run();
+        ios.reset();
+        while (socket.read_state() != http::read_state::empty) {
+            socket.async_read_some(request, [](system::error_code) {});
+            ios.run();
+            ios.reset();
+        }
+
+        reply.status_code() = 200;
+        reply.reason_phrase() = "a reason phrase longer than the sso buffer";
+        reply.headers().emplace("content-type", "text/plain");
+        reply.body().assign(request.body().begin(), request.body().end());
+        socket.async_write_response(reply, [&nwrites](system::error_code ec) {
+                if (!ec)
+                    ++nwrites;
+            });
+        ios.run();
+        ios.reset();
+        socket.next_layer().output_buffer.clear();
+    };
+
+    // Warm up the recycled blocks and the reused buffers
+    cycle();
+    cycle();
+
+    const std::size_t before = nallocations;
+    for (std::size_t i = 2 ; i != ncycles ; ++i)
+        cycle();
+    const std::size_t allocations = nallocations - before;
+
+    BOOST_REQUIRE(nreads == ncycles);
+    BOOST_REQUIRE(nwrites == ncycles);
+    BOOST_CHECK(request.target() == "/some/rather/long/path/to/defeat/the/sso");
+    BOOST_CHECK(request.headers().find("user-agent") != request.headers().end());
+    BOOST_CHECK(request.body().size() == 40);
+    BOOST_CHECK(resource.nblocks() == 1);
+    BOOST_CHECK_EQUAL(allocations, 0u);
+
+    // The reply wasn't reset, so its memory isn't handed out again
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.back(),
+                "GET /another/path/long/enough/to/defeat/the/sso HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "\r\n");
+    socket.async_read_request(request, [&nreads](system::error_code ec) {
+            if (!ec)
+                ++nreads;
+        });
+    ios.run();
+    BOOST_REQUIRE(nreads == ncycles + 1);
+    BOOST_CHECK(request.target()
+                == "/another/path/long/enough/to/defeat/the/sso");
+    BOOST_CHECK(reply.reason_phrase()
+                == "a reason phrase longer than the sso buffer");
+    BOOST_CHECK(reply.headers().find("content-type") != reply.headers().end());
+}
@@ -1102,3 +1102,102 @@ TEST_CASE("Parse a single message with no body", "[parser,good]")
     REQUIRE(parser.token_size() == 0);
     REQUIRE(parser.expected_token() == http::token::code::method);
 }
+
+TEST_CASE("Report the declared body length", "[parser,good]")
+{
+    http::reader::request parser;
+
+    REQUIRE(!parser.body_length_known());
+
+    parser.set_buffer(my_buffer("POST /upload HTTP/1.1\r\n"
+                                "Content-length: 4\r\n"
+                                "host:thelastringbearer.org\r\n"
+                                "\r\n"
+                                "ping"
+
+                                "GET / HTTP/1.1\r\n"
+                                "host: aliceinthewonderland.com\r\n"
+                                "\r\n"
+
+                                "POST / HTTP/1.1\r\n"
+                                "Host: playwithme.onion\r\n"
+                                "Transfer-Encoding: chunked\r\n"
+                                "\r\n"
+                                "0\r\n"
+                                "\r\n"));
+
+    while (parser.code() != http::token::code::end_of_headers)
+        parser.next();
+
+    REQUIRE(parser.body_length_known());
+    REQUIRE(parser.body_length() == 4);
+
+    do {
+        parser.next();
+    } while (parser.code() != http::token::code::end_of_headers);
+
+    REQUIRE(parser.body_length_known());
+    REQUIRE(parser.body_length() == 0);
+
+    do {
+        parser.next();
+    } while (parser.code() != http::token::code::end_of_headers);
+
+    REQUIRE(!parser.body_length_known());
+
+    parser.reset();
+    REQUIRE(!parser.body_length_known());
+    REQUIRE(parser.body_length() == 0);
+}
+
+TEST_CASE("Consume body bytes outside the buffer", "[parser,good]")
+{
+    http::reader::request parser;
+
+    parser.set_buffer(my_buffer("POST /upload HTTP/1.1\r\n"
+                                "Content-length: 10\r\n"
+                                "host:thelastringbearer.org\r\n"
+                                "\r\n"
+                                "pi"));
+
+    while (parser.code() != http::token::code::end_of_headers)
+        parser.next();
+
+    REQUIRE(parser.body_remaining() == 10);
+
+    parser.next();
+
+    REQUIRE(parser.code() == http::token::code::body_chunk);
+    REQUIRE(parser.token_size() == 2);
+    REQUIRE(parser.body_remaining() == 8);
+
+    parser.next();
+
+    REQUIRE(parser.code() == http::token::code::error_insufficient_data);
+
+    parser.consume_body(5);
+
+    REQUIRE(parser.body_remaining() == 3);
+    REQUIRE(parser.expected_token() == http::token::code::body_chunk);
+
+    parser.consume_body(3);
+
+    REQUIRE(parser.body_remaining() == 0);
+
+    parser.next();
+
+    REQUIRE(parser.code() == http::token::code::end_of_body);
+
+    parser.next();
+
+    REQUIRE(parser.code() == http::token::code::end_of_message);
+
+    parser.set_buffer(my_buffer("GET / HTTP/1.1\r\n"
+                                "host: aliceinthewonderland.com\r\n"
+                                "\r\n"));
+
+    parser.next();
+
+    REQUIRE(parser.code() == http::token::code::method);
+    REQUIRE(parser.body_remaining() == 0);
+}
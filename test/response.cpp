@@ -870,3 +870,47 @@ TEST_CASE("Test varying body types", "[parser,good]")
 
     REQUIRE(parser.code() == http::token::code::error_use_another_connection);
 }
+
+static void next_end_of_headers(http::reader::response &parser)
+{
+    do {
+        parser.next();
+        if (parser.code() == http::token::code::status_code)
+            parser.set_method("GET");
+    } while (parser.code() != http::token::code::end_of_headers);
+}
+
+TEST_CASE("Report the declared body length", "[parser,good]")
+{
+    http::reader::response parser;
+
+    REQUIRE(!parser.body_length_known());
+
+    parser.set_buffer(my_buffer("HTTP/1.1 200 OK\r\n"
+                                "Content-Length: 4\r\n"
+                                "\r\n"
+                                "ping"
+
+                                "HTTP/1.1 200 OK\r\n"
+                                "Transfer-Encoding: chunked\r\n"
+                                "\r\n"
+                                "0\r\n"
+                                "\r\n"
+
+                                "HTTP/1.1 200 OK\r\n"
+                                "\r\n"));
+
+    next_end_of_headers(parser);
+
+    REQUIRE(parser.body_length_known());
+    REQUIRE(parser.body_length() == 4);
+
+    next_end_of_headers(parser);
+
+    REQUIRE(!parser.body_length_known());
+
+    // Delimited by the end of the connection
+    next_end_of_headers(parser);
+
+    REQUIRE(!parser.body_length_known());
+}
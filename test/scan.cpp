@@ -0,0 +1,74 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include <boost/http/reader/detail/scan.hpp>
+
+namespace detail = boost::http::reader::detail;
+
+template<class CharSet>
+void check_nibbles()
+{
+    const unsigned char *nibbles = CharSet::nibbles();
+    for (unsigned i = 0 ; i != 256 ; ++i) {
+        unsigned char c = static_cast<unsigned char>(i);
+        bool in_table = (c & 0x80)
+            ? CharSet::accept_high()
+            : (nibbles[c & 0x0F] & (1 << (c >> 4))) != 0;
+        INFO("byte " << i);
+        REQUIRE(in_table == CharSet::contains(c));
+    }
+}
+
+/* For every byte value, put it at every position of a buffer otherwise filled
+   with in-set bytes and compare every available tier against the scalar
+   reference. Several buffer sizes exercise whole blocks and tails. */
+template<class CharSet>
+void check_kernels(unsigned char filler)
+{
+    REQUIRE(CharSet::contains(filler));
+
+    const int detected = detail::simd_level();
+    unsigned char buf[80];
+
+    for (int level = detail::SIMD_NONE ; level <= detected ; ++level) {
+        detail::simd_level() = level;
+        for (std::size_t size = 0 ; size <= sizeof(buf) ; size += 7) {
+            for (unsigned c = 0 ; c != 256 ; ++c) {
+                for (std::size_t pos = 0 ; pos < size ; pos += 3) {
+                    for (std::size_t j = 0 ; j != size ; ++j)
+                        buf[j] = filler;
+                    buf[pos] = static_cast<unsigned char>(c);
+
+                    std::size_t expected
+                        = detail::scan_scalar<CharSet>(buf, size);
+                    if (detail::scan<CharSet>(buf, size) != expected) {
+                        INFO("level " << level << ", size " << size
+                             << ", byte " << c << ", pos " << pos);
+                        REQUIRE(detail::scan<CharSet>(buf, size)
+                                == expected);
+                    }
+                }
+            }
+        }
+    }
+
+    detail::simd_level() = detected;
+}
+
+TEST_CASE("Nibble tables agree with the scalar predicates", "[scan]")
+{
+    check_nibbles<detail::tchar_set>();
+    check_nibbles<detail::request_target_set>();
+    check_nibbles<detail::field_value_set>();
+}
+
+TEST_CASE("Vectorized kernels agree with the scalar kernel", "[scan]")
+{
+    check_kernels<detail::tchar_set>('a');
+    check_kernels<detail::request_target_set>('/');
+    check_kernels<detail::field_value_set>(' ');
+    check_kernels<detail::field_value_set>(0xFF);
+}
@@ -0,0 +1,104 @@
+#ifdef NDEBUG
+#undef NDEBUG
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include <limits>
+#include <map>
+#include <string>
+#include <boost/http/detail/serializer.hpp>
+#include <boost/http/status_code.hpp>
+
+namespace http = boost::http;
+namespace detail = boost::http::detail;
+
+TEST_CASE("Status line table agrees with to_string", "[serializer]")
+{
+    for (unsigned code = 0 ; code != 1000 ; ++code) {
+        boost::string_ref line = detail::status_line(code);
+        std::string reason = http::to_string<std::string>
+            (static_cast<http::status_code>(code));
+
+        INFO("status " << code);
+        if (reason.empty()) {
+            REQUIRE(line.empty());
+            continue;
+        }
+
+        REQUIRE(line == std::to_string(code) + ' ' + reason + "\r\n");
+        REQUIRE(detail::status_line_reason(line) == reason);
+    }
+}
+
+TEST_CASE("Decimal rendering", "[serializer]")
+{
+    const std::uint_least64_t values[] = {
+        0, 1, 9, 10, 99, 100, 1024, 4294967296ull,
+        std::numeric_limits<std::uint_least64_t>::max()
+    };
+
+    for (auto value: values) {
+        std::string out = "x";
+        detail::append_decimal(out, value);
+        REQUIRE(out == 'x' + std::to_string(value));
+    }
+}
+
+TEST_CASE("Chunk size rendering", "[serializer]")
+{
+    std::string out;
+    detail::append_hex(out, 0);
+    REQUIRE(out == "0");
+
+    out.clear();
+    detail::append_hex(out, 0xc);
+    REQUIRE(out == "c");
+
+    out.clear();
+    detail::append_hex(out, 0x1000);
+    REQUIRE(out == "1000");
+
+    out.clear();
+    detail::append_hex(out, std::numeric_limits<std::uint_least64_t>::max());
+    REQUIRE(out == "ffffffffffffffff");
+}
+
+TEST_CASE("Status line rendering", "[serializer]")
+{
+    std::string out;
+
+    detail::append_status_line(out, true, 200, std::string("OK"));
+    REQUIRE(out == "HTTP/1.1 200 OK\r\n");
+
+    out.clear();
+    detail::append_status_line(out, false, 404, std::string("Not Found"));
+    REQUIRE(out == "HTTP/1.0 404 Not Found\r\n");
+
+    // Custom reason phrases bypass the table
+    out.clear();
+    detail::append_status_line(out, true, 200, std::string("Fine"));
+    REQUIRE(out == "HTTP/1.1 200 Fine\r\n");
+
+    out.clear();
+    detail::append_status_line(out, true, 299, std::string(""));
+    REQUIRE(out == "HTTP/1.1 299 \r\n");
+}
+
+TEST_CASE("Headers rendering", "[serializer]")
+{
+    std::multimap<std::string, std::string> headers;
+    headers.insert(std::make_pair("a", "1"));
+    headers.insert(std::make_pair("b", ""));
+
+    std::string out;
+    detail::append_request_line(out, std::string("GET"), std::string("/x"));
+    detail::append_headers(out, headers);
+    REQUIRE(out == "GET /x HTTP/1.1\r\na: 1\r\nb: \r\n");
+
+    // The buffer is reused without shrinking
+    const std::size_t capacity = out.capacity();
+    out.clear();
+    detail::append_headers(out, headers);
+    REQUIRE(out.capacity() == capacity);
+}
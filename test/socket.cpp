@@ -2,11 +2,14 @@
 
 #include "unit_test.hpp"
 
+#include <cstdlib>
 #include <iostream>
+#include <new>
 
 #include <boost/asio/spawn.hpp>
 
 #include <boost/http/socket.hpp>
+#include <boost/http/buffered_socket.hpp>
 #include <boost/http/algorithm.hpp>
 #include <boost/http/request.hpp>
 #include <boost/http/response.hpp>
@@ -16,6 +19,22 @@
 using namespace boost;
 using namespace std;
 
+// Heap allocations done by the whole program (see socket_handler_allocations)
+static std::size_t nallocations = 0;
+
+void *operator new(std::size_t size)
+{
+    ++nallocations;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
 template<class F>
 void feed_with_buffer(std::size_t min_buf_size, F &&f)
 {
@@ -1359,3 +1378,1778 @@ BOOST_AUTO_TEST_CASE(socket_upgrade) {
     spawn(ios, work2);
     ios.run();
 }
+
+BOOST_AUTO_TEST_CASE(socket_pipelining) {
+    feed_with_buffer(19, [](asio::mutable_buffer inbuffer) {
+            asio::io_service ios;
+            http::basic_socket<mock_socket> socket(ios, inbuffer);
+            socket.next_layer().input_buffer.emplace_back();
+            fill_vector(socket.next_layer().input_buffer.front(),
+                        "GET /1 HTTP/1.1\r\n"
+                        "Host: example.com\r\n"
+                        "\r\n"
+                        "GET /2 HTTP/1.1\r\n"
+                        "Host: example.com\r\n"
+                        "\r\n"
+                        "GET /3 HTTP/1.1\r\n"
+                        "Host: example.com\r\n"
+                        "Connection: close\r\n"
+                        "\r\n");
+
+            {
+                bool captured = false;
+                try {
+                    socket.set_pipeline_depth(0);
+                } catch(invalid_argument &) {
+                    captured = true;
+                }
+                BOOST_REQUIRE(captured);
+            }
+            socket.set_pipeline_depth(2);
+            BOOST_REQUIRE(socket.pipeline_depth() == 2);
+
+            http::request request1, request2, request3;
+            system::error_code ec;
+            bool read1 = false, read2 = false, read3 = false;
+
+            socket.async_read_request(request1, [&](system::error_code e) {
+                    ec = e;
+                    read1 = true;
+                });
+            ios.run();
+            ios.reset();
+            BOOST_REQUIRE(read1);
+            BOOST_REQUIRE(!ec);
+            BOOST_CHECK(request1.target() == "/1");
+            BOOST_CHECK(socket.last_request_id() == 0);
+            BOOST_CHECK(socket.pending_responses() == 1);
+            BOOST_CHECK(socket.write_state() == http::write_state::empty);
+
+            // Keeps reading while the first response isn't written
+            socket.async_read_request(request2, [&](system::error_code e) {
+                    ec = e;
+                    read2 = true;
+                });
+            ios.run();
+            ios.reset();
+            BOOST_REQUIRE(read2);
+            BOOST_REQUIRE(!ec);
+            BOOST_CHECK(request2.target() == "/2");
+            BOOST_CHECK(socket.last_request_id() == 1);
+            BOOST_CHECK(socket.pending_responses() == 2);
+
+            // The depth limit is reached, so the read is deferred
+            socket.async_read_request(request3, [&](system::error_code e) {
+                    ec = e;
+                    read3 = true;
+                });
+            ios.run();
+            ios.reset();
+            BOOST_CHECK(!read3);
+            BOOST_CHECK(socket.last_request_id() == 1);
+
+            // Responses must outlive their write operations
+            http::response reply1, reply2, reply3;
+            for (auto reply: {&reply1, &reply2, &reply3}) {
+                reply->status_code() = 200;
+                reply->reason_phrase() = "OK";
+            }
+            reply1.body().push_back('1');
+            reply2.body().push_back('2');
+            reply3.body().push_back('3');
+
+            // Out of order responses are held back
+            bool written1 = false, written2 = false, written3 = false;
+            socket.async_write_response(1, reply2, [&](system::error_code e) {
+                    BOOST_CHECK(!e);
+                    written2 = true;
+                });
+            ios.run();
+            ios.reset();
+            BOOST_CHECK(!written2);
+            BOOST_CHECK(socket.next_layer().output_buffer.empty());
+
+            {
+                bool failed = false;
+                socket.async_write_response(1, reply2,
+                                            [&](system::error_code e) {
+                        failed = e == system::error_code{http::http_errc::out_of_order};
+                    });
+                ios.run();
+                ios.reset();
+                BOOST_CHECK(failed);
+            }
+
+            socket.async_write_response(0, reply1, [&](system::error_code e) {
+                    BOOST_CHECK(!e);
+                    BOOST_CHECK(!written2);
+                    written1 = true;
+                });
+            ios.run();
+            ios.reset();
+            BOOST_REQUIRE(written1);
+            BOOST_REQUIRE(written2);
+            BOOST_REQUIRE(read3);
+            BOOST_REQUIRE(!ec);
+            BOOST_CHECK(request3.target() == "/3");
+            BOOST_CHECK(socket.last_request_id() == 2);
+            BOOST_CHECK(socket.pending_responses() == 1);
+            BOOST_CHECK(socket.is_open());
+
+            socket.async_write_response(reply3, [&](system::error_code e) {
+                    BOOST_CHECK(!e);
+                    written3 = true;
+                });
+            ios.run();
+            ios.reset();
+            BOOST_REQUIRE(written3);
+            BOOST_CHECK(socket.pending_responses() == 0);
+            BOOST_CHECK(!socket.is_open());
+            BOOST_CHECK(socket.write_state() == http::write_state::finished);
+
+            {
+                vector<char> v;
+                fill_vector(v,
+                            "HTTP/1.1 200 OK\r\n"
+                            "content-length: 1\r\n"
+                            "\r\n"
+                            "1"
+                            "HTTP/1.1 200 OK\r\n"
+                            "content-length: 1\r\n"
+                            "\r\n"
+                            "2"
+                            "HTTP/1.1 200 OK\r\n"
+                            "connection: close\r\n"
+                            "content-length: 1\r\n"
+                            "\r\n"
+                            "3");
+                BOOST_CHECK(socket.next_layer().output_buffer == v);
+            }
+        });
+}
+
+BOOST_AUTO_TEST_CASE(socket_write_queue) {
+    asio::io_service ios;
+    char buffer[256];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "GET / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "\r\n");
+
+    http::request request;
+    socket.async_read_request(request, [](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(socket.read_state() == http::read_state::empty);
+
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+
+    /* Metadata is held back until the first chunk follows it in the same
+       turn. Writes issued while another one is in progress are merged. */
+    bool metadata_written = false;
+    socket.async_write_response_metadata(reply, [&](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            metadata_written = true;
+        });
+    BOOST_CHECK(socket.next_layer().write_calls == 0);
+
+    http::response chunk1, chunk2, chunk3;
+    chunk1.body().push_back('a');
+    chunk2.body().push_back('b');
+    chunk3.body().assign(4096, 'c'); // not inlined
+
+    int nwritten = 0;
+    for (auto chunk: {&chunk1, &chunk2, &chunk3}) {
+        socket.async_write(*chunk, [&nwritten](system::error_code ec) {
+                BOOST_CHECK(!ec);
+                ++nwritten;
+            });
+    }
+    socket.async_write_end_of_message([&nwritten](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            BOOST_CHECK(nwritten == 3);
+            ++nwritten;
+        });
+    BOOST_CHECK(socket.write_state() == http::write_state::finished);
+    ios.run();
+    ios.reset();
+    BOOST_CHECK(metadata_written);
+    BOOST_CHECK(nwritten == 4);
+    BOOST_CHECK(socket.next_layer().write_calls == 2);
+
+    {
+        vector<char> v;
+        fill_vector(v,
+                    "HTTP/1.1 200 OK\r\n"
+                    "transfer-encoding: chunked\r\n"
+                    "\r\n"
+                    "1\r\n"
+                    "a\r\n"
+                    "1\r\n"
+                    "b\r\n"
+                    "1000\r\n");
+        v.insert(v.end(), chunk3.body().begin(), chunk3.body().end());
+        fill_vector(v,
+                    "\r\n"
+                    "0\r\n"
+                    "\r\n");
+        BOOST_CHECK(socket.next_layer().output_buffer == v);
+    }
+
+    // Flushing with nothing queued completes right away
+    bool flushed = false;
+    socket.async_flush([&flushed](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            flushed = true;
+        });
+    ios.run();
+    BOOST_CHECK(flushed);
+    BOOST_CHECK(socket.next_layer().write_calls == 2);
+}
+
+BOOST_AUTO_TEST_CASE(socket_flush) {
+    asio::io_service ios;
+    char buffer[256];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "GET / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "\r\n");
+
+    http::request request;
+    socket.async_read_request(request, [](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+        });
+    ios.run();
+    ios.reset();
+
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    bool metadata_written = false;
+    socket.async_write_response_metadata(reply, [&](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            metadata_written = true;
+        });
+
+    // Sends the metadata without waiting for the posted uncork
+    bool flushed = false;
+    socket.async_flush([&](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            BOOST_CHECK(metadata_written);
+            flushed = true;
+        });
+    BOOST_CHECK(socket.next_layer().write_calls == 1);
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(flushed);
+    BOOST_CHECK(socket.next_layer().write_calls == 1);
+    {
+        vector<char> v;
+        fill_vector(v,
+                    "HTTP/1.1 200 OK\r\n"
+                    "transfer-encoding: chunked\r\n"
+                    "\r\n");
+        BOOST_CHECK(socket.next_layer().output_buffer == v);
+    }
+
+    /* Metadata nothing follows (e.g. a long poll) isn't held back past the
+       current turn */
+    socket.next_layer().output_buffer.clear();
+    socket.async_write_end_of_message([](system::error_code ec) {
+            BOOST_CHECK(!ec);
+        });
+    ios.run();
+    ios.reset();
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "GET / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "\r\n");
+    socket.async_read_request(request, [](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+        });
+    ios.run();
+    ios.reset();
+    socket.next_layer().output_buffer.clear();
+    const auto write_calls = socket.next_layer().write_calls;
+
+    metadata_written = false;
+    socket.async_write_response_metadata(reply, [&](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            metadata_written = true;
+        });
+    ios.run();
+    BOOST_CHECK(metadata_written);
+    BOOST_CHECK(socket.next_layer().write_calls == write_calls + 1);
+    {
+        vector<char> v;
+        fill_vector(v,
+                    "HTTP/1.1 200 OK\r\n"
+                    "transfer-encoding: chunked\r\n"
+                    "\r\n");
+        BOOST_CHECK(socket.next_layer().output_buffer == v);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(socket_buffer_growth) {
+    asio::io_service ios;
+    http::buffer_pool pool;
+    char buffer[32];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+    socket.set_buffer_pool(pool);
+    BOOST_CHECK(socket.buffer_size() == 32);
+    BOOST_CHECK(socket.max_buffer_size()
+                == BOOST_HTTP_SOCKET_DEFAULT_MAX_BUFFER_SIZE);
+
+    {
+        bool captured = false;
+        try {
+            socket.set_max_buffer_size(16);
+        } catch(invalid_argument &) {
+            captured = true;
+        }
+        BOOST_REQUIRE(captured);
+    }
+
+    const string cookie(500, 'x');
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "GET / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "Cookie: ");
+    socket.next_layer().input_buffer.front().insert(
+        socket.next_layer().input_buffer.front().end(), cookie.begin(),
+        cookie.end());
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "\r\n"
+                "\r\n");
+
+    // Fields larger than the initial buffer are read in a grown buffer
+    http::request request;
+    bool read = false;
+    socket.async_read_request(request, [&read](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            read = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(read);
+    BOOST_CHECK(request.headers().find("cookie")->second == cookie);
+
+    // ...which goes back to the pool once the message is over
+    BOOST_CHECK(socket.buffer_size() == 32);
+    const auto cached_blocks = pool.cached_blocks();
+    BOOST_CHECK(cached_blocks != 0);
+
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    socket.async_write_response(reply, [](system::error_code ec) {
+            BOOST_CHECK(!ec);
+        });
+    ios.run();
+    ios.reset();
+    socket.next_layer().output_buffer.clear();
+
+    // Blocks are reused
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "GET / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "Cookie: ");
+    socket.next_layer().input_buffer.front().insert(
+        socket.next_layer().input_buffer.front().end(), cookie.begin(),
+        cookie.end());
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "\r\n"
+                "\r\n");
+    clear_message(request);
+    read = false;
+    socket.async_read_request(request, [&read](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            read = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(read);
+    BOOST_CHECK(pool.cached_blocks() == cached_blocks);
+    socket.async_write_response(reply, [](system::error_code ec) {
+            BOOST_CHECK(!ec);
+        });
+    ios.run();
+    ios.reset();
+    socket.next_layer().output_buffer.clear();
+
+    // Past the limit, the socket answers based on the token that didn't fit
+    socket.set_max_buffer_size(128);
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.front(), "GET /");
+    socket.next_layer().input_buffer.front().insert(
+        socket.next_layer().input_buffer.front().end(), 200, 'a');
+    read = false;
+    socket.async_read_request(request, [&read](system::error_code ec) {
+            BOOST_CHECK(ec == system::error_code{http::http_errc
+                                                 ::buffer_exhausted});
+            read = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(read);
+    BOOST_CHECK(socket.buffer_size() == 32);
+    {
+        vector<char> v;
+        fill_vector(v,
+                    "HTTP/1.1 414 URI Too Long\r\n"
+                    "Content-Length: 13\r\n"
+                    "Connection: close\r\n"
+                    "\r\n"
+                    "URI too long\n");
+        BOOST_CHECK(socket.next_layer().output_buffer == v);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(socket_header_fields_too_large) {
+    asio::io_service ios;
+    char buffer[32];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+    socket.set_max_buffer_size(32);
+
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "GET / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "Cookie: ");
+    socket.next_layer().input_buffer.front().insert(
+        socket.next_layer().input_buffer.front().end(), 100, 'x');
+
+    http::request request;
+    bool read = false;
+    socket.async_read_request(request, [&read](system::error_code ec) {
+            BOOST_CHECK(ec == system::error_code{http::http_errc
+                                                 ::buffer_exhausted});
+            read = true;
+        });
+    ios.run();
+    BOOST_REQUIRE(read);
+    {
+        vector<char> v;
+        fill_vector(v,
+                    "HTTP/1.1 431 Request Header Fields Too Large\r\n"
+                    "Content-Length: 24\r\n"
+                    "Connection: close\r\n"
+                    "\r\n"
+                    "Header fields too large\n");
+        BOOST_CHECK(socket.next_layer().output_buffer == v);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(socket_pipelined_error_reply) {
+    asio::io_service ios;
+    char buffer[64];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+    socket.set_max_buffer_size(64);
+    socket.set_pipeline_depth(2);
+
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "GET /1 HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "\r\n"
+                "GET /2 HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "Cookie: ");
+    socket.next_layer().input_buffer.front().insert(
+        socket.next_layer().input_buffer.front().end(), 100, 'x');
+
+    http::request request1, request2;
+    bool read1 = false;
+    socket.async_read_request(request1, [&read1](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            read1 = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(read1);
+
+    // The first response is still pending when the second request overflows
+    bool read2 = false;
+    socket.async_read_request(request2, [&read2](system::error_code ec) {
+            BOOST_CHECK(ec == system::error_code{http::http_errc
+                                                 ::buffer_exhausted});
+            read2 = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_CHECK(!read2);
+    BOOST_CHECK(socket.next_layer().output_buffer.empty());
+    BOOST_CHECK(socket.pending_responses() == 2);
+
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    reply.body().push_back('1');
+    bool written = false;
+    socket.async_write_response(0, reply, [&written](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            written = true;
+        });
+    ios.run();
+    BOOST_REQUIRE(written);
+    BOOST_REQUIRE(read2);
+    BOOST_CHECK(socket.pending_responses() == 0);
+    BOOST_CHECK(!socket.is_open());
+    {
+        vector<char> v;
+        fill_vector(v,
+                    "HTTP/1.1 200 OK\r\n"
+                    "content-length: 1\r\n"
+                    "\r\n"
+                    "1"
+                    "HTTP/1.1 431 Request Header Fields Too Large\r\n"
+                    "Content-Length: 24\r\n"
+                    "Connection: close\r\n"
+                    "\r\n"
+                    "Header fields too large\n");
+        BOOST_CHECK(socket.next_layer().output_buffer == v);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(socket_pipelined_continue) {
+    asio::io_service ios;
+    char buffer[256];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+    socket.set_pipeline_depth(2);
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.back(),
+                "GET /1 HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "\r\n"
+                "PUT /2 HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "Expect: 100-continue\r\n"
+                "Content-Length: 4\r\n"
+                "\r\n");
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.back(), "ping");
+
+    http::request request1, request2;
+    for (auto request: {&request1, &request2}) {
+        socket.async_read_request(*request, [](system::error_code ec) {
+                BOOST_CHECK(!ec);
+            });
+        ios.run();
+        ios.reset();
+    }
+    BOOST_REQUIRE(request2.target() == "/2");
+    BOOST_REQUIRE(http::request_continue_required(request2));
+
+    // The interim response waits for the response to the first request...
+    std::vector<int> completed;
+    socket.async_write_response_continue([&](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            completed.push_back(100);
+        });
+    ios.run();
+    ios.reset();
+    BOOST_CHECK(completed.empty());
+    BOOST_CHECK(socket.next_layer().output_buffer.empty());
+
+    // ...and is issued once per request
+    {
+        system::error_code ec;
+        socket.async_write_response_continue([&ec](system::error_code e) {
+                ec = e;
+            });
+        ios.run();
+        ios.reset();
+        BOOST_CHECK(ec == system::error_code{http::http_errc::out_of_order});
+    }
+
+    http::response reply1, reply2;
+    for (auto reply: {&reply1, &reply2}) {
+        reply->status_code() = 200;
+        reply->reason_phrase() = "OK";
+    }
+    reply1.body().push_back('1');
+    reply2.body().push_back('2');
+
+    socket.async_write_response(0, reply1, [&](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            completed.push_back(1);
+        });
+    ios.run();
+    ios.reset();
+    BOOST_CHECK(completed == (std::vector<int>{1, 100}));
+    BOOST_CHECK(socket.write_state() == http::write_state::continue_issued);
+
+    // The body is sent by the client once the interim response is received
+    while (socket.read_state() != http::read_state::empty) {
+        socket.async_read_some(request2, [](system::error_code ec) {
+                BOOST_CHECK(!ec);
+            });
+        ios.run();
+        ios.reset();
+    }
+    BOOST_CHECK(std::string(request2.body().begin(), request2.body().end())
+                == "ping");
+
+    socket.async_write_response(reply2, [&](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            completed.push_back(2);
+        });
+    ios.run();
+    ios.reset();
+    BOOST_CHECK(completed == (std::vector<int>{1, 100, 2}));
+
+    vector<char> v;
+    fill_vector(v,
+                "HTTP/1.1 200 OK\r\n"
+                "content-length: 1\r\n"
+                "\r\n"
+                "1"
+                "HTTP/1.1 100 Continue\r\n"
+                "\r\n"
+                "HTTP/1.1 200 OK\r\n"
+                "content-length: 1\r\n"
+                "\r\n"
+                "2");
+    BOOST_CHECK(socket.next_layer().output_buffer == v);
+}
+
+BOOST_AUTO_TEST_CASE(socket_idle_buffer) {
+    asio::io_service ios;
+    http::buffer_pool pool;
+    http::basic_socket<mock_socket> socket(ios, pool);
+    BOOST_CHECK(socket.buffer_size() == 0);
+
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "GET /1 HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "\r\n"
+                "GET /2 HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "\r\n");
+
+    http::request request;
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+
+    // A buffer is only borrowed once there is something to read...
+    bool read = false;
+    socket.async_read_request(request, [&read](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            read = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(read);
+    BOOST_CHECK(request.target() == "/1");
+    BOOST_CHECK(socket.next_layer().readiness_waits == 1);
+
+    // ...and kept while it holds unparsed bytes
+    BOOST_CHECK(socket.buffer_size() != 0);
+    BOOST_CHECK(pool.cached_blocks() == 0);
+
+    socket.async_write_response(reply, [](system::error_code ec) {
+            BOOST_CHECK(!ec);
+        });
+    ios.run();
+    ios.reset();
+
+    read = false;
+    clear_message(request);
+    socket.async_read_request(request, [&read](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            read = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(read);
+    BOOST_CHECK(request.target() == "/2");
+    BOOST_CHECK(socket.next_layer().readiness_waits == 1);
+
+    // Every byte was consumed, so the buffer went back to the pool
+    BOOST_CHECK(socket.buffer_size() == 0);
+    BOOST_CHECK(pool.cached_blocks() == 1);
+
+    socket.async_write_response(reply, [](system::error_code ec) {
+            BOOST_CHECK(!ec);
+        });
+    ios.run();
+    ios.reset();
+
+    // The connection is idle again
+    system::error_code ec;
+    socket.async_read_request(request, [&ec](system::error_code e) {
+            ec = e;
+        });
+    ios.run();
+    BOOST_CHECK(ec == system::error_code{asio::error::eof});
+    BOOST_CHECK(socket.next_layer().readiness_waits == 2);
+    BOOST_CHECK(socket.buffer_size() == 0);
+}
+
+// Like `asio::ssl::stream`: the lowest layer is another object
+class layered_mock_socket: public mock_socket
+{
+public:
+    struct lowest_layer_type
+    {
+        void close() {}
+    };
+
+    using mock_socket::mock_socket;
+
+    lowest_layer_type &lowest_layer()
+    {
+        return lowest;
+    }
+
+private:
+    lowest_layer_type lowest;
+};
+
+BOOST_AUTO_TEST_CASE(socket_idle_buffer_layered) {
+    asio::io_service ios;
+    http::buffer_pool pool;
+    http::basic_socket<layered_mock_socket> socket(ios, pool);
+    BOOST_CHECK(socket.buffer_size() == 0);
+
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "GET / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "\r\n");
+
+    // The layer may hold bytes the lowest layer doesn't report, so the socket
+    // reads right away instead of waiting for readiness
+    http::request request;
+    bool read = false;
+    socket.async_read_request(request, [&read](system::error_code ec) {
+            BOOST_CHECK(!ec);
+            read = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(read);
+    BOOST_CHECK(request.target() == "/");
+    BOOST_CHECK(socket.next_layer().readiness_waits == 0);
+
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    socket.async_write_response(reply, [](system::error_code ec) {
+            BOOST_CHECK(!ec);
+        });
+    ios.run();
+    ios.reset();
+
+    // The buffer still goes back to the pool between messages
+    BOOST_CHECK(socket.buffer_size() == 0);
+    BOOST_CHECK(pool.cached_blocks() == 1);
+}
+
+// The members of `basic_socket` are reachable through `basic_buffered_socket`
+BOOST_AUTO_TEST_CASE(socket_buffered_interface) {
+    asio::io_service ios;
+    http::basic_buffered_socket<mock_socket> socket(ios);
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.back(),
+                "PUT / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "Content-Length: 4\r\n"
+                "\r\n");
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.back(), "ping");
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.back(),
+                "GET / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "\r\n");
+
+    socket.set_pipeline_depth(2);
+    BOOST_CHECK(socket.pipeline_depth() == 2);
+    BOOST_CHECK(socket.pending_responses() == 0);
+
+    socket.set_body_reserve_limit(2);
+    BOOST_CHECK(socket.body_reserve_limit() == 2);
+
+    // Only the always accepted fields
+    http::header_filter filter;
+    socket.set_header_filter(&filter);
+
+    http::request request;
+    socket.async_read_request(request, [](system::error_code ec) {
+            BOOST_CHECK(!ec);
+        });
+    ios.run();
+    ios.reset();
+    BOOST_CHECK(socket.pending_responses() == 1);
+    BOOST_CHECK(request.headers().count("host") == 0);
+    BOOST_CHECK(socket.body_length_known());
+    BOOST_CHECK(socket.body_length() == 4);
+
+    char body[8];
+    std::size_t nread = 0;
+    socket.async_read_body_into(asio::buffer(body),
+                                [&nread](system::error_code ec,
+                                         std::size_t n) {
+                                    BOOST_CHECK(!ec);
+                                    nread = n;
+                                });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(nread == 4);
+    BOOST_CHECK(std::string(body, nread) == "ping");
+
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    bool written = false;
+    socket.async_write_response(socket.last_request_id(), reply,
+                                [&written](system::error_code ec) {
+                                    BOOST_CHECK(!ec);
+                                    written = true;
+                                });
+    ios.run();
+    ios.reset();
+    BOOST_CHECK(written);
+    BOOST_CHECK(socket.pending_responses() == 0);
+
+    socket.set_pipeline_depth(1);
+    clear_message(request);
+    socket.async_read_request(request, [](system::error_code ec) {
+            BOOST_CHECK(!ec);
+        });
+    ios.run();
+    ios.reset();
+
+    written = false;
+    socket.next_layer().output_buffer.clear();
+    socket.async_write_response_buffers(reply, asio::buffer("pong", 4),
+                                        [&written](system::error_code ec) {
+                                            BOOST_CHECK(!ec);
+                                            written = true;
+                                        });
+    ios.run();
+    ios.reset();
+    BOOST_CHECK(written);
+    {
+        vector<char> v;
+        fill_vector(v,
+                    "HTTP/1.1 200 OK\r\n"
+                    "content-length: 4\r\n"
+                    "\r\n"
+                    "pong");
+        BOOST_CHECK(socket.next_layer().output_buffer == v);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(socket_handler_allocations) {
+    asio::io_service ios;
+    char buffer[256];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+
+    const std::size_t ncycles = 8;
+    for (std::size_t i = 0 ; i != ncycles ; ++i) {
+        socket.next_layer().input_buffer.emplace_back();
+        fill_vector(socket.next_layer().input_buffer.back(),
+                    "GET / HTTP/1.1\r\n"
+                    "Host: example.com\r\n"
+                    "\r\n");
+    }
+
+    http::request request;
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    reply.body().push_back('a');
+
+    std::size_t nreads = 0;
+    std::size_t nwrites = 0;
+    auto cycle = [&]() {
+        clear_message(request);
+        socket.async_read_request(request, [&nreads](system::error_code ec) {
+                if (!ec)
+                    ++nreads;
+            });
+        ios.run();
+        ios.reset();
+
+        socket.async_write_response(reply, [&nwrites](system::error_code ec) {
+                if (!ec)
+                    ++nwrites;
+            });
+        ios.run();
+        ios.reset();
+        socket.next_layer().output_buffer.clear();
+    };
+
+    // Warm up the recycled blocks and the reused buffers
+    cycle();
+    cycle();
+
+    const std::size_t before = nallocations;
+    for (std::size_t i = 2 ; i != ncycles ; ++i)
+        cycle();
+    const std::size_t allocations = nallocations - before;
+
+    BOOST_REQUIRE(nreads == ncycles);
+    BOOST_REQUIRE(nwrites == ncycles);
+    BOOST_CHECK(request.target() == "/");
+
+    // Not even the message (`http::headers` keeps its capacity when cleared)
+    BOOST_CHECK_EQUAL(allocations, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(socket_pipelined_allocations) {
+    asio::io_service ios;
+    char buffer[256];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+    socket.set_pipeline_depth(3);
+
+    const std::size_t ncycles = 8;
+    for (std::size_t i = 0 ; i != ncycles * 2 ; ++i) {
+        socket.next_layer().input_buffer.emplace_back();
+        fill_vector(socket.next_layer().input_buffer.back(),
+                    "GET / HTTP/1.1\r\n"
+                    "Host: example.com\r\n"
+                    "\r\n");
+    }
+
+    http::request request1, request2;
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    reply.body().push_back('a');
+
+    std::size_t nreads = 0;
+    std::size_t nwrites = 0;
+    auto on_read = [&nreads](system::error_code ec) {
+        if (!ec)
+            ++nreads;
+    };
+    auto on_write = [&nwrites](system::error_code ec) {
+        if (!ec)
+            ++nwrites;
+    };
+
+    // Two requests in flight, answered newest first
+    auto cycle = [&]() {
+        clear_message(request1);
+        clear_message(request2);
+        socket.async_read_request(request1, on_read);
+        ios.run();
+        ios.reset();
+        const std::size_t id = socket.last_request_id();
+        socket.async_read_request(request2, on_read);
+        ios.run();
+        ios.reset();
+
+        socket.async_write_response(id + 1, reply, on_write);
+        socket.async_write_response(id, reply, on_write);
+        ios.run();
+        ios.reset();
+        socket.next_layer().output_buffer.clear();
+    };
+
+    // Warm up the recycled blocks, the pipeline slots and the reused buffers
+    cycle();
+    cycle();
+
+    const std::size_t before = nallocations;
+    for (std::size_t i = 2 ; i != ncycles ; ++i)
+        cycle();
+    const std::size_t allocations = nallocations - before;
+
+    BOOST_REQUIRE(nreads == ncycles * 2);
+    BOOST_REQUIRE(nwrites == ncycles * 2);
+    BOOST_CHECK(socket.pending_responses() == 0);
+    BOOST_CHECK_EQUAL(allocations, 0u);
+}
+
+/* A pending completion whose handler owns the socket releases its node before
+   the handler (and so the socket's recycled memory) dies. Best checked under
+   AddressSanitizer or valgrind. */
+BOOST_AUTO_TEST_CASE(socket_pending_completion_owns_socket) {
+    std::unique_ptr<asio::io_service> ios(new asio::io_service);
+    char buffer[64];
+    auto socket = std::make_shared<http::basic_socket<mock_socket>>
+        (*ios, asio::buffer(buffer));
+    std::weak_ptr<http::basic_socket<mock_socket>> observer = socket;
+
+    // No metadata was written, so the failure is posted
+    http::response chunk;
+    bool called = false;
+    socket->async_write(chunk, [socket,&called](system::error_code) {
+            called = true;
+        });
+    socket.reset();
+    BOOST_REQUIRE(!observer.expired());
+
+    // Destroys the pending completion (and the socket with it)
+    ios.reset();
+    BOOST_CHECK(observer.expired());
+    BOOST_CHECK(!called);
+}
+
+// Completion handler that can only be moved
+struct move_only_handler
+{
+    explicit move_only_handler(std::vector<system::error_code> &results)
+        : results(&results)
+    {}
+
+    move_only_handler(move_only_handler&&) = default;
+    move_only_handler(const move_only_handler&) = delete;
+
+    void operator()(system::error_code ec)
+    {
+        results->push_back(ec);
+    }
+
+    std::vector<system::error_code> *results;
+};
+
+BOOST_AUTO_TEST_CASE(socket_move_only_handlers) {
+    asio::io_service ios;
+    char buffer[256];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.front(),
+                "POST / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "3\r\nabc\r\n"
+                "0\r\n"
+                "\r\n");
+
+    std::vector<system::error_code> results;
+    http::request request;
+
+    socket.async_read_request(request, move_only_handler(results));
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(results.size() == 1);
+    BOOST_CHECK(!results.back());
+
+    // Completed through a posted handler
+    socket.async_read_trailers(request, move_only_handler(results));
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(results.size() == 2);
+    BOOST_CHECK(results.back()
+                == system::error_code{http::http_errc::out_of_order});
+
+    while (socket.read_state() != http::read_state::empty) {
+        if (socket.read_state() == http::read_state::body_ready)
+            socket.async_read_trailers(request, move_only_handler(results));
+        else
+            socket.async_read_some(request, move_only_handler(results));
+        ios.run();
+        ios.reset();
+        BOOST_REQUIRE(!results.back());
+    }
+    BOOST_CHECK(request.body().size() == 3);
+
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    http::response chunk;
+    chunk.body().push_back('a');
+
+    const std::size_t nresults = results.size();
+    socket.async_write_response_metadata(reply, move_only_handler(results));
+    socket.async_write(chunk, move_only_handler(results));
+    socket.async_write_end_of_message(move_only_handler(results));
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(results.size() == nresults + 3);
+    for (std::size_t i = nresults ; i != results.size() ; ++i)
+        BOOST_CHECK(!results[i]);
+
+    std::string expected = "HTTP/1.1 200 OK\r\n"
+        "transfer-encoding: chunked\r\n"
+        "\r\n"
+        "1\r\na\r\n"
+        "0\r\n\r\n";
+    BOOST_CHECK(std::string(socket.next_layer().output_buffer.begin(),
+                            socket.next_layer().output_buffer.end())
+                == expected);
+}
+
+BOOST_AUTO_TEST_CASE(socket_header_filter) {
+    asio::io_service ios;
+    char buffer[512];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.back(),
+                "POST / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "Cookie: tracking=1\r\n"
+                "X-Request-Id: 42\r\n"
+                "X-Ignored: yes\r\n"
+                "Expect: 100-continue\r\n"
+                "Connection: keep-alive\r\n"
+                "Upgrade: websocket\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n"
+                "0\r\n"
+                "X-Checksum: 0\r\n"
+                "X-Request-Id: 43\r\n"
+                "\r\n"
+                // second
+                "GET / HTTP/1.1\r\n"
+                "Host: example.org\r\n"
+                "X-Ignored: yes\r\n"
+                "\r\n");
+
+    http::header_filter filter{{http::header_id::host}, {"x-request-id"}};
+    BOOST_CHECK(filter.accepts("host"));
+    BOOST_CHECK(filter.accepts("x-request-id"));
+    BOOST_CHECK(filter.accepts("connection"));
+    BOOST_CHECK(!filter.accepts("cookie"));
+    BOOST_CHECK(!filter.accepts("x-ignored"));
+    socket.set_header_filter(&filter);
+
+    http::request request;
+    bool read = false;
+    socket.async_read_request(request, [&read](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            read = true;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(read);
+    {
+        http::headers expected_headers{
+            {"host", "example.com"},
+            {"x-request-id", "42"},
+            {"expect", "100-continue"},
+            {"connection", "keep-alive"},
+            {"upgrade", "websocket"}
+        };
+        BOOST_CHECK(request.headers() == expected_headers);
+    }
+    BOOST_CHECK(http::request_continue_required(request));
+
+    while (socket.read_state() != http::read_state::empty) {
+        read = false;
+        socket.async_read_some(request, [&read](system::error_code ec) {
+                BOOST_REQUIRE(!ec);
+                read = true;
+            });
+        ios.run();
+        ios.reset();
+        BOOST_REQUIRE(read);
+    }
+    BOOST_CHECK(request.trailers()
+                == (http::headers{{"x-request-id", "43"}}));
+
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    socket.async_write_response(reply, [](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+        });
+    ios.run();
+    ios.reset();
+
+    // Every field is stored once the filter is gone
+    socket.set_header_filter(nullptr);
+    read = false;
+    socket.async_read_request(request, [&read](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            read = true;
+        });
+    ios.run();
+    BOOST_REQUIRE(read);
+    BOOST_CHECK(request.headers() == (http::headers{{"host", "example.org"},
+                                                    {"x-ignored", "yes"}}));
+}
+
+BOOST_AUTO_TEST_CASE(socket_body_sinks) {
+    typedef http::basic_request<std::string, http::headers,
+                                http::ring_body_sink> ring_request;
+    typedef http::basic_request<std::string, http::headers,
+                                http::callback_body_sink> callback_request;
+    typedef http::basic_request<std::string, http::headers,
+                                http::file_body_sink> file_request;
+
+    static_assert(http::is_body_sink<http::ring_body_sink>::value, "");
+    static_assert(!http::is_body_sink<std::vector<std::uint8_t>>::value, "");
+
+    const std::size_t body_size = 64 * 1024;
+    std::string body;
+    for (std::size_t i = 0 ; i != body_size ; ++i)
+        body.push_back(char('a' + i % 26));
+
+    auto feed = [&](http::basic_socket<mock_socket> &socket) {
+        socket.next_layer().input_buffer.emplace_back();
+        fill_vector(socket.next_layer().input_buffer.back(),
+                    "PUT /upload HTTP/1.1\r\n"
+                    "Host: example.com\r\n"
+                    "Content-Length: 65536\r\n"
+                    "\r\n");
+        for (std::size_t i = 0 ; i < body_size ; i += 1000) {
+            auto &chunk = socket.next_layer().input_buffer.back();
+            chunk.insert(chunk.end(), body.begin() + i,
+                         body.begin() + std::min(i + 1000, body_size));
+            socket.next_layer().input_buffer.emplace_back();
+        }
+        socket.next_layer().input_buffer.pop_back();
+    };
+
+    // The ring is drained after every read, so it never grows
+    {
+        asio::io_service ios;
+        char buffer[512];
+        http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+        feed(socket);
+
+        ring_request request;
+        request.body() = http::ring_body_sink(sizeof(buffer));
+        std::string received;
+        system::error_code result;
+        auto drain = [&]() {
+            char out[100];
+            while (!request.body().empty()) {
+                auto n = request.body().read(asio::buffer(out));
+                received.append(out, n);
+            }
+        };
+
+        socket.async_read_request(request, [&result](system::error_code ec) {
+                result = ec;
+            });
+        ios.run();
+        ios.reset();
+        BOOST_REQUIRE(!result);
+        drain();
+        while (socket.read_state() != http::read_state::empty) {
+            socket.async_read_some(request,
+                                   [&result](system::error_code ec) {
+                                       result = ec;
+                                   });
+            ios.run();
+            ios.reset();
+            BOOST_REQUIRE(!result);
+            BOOST_REQUIRE(request.body().size() <= sizeof(buffer));
+            drain();
+        }
+        BOOST_CHECK(received == body);
+    }
+
+    // A full ring fails the read
+    {
+        asio::io_service ios;
+        char buffer[512];
+        http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+        feed(socket);
+
+        ring_request request;
+        request.body() = http::ring_body_sink(256);
+        system::error_code result;
+        auto on_read = [&result](system::error_code ec) { result = ec; };
+        socket.async_read_request(request, on_read);
+        ios.run();
+        ios.reset();
+        while (!result && socket.read_state() != http::read_state::empty) {
+            socket.async_read_some(request, on_read);
+            ios.run();
+            ios.reset();
+        }
+        BOOST_CHECK(result == asio::error::no_buffer_space);
+
+        // The rest of the body must never be parsed as a new request
+        BOOST_CHECK(socket.read_state() == http::read_state::finished);
+        socket.next_layer().input_buffer.emplace_back();
+        fill_vector(socket.next_layer().input_buffer.back(),
+                    "GET /smuggled HTTP/1.1\r\n"
+                    "Host: example.com\r\n"
+                    "\r\n");
+        http::request next;
+        bool read = false;
+        socket.async_read_request(next, [&read](system::error_code ec) {
+                BOOST_CHECK(ec == system::error_code{http::http_errc
+                                                     ::out_of_order});
+                read = true;
+            });
+        ios.run();
+        ios.reset();
+        BOOST_REQUIRE(read);
+        BOOST_CHECK(next.target().empty());
+
+        http::response reply;
+        reply.status_code() = 413;
+        reply.reason_phrase() = "Payload Too Large";
+        bool written = false;
+        socket.async_write_response(reply, [&written](system::error_code ec) {
+                BOOST_CHECK(!ec);
+                written = true;
+            });
+        ios.run();
+        BOOST_REQUIRE(written);
+        BOOST_CHECK(!socket.is_open());
+        {
+            vector<char> v;
+            fill_vector(v,
+                        "HTTP/1.1 413 Payload Too Large\r\n"
+                        "connection: close\r\n"
+                        "content-length: 0\r\n"
+                        "\r\n");
+            BOOST_CHECK(socket.next_layer().output_buffer == v);
+        }
+    }
+
+    // Callbacks see every chunk in order
+    {
+        asio::io_service ios;
+        char buffer[512];
+        http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+        feed(socket);
+
+        std::string received;
+        callback_request request;
+        request.body() = http::callback_body_sink(
+            [&received](asio::const_buffer chunk, system::error_code&) {
+                received.append(asio::buffer_cast<const char*>(chunk),
+                                asio::buffer_size(chunk));
+            });
+        system::error_code result;
+        auto on_read = [&result](system::error_code ec) { result = ec; };
+        socket.async_read_request(request, on_read);
+        ios.run();
+        ios.reset();
+        while (!result && socket.read_state() != http::read_state::empty) {
+            socket.async_read_some(request, on_read);
+            ios.run();
+            ios.reset();
+        }
+        BOOST_REQUIRE(!result);
+        BOOST_CHECK(received == body);
+    }
+
+    // Files
+    {
+        asio::io_service ios;
+        char buffer[512];
+        http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+        feed(socket);
+
+        std::FILE *file = std::tmpfile();
+        BOOST_REQUIRE(file);
+        file_request request;
+        request.body() = http::file_body_sink(file);
+        system::error_code result;
+        auto on_read = [&result](system::error_code ec) { result = ec; };
+        socket.async_read_request(request, on_read);
+        ios.run();
+        ios.reset();
+        while (!result && socket.read_state() != http::read_state::empty) {
+            socket.async_read_some(request, on_read);
+            ios.run();
+            ios.reset();
+        }
+        BOOST_REQUIRE(!result);
+        BOOST_CHECK(request.body().size() == body_size);
+
+        std::string received(body_size, '\0');
+        std::rewind(file);
+        BOOST_CHECK(std::fread(&received[0], 1, body_size, file) == body_size);
+        BOOST_CHECK(received == body);
+        std::fclose(file);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(socket_body_reserve) {
+    asio::io_service ios;
+    char buffer[512];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+    BOOST_CHECK(socket.body_reserve_limit()
+                == BOOST_HTTP_SOCKET_DEFAULT_BODY_RESERVE_LIMIT);
+
+    auto feed = [&socket](const std::string &head, std::size_t body_size) {
+        socket.next_layer().input_buffer.emplace_back(head.begin(),
+                                                       head.end());
+        socket.next_layer().input_buffer.back().resize(head.size() + body_size,
+                                                       'x');
+    };
+    auto read_head = [&](http::request &request) {
+        bool ok = false;
+        socket.async_read_request(request, [&ok](system::error_code ec) {
+                BOOST_REQUIRE(!ec);
+                ok = true;
+            });
+        ios.run();
+        ios.reset();
+        BOOST_REQUIRE(ok);
+    };
+    auto read_body = [&](http::request &request) {
+        while (socket.read_state() != http::read_state::empty) {
+            bool ok = false;
+            socket.async_read_some(request, [&ok](system::error_code ec) {
+                    BOOST_REQUIRE(!ec);
+                    ok = true;
+                });
+            ios.run();
+            ios.reset();
+            BOOST_REQUIRE(ok);
+        }
+    };
+    auto reply = [&]() {
+        http::response reply;
+        reply.status_code() = 200;
+        reply.reason_phrase() = "OK";
+        socket.async_write_response(reply, [](system::error_code ec) {
+                BOOST_REQUIRE(!ec);
+            });
+        ios.run();
+        ios.reset();
+    };
+
+    // Storage is reserved once, before the first chunk arrives
+    feed("PUT / HTTP/1.1\r\n"
+         "Host: example.com\r\n"
+         "Content-Length: 4000\r\n"
+         "\r\n", 4000);
+    {
+        http::request request;
+        read_head(request);
+        BOOST_CHECK(socket.body_length_known());
+        BOOST_CHECK(socket.body_length() == 4000);
+        BOOST_CHECK(request.body().capacity() >= 4000);
+        auto data = request.body().data();
+        read_body(request);
+        BOOST_CHECK(request.body().size() == 4000);
+        BOOST_CHECK(request.body().data() == data);
+        reply();
+    }
+
+    // The reservation is capped
+    socket.set_body_reserve_limit(1000);
+    feed("PUT / HTTP/1.1\r\n"
+         "Host: example.com\r\n"
+         "Content-Length: 4000\r\n"
+         "\r\n", 4000);
+    {
+        http::request request;
+        read_head(request);
+        BOOST_CHECK(socket.body_length() == 4000);
+        BOOST_CHECK(request.body().capacity() >= 1000);
+        BOOST_CHECK(request.body().capacity() < 4000);
+        read_body(request);
+        BOOST_CHECK(request.body().size() == 4000);
+        reply();
+    }
+
+    // Chunked bodies have no declared length
+    feed("PUT / HTTP/1.1\r\n"
+         "Host: example.com\r\n"
+         "Transfer-Encoding: chunked\r\n"
+         "\r\n"
+         "4\r\n"
+         "ping\r\n"
+         "0\r\n"
+         "\r\n", 0);
+    {
+        http::request request;
+        read_head(request);
+        read_body(request);
+        BOOST_CHECK(!socket.body_length_known());
+        BOOST_CHECK(request.body().size() == 4);
+        reply();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(socket_read_body_into) {
+    asio::io_service ios;
+    char buffer[512];
+    http::basic_socket<mock_socket> socket(ios, asio::buffer(buffer));
+
+    const std::size_t body_size = 3000;
+    std::string body;
+    for (std::size_t i = 0 ; i != body_size ; ++i)
+        body.push_back(char('a' + i % 26));
+
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.back(),
+                "PUT /upload HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "Content-Length: 3000\r\n"
+                "\r\n");
+    // Some body bytes arrive along with the metadata
+    socket.next_layer().input_buffer.back().insert(socket.next_layer()
+                                                   .input_buffer.back().end(),
+                                                   body.begin(),
+                                                   body.begin() + 100);
+    for (std::size_t i = 100 ; i < body_size ; i += 1000) {
+        socket.next_layer().input_buffer.emplace_back(
+            body.begin() + i, body.begin() + std::min(i + 1000, body_size));
+    }
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.back(),
+                "PUT / HTTP/1.1\r\n"
+                "Host: example.com\r\n"
+                "Transfer-Encoding: chunked\r\n"
+                "\r\n");
+    socket.next_layer().input_buffer.emplace_back();
+    fill_vector(socket.next_layer().input_buffer.back(),
+                "4\r\n"
+                "ping\r\n"
+                "0\r\n"
+                "\r\n");
+
+    std::vector<char> out(body_size);
+    system::error_code result;
+    std::size_t nread = 0;
+    auto on_read = [&](system::error_code ec, std::size_t n) {
+        result = ec;
+        nread = n;
+    };
+
+    // Nothing to read yet
+    socket.async_read_body_into(asio::buffer(out), on_read);
+    ios.run();
+    ios.reset();
+    BOOST_CHECK(result == system::error_code{http::http_errc::out_of_order});
+
+    http::request request;
+    socket.async_read_request(request, [&result](system::error_code ec) {
+            result = ec;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(!result);
+    BOOST_REQUIRE(socket.read_state() == http::read_state::message_ready);
+    BOOST_REQUIRE(request.body().size() == 100);
+
+    std::size_t received = 0;
+    while (socket.read_state() != http::read_state::empty) {
+        socket.async_read_body_into(asio::buffer(out) + received, on_read);
+        ios.run();
+        ios.reset();
+        BOOST_REQUIRE(!result);
+        BOOST_REQUIRE(nread != 0);
+        received += nread;
+    }
+    BOOST_CHECK(received == body_size - 100);
+    BOOST_CHECK(request.body().size() == 100);
+    BOOST_CHECK(std::equal(out.begin(), out.begin() + received,
+                           body.begin() + 100));
+
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    socket.async_write_response(reply, [](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+        });
+    ios.run();
+    ios.reset();
+
+    // The connection carries on, but chunked bodies aren't supported
+    socket.async_read_request(request, [&result](system::error_code ec) {
+            result = ec;
+        });
+    ios.run();
+    ios.reset();
+    BOOST_REQUIRE(!result);
+    BOOST_REQUIRE(socket.read_state() == http::read_state::message_ready);
+    socket.async_read_body_into(asio::buffer(out), on_read);
+    ios.run();
+    ios.reset();
+    BOOST_CHECK(result == system::error_code{http::http_errc::out_of_order});
+    BOOST_CHECK(nread == 0);
+}
+
+#ifdef BOOST_HTTP_DETAIL_HAS_SPLICE
+BOOST_AUTO_TEST_CASE(socket_splice_body) {
+    using asio::ip::tcp;
+
+    asio::io_service ios;
+    tcp::acceptor acceptor(ios, tcp::endpoint(asio::ip::address_v4
+                                              ::loopback(), 0));
+    tcp::socket client(ios);
+    client.connect(acceptor.local_endpoint());
+
+    http::basic_buffered_socket<tcp::socket, 512> socket(ios);
+    acceptor.accept(socket.next_layer());
+
+    const std::size_t body_size = 1024 * 1024;
+    std::string body;
+    for (std::size_t i = 0 ; i != body_size ; ++i)
+        body.push_back(char('a' + i % 26));
+    std::string input = "PUT /upload HTTP/1.1\r\n"
+                        "Host: example.com\r\n"
+                        "Content-Length: 1048576\r\n"
+                        "\r\n" + body
+                        // Pipelined, so the splice must stop at the body end
+                        + "GET /next HTTP/1.1\r\n"
+                        "Host: example.com\r\n"
+                        "X-Next: yes\r\n"
+                        "\r\n";
+
+    bool written = false;
+    asio::async_write(client, asio::buffer(input),
+                      [&written](system::error_code ec, std::size_t) {
+                          BOOST_REQUIRE(!ec);
+                          written = true;
+                      });
+
+    http::request request;
+    bool read = false;
+    socket.async_read_request(request, [&read](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            read = true;
+        });
+    while (!read)
+        ios.run_one();
+    BOOST_REQUIRE(socket.read_state() == http::read_state::message_ready);
+
+    std::FILE *file = std::tmpfile();
+    BOOST_REQUIRE(file);
+
+    bool spliced = false;
+    socket.async_splice_body(fileno(file),
+                             [&](system::error_code ec,
+                                 std::uint_least64_t n) {
+                                 BOOST_REQUIRE(!ec);
+                                 BOOST_CHECK(n == body_size
+                                             - request.body().size());
+                                 spliced = true;
+                             });
+    while (!spliced || !written)
+        ios.run_one();
+    BOOST_CHECK(socket.read_state() == http::read_state::empty);
+
+    std::string received(request.body().begin(), request.body().end());
+    std::rewind(file);
+    char chunk[4096];
+    while (std::size_t n = std::fread(chunk, 1, sizeof(chunk), file))
+        received.append(chunk, n);
+    std::fclose(file);
+    BOOST_CHECK(received == body);
+
+    // Nothing left to splice
+    ios.reset();
+    system::error_code result;
+    socket.async_splice_body(0, [&result](system::error_code ec,
+                                          std::uint_least64_t) {
+            result = ec;
+        });
+    ios.run();
+    BOOST_CHECK(result == system::error_code{http::http_errc::out_of_order});
+
+    // The connection is kept alive and the next request is parsed as usual
+    ios.reset();
+    http::request next;
+    read = false;
+    socket.async_read_request(next, [&read](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            read = true;
+        });
+    ios.run();
+    BOOST_REQUIRE(read);
+    BOOST_CHECK(socket.read_state() == http::read_state::empty);
+    BOOST_CHECK(next.method() == "GET");
+    BOOST_CHECK(next.target() == "/next");
+    BOOST_CHECK(next.headers().size() == 2);
+    BOOST_CHECK(next.headers().find("host")->second == "example.com");
+    BOOST_CHECK(next.headers().find("x-next")->second == "yes");
+    BOOST_CHECK(next.body().empty());
+}
+#endif // BOOST_HTTP_DETAIL_HAS_SPLICE
+
+#ifdef BOOST_HTTP_DETAIL_HAS_SENDFILE
+BOOST_AUTO_TEST_CASE(socket_write_response_file) {
+    using asio::ip::tcp;
+
+    asio::io_service ios;
+    tcp::acceptor acceptor(ios, tcp::endpoint(asio::ip::address_v4
+                                              ::loopback(), 0));
+    tcp::socket client(ios);
+    client.connect(acceptor.local_endpoint());
+
+    char buffer[512];
+    http::basic_socket<tcp::socket> socket(ios, asio::buffer(buffer));
+    acceptor.accept(socket.next_layer());
+
+    const std::size_t body_size = 1024 * 1024;
+    std::string body;
+    for (std::size_t i = 0 ; i != body_size ; ++i)
+        body.push_back(char('a' + i % 26));
+    std::FILE *file = std::tmpfile();
+    BOOST_REQUIRE(file);
+    BOOST_REQUIRE(std::fwrite(body.data(), 1, body.size(), file)
+                  == body.size());
+    std::fflush(file);
+
+    // The second request is invalid, so reading it issues an error reply
+    asio::write(client, asio::buffer(std::string("GET / HTTP/1.1\r\n"
+                                                 "Host: example.com\r\n"
+                                                 "\r\n"
+                                                 "( / HTTP/1.1\r\n"
+                                                 "\r\n")));
+
+    http::request request;
+    bool read = false;
+    socket.async_read_request(request, [&read](system::error_code ec) {
+            BOOST_REQUIRE(!ec);
+            read = true;
+        });
+    while (!read)
+        ios.run_one();
+    ios.reset();
+
+    http::response reply;
+    reply.status_code() = 200;
+    reply.reason_phrase() = "OK";
+    bool written = false;
+    socket.async_write_response_file(reply, fileno(file), 0, body_size,
+                                     [&written](system::error_code ec) {
+                                         BOOST_REQUIRE(!ec);
+                                         written = true;
+                                     });
+
+    // Its reply MUST NOT end up between the metadata and the body
+    bool failed = false;
+    socket.async_read_request(request, [&failed](system::error_code ec) {
+            BOOST_CHECK(ec == system::error_code{http::http_errc
+                                                 ::parsing_error});
+            failed = true;
+        });
+
+    asio::streambuf input;
+    bool received = false;
+    asio::async_read_until(client, input, "Invalid data\n",
+                           [&received](system::error_code ec, std::size_t) {
+                               BOOST_REQUIRE(!ec);
+                               received = true;
+                           });
+    while (!received || !written || !failed)
+        ios.run_one();
+    std::fclose(file);
+
+    std::string output(asio::buffer_cast<const char*>(input.data()),
+                       input.size());
+    BOOST_CHECK(output == "HTTP/1.1 200 OK\r\n"
+                          "content-length: 1048576\r\n"
+                          "\r\n" + body
+                + "HTTP/1.1 400 Bad Request\r\n"
+                  "Content-Length: 13\r\n"
+                  "Connection: close\r\n"
+                  "\r\n"
+                  "Invalid data\n");
+}
+#endif // BOOST_HTTP_DETAIL_HAS_SENDFILE